@@ -1,52 +1,40 @@
 print("Yarr! Welcome to the land of lua on android!")
 
-local spickle
+-- Engine hooks (optional). on_tick runs once per fixed simulation step,
+-- on_event once per platform -> engine message (type, a, b, c, d).
+local sim_time = 0
 
-spickle = function(intable, hide_non_text, depth, visited, output_func)
-    depth = depth or 0
-    visited = visited or {}
-    output_func = output_func or print
-
-    if visited[intable] then
-        output_func(string.rep("\t", depth) .. "<circular reference>")
-        return
-    end
-    visited[intable] = true
+function on_tick(dt)
+    sim_time = sim_time + dt
+end
 
-    output_func(string.rep("\t", depth) .. "{")
+local G = rce.gestures
+local P = rce.pointers
 
-    local indent = string.rep("\t", depth + 1)
-    local sortedKeys = {}
-    for k, _ in pairs(intable) do
-        table.insert(sortedKeys, k)
+function on_event(type, a, b, c, d, ...)
+    if type == rce.events.Pointer then
+        -- a = kind, b/c = x/y, d = pointer id, then pressure; moves are
+        -- coalesced to at most one per pointer per frame
+        if a ~= P.Move then console_print("pointer", a, b, c, d) end
+        return
     end
-    table.sort(sortedKeys, function(a, b) return tostring(a) < tostring(b) end)
-
-    for _, k in ipairs(sortedKeys) do
-        local v = intable[k]
-        local keyStr = (type(k) == "string" and k:match("^%a[%w_]*$")) and k or ("[" .. tostring(k) .. "]")
-        local line
-
-        if type(v) == "table" then
-            output_func(indent .. keyStr .. " = ")
-            spickle(v, hide_non_text, depth + 1, visited, output_func)
-            output_func(indent .. ",")
-        elseif type(v) == "string" then
-            line = indent .. keyStr .. " = \"" .. v .. "\","
-        elseif type(v) == "number" or type(v) == "boolean" or type(v) == "nil" then
-            line = indent .. keyStr .. " = " .. tostring(v) .. ","
-        elseif not hide_non_text then
-            line = indent .. keyStr .. " = <" .. type(v) .. ">,"
-        end
-
-        if line then output_func(line) end
+    if type == rce.events.Gesture then
+        -- a = kind, b = phase, c/d = x/y, then value, pointer id
+        if b ~= G.Update then console_print("gesture", a, b, c, d, ...) end
+        return
     end
-
-    output_func(string.rep("\t", depth) .. "}")
+    console_print("event", type, a, b, c, d, "at", sim_time)
 end
 
---table input, hide-unsafe-values, depth, visitid, function to run on loop
-spickle(_G, false, 0, {}, function(chunk)
-    -- You can buffer, log, or stream this however you like
-    print(chunk)
+-- Script threads: spawn() runs a function as a coroutine that can wait()
+-- on the engine timers or wait_event() on a platform message.
+spawn(function()
+    local _, left, top, right, bottom = wait_event(rce.events.InsetsChanged)
+    console_print("first insets", left, top, right, bottom)
+    wait(1.0)
+    console_print("one second later", sim_time)
 end)
+
+-- Readable dump of the global table (rce.serialize is native; format "binary"
+-- gives a compact form that round-trips through rce.deserialize).
+print(rce.serialize(_G, { format = "text", hide_non_text = false }))
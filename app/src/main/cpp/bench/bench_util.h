@@ -0,0 +1,53 @@
+#pragma once
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <chrono>
+
+// Host benchmark helpers. Run a Release build by hand for numbers; ctest runs
+// every benchmark once with --quick (small sizes) so they keep working.
+
+namespace rce_bench {
+
+inline bool quick_mode(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--quick") == 0) return true;
+    }
+    return false;
+}
+
+inline uint64_t now_ns() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Keeps a result alive so the optimizer can't drop the work that made it.
+template <typename T>
+inline void keep(const T& v) {
+#if defined(__GNUC__)
+    asm volatile("" : : "r,m"(v) : "memory");
+#else
+    static volatile T sink;
+    sink = v;
+#endif
+}
+
+// Best of `reps` runs of fn(), in nanoseconds per op.
+template <typename Fn>
+inline double best_ns_per_op(int reps, uint64_t ops, Fn&& fn) {
+    double best = 0.0;
+    for (int r = 0; r < reps; r++) {
+        const uint64_t t0 = now_ns();
+        fn();
+        const double ns = (double)(now_ns() - t0) / (double)(ops ? ops : 1);
+        if (r == 0 || ns < best) best = ns;
+    }
+    return best;
+}
+
+inline void report(const char* name, double ns_per_op, const char* unit = "op") {
+    printf("%-44s %10.2f ns/%s\n", name, ns_per_op, unit);
+}
+
+} // namespace rce_bench
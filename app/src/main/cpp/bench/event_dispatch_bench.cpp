@@ -0,0 +1,61 @@
+#include "app/event_dispatcher.h"
+#include "bench_util.h"
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+using namespace rce;
+
+// Dispatch cost per message with 1, 8 and 64 listeners on one type, against
+// the unordered_map<EPType, vector<std::function>> dispatcher it replaced.
+
+static uint64_t g_sink = 0;
+
+int main(int argc, char** argv) {
+    const bool quick = rce_bench::quick_mode(argc, argv);
+    const uint32_t msgs = quick ? 20000 : 2000000;
+    const int reps = quick ? 1 : 5;
+
+    EPMsg msg{};
+    msg.type = EPType::SetUiMode;
+    msg.a = 1;
+
+    printf("event dispatch, %u msgs per run\n", msgs);
+    const uint32_t counts[] = {1, 8, 64};
+    for (uint32_t listeners : counts) {
+        // Old: hash lookup + std::function per listener.
+        std::unordered_map<EPType, std::vector<std::function<void(const EPMsg&)>>> old_map;
+        for (uint32_t i = 0; i < listeners; i++) {
+            uint64_t* sink = &g_sink;
+            old_map[msg.type].push_back([sink, i](const EPMsg& m) { *sink += m.a + i; });
+        }
+        const double old_ns = rce_bench::best_ns_per_op(reps, msgs, [&] {
+            for (uint32_t n = 0; n < msgs; n++) {
+                auto it = old_map.find(msg.type);
+                if (it == old_map.end()) continue;
+                for (auto& fn : it->second) fn(msg);
+            }
+        });
+
+        // New: dense per-type table, inline callables.
+        EPSubscription subs[EP_MAX_LISTENERS_PER_TYPE];
+        for (uint32_t i = 0; i < listeners; i++) {
+            uint64_t* sink = &g_sink;
+            subs[i] = ep_subscribe(msg.type, [sink, i](const EPMsg& m) { *sink += m.a + i; });
+        }
+        const double new_ns = rce_bench::best_ns_per_op(reps, msgs, [&] {
+            for (uint32_t n = 0; n < msgs; n++) ep_dispatch(msg);
+        });
+        for (uint32_t i = 0; i < listeners; i++) ep_unsubscribe(subs[i]);
+
+        char name[64];
+        snprintf(name, sizeof(name), "std::function map, %u listener(s)", listeners);
+        rce_bench::report(name, old_ns, "msg");
+        snprintf(name, sizeof(name), "ep_dispatch, %u listener(s)", listeners);
+        rce_bench::report(name, new_ns, "msg");
+    }
+
+    rce_bench::keep(g_sink);
+    return 0;
+}
@@ -0,0 +1,138 @@
+#include "app/event_pipe.h"
+#include "bench_util.h"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+using namespace rce;
+
+// Throughput of the p2e pipe with a producer and a consumer thread, against
+// the mutex ring it replaced (kept here verbatim as the reference).
+
+namespace old_pipe {
+
+static constexpr uint32_t CAP = 512;
+
+struct Ring {
+    EPMsg buf[CAP]{};
+    uint32_t head = 0; // next write
+    uint32_t tail = 0; // next read
+    uint32_t count = 0;
+    std::mutex m;
+
+    uint64_t pushed = 0;
+    uint64_t popped = 0;
+    uint64_t dropped = 0;
+    uint64_t highwater = 0;
+};
+
+static bool push(Ring& r, const EPMsg& msg) {
+    std::lock_guard<std::mutex> lock(r.m);
+
+    if (r.count >= CAP) {
+        r.dropped++;
+        return false;
+    }
+
+    r.buf[r.head] = msg;
+    r.head = (r.head + 1) % CAP;
+    r.count++;
+    r.pushed++;
+    if (r.count > r.highwater) r.highwater = r.count;
+    return true;
+}
+
+static bool pop(Ring& r, EPMsg* out) {
+    if (!out) return false;
+
+    std::lock_guard<std::mutex> lock(r.m);
+
+    if (r.count == 0) return false;
+
+    *out = r.buf[r.tail];
+    r.tail = (r.tail + 1) % CAP;
+    r.count--;
+    r.popped++;
+    return true;
+}
+
+} // namespace old_pipe
+
+static old_pipe::Ring g_old;
+
+// Runs producer/consumer threads; returns ns per message.
+template <typename Post, typename Consume>
+static double run_pair(uint32_t n, Post post, Consume consume) {
+    std::atomic<bool> go{false};
+    uint64_t sum = 0;
+
+    std::thread consumer([&] {
+        while (!go.load(std::memory_order_acquire)) {}
+        uint32_t got = 0;
+        while (got < n) {
+            const uint32_t k = consume(&sum);
+            if (k == 0) std::this_thread::yield();
+            got += k;
+        }
+    });
+
+    const uint64_t t0 = rce_bench::now_ns();
+    go.store(true, std::memory_order_release);
+    EPMsg m{};
+    m.type = EPType::SetUiMode;
+    for (uint32_t i = 0; i < n; i++) {
+        m.a = i;
+        while (!post(m)) std::this_thread::yield();
+    }
+    consumer.join();
+    const uint64_t t1 = rce_bench::now_ns();
+
+    rce_bench::keep(sum);
+    return (double)(t1 - t0) / (double)n;
+}
+
+int main(int argc, char** argv) {
+    const bool quick = rce_bench::quick_mode(argc, argv);
+    const uint32_t N = quick ? 100000 : 4000000;
+    const int reps = quick ? 1 : 5;
+
+    ep_init();
+
+    double best_old = 0, best_poll = 0, best_drain = 0;
+    for (int r = 0; r < reps; r++) {
+        const double old_ns = run_pair(N,
+            [](const EPMsg& m) { return old_pipe::push(g_old, m); },
+            [](uint64_t* sum) -> uint32_t {
+                EPMsg m;
+                if (!old_pipe::pop(g_old, &m)) return 0;
+                *sum += m.a;
+                return 1;
+            });
+        const double poll_ns = run_pair(N,
+            [](const EPMsg& m) { return ep_post_p2e(m); },
+            [](uint64_t* sum) -> uint32_t {
+                EPMsg m;
+                if (!ep_poll_p2e(&m)) return 0;
+                *sum += m.a;
+                return 1;
+            });
+        const double drain_ns = run_pair(N,
+            [](const EPMsg& m) { return ep_post_p2e(m); },
+            [](uint64_t* sum) -> uint32_t {
+                EPMsg buf[64];
+                const size_t k = ep_drain_p2e(buf, 64);
+                for (size_t i = 0; i < k; i++) *sum += buf[i].a;
+                return (uint32_t)k;
+            });
+        if (r == 0 || old_ns < best_old) best_old = old_ns;
+        if (r == 0 || poll_ns < best_poll) best_poll = poll_ns;
+        if (r == 0 || drain_ns < best_drain) best_drain = drain_ns;
+    }
+
+    printf("event pipe, %u msgs, producer + consumer thread\n", N);
+    rce_bench::report("mutex ring push/pop", best_old, "msg");
+    rce_bench::report("spsc ring post/poll", best_poll, "msg");
+    rce_bench::report("spsc ring post/drain(64)", best_drain, "msg");
+    return 0;
+}
@@ -0,0 +1,58 @@
+#include "input/gesture.h"
+#include "bench_util.h"
+#include "../tests/gesture_traces.h"
+
+#include <vector>
+
+using namespace input;
+
+// GestureRecognizer::update over the recorded traces played back to back,
+// per raw event and per frame, plus the cost of a frame with no input.
+
+int main(int argc, char** argv) {
+    const bool quick = rce_bench::quick_mode(argc, argv);
+    const uint32_t loops = quick ? 20 : 2000;
+    const int reps = quick ? 1 : 5;
+
+    // Every trace in turn, each starting 1 s after the previous one began.
+    std::vector<PointerEvent> events;
+    uint64_t offset = 0;
+    for (uint32_t n = 0; n < loops; n++) {
+        for (const gesture_traces::Trace& t : gesture_traces::kTraces) {
+            if (!gesture_traces::parse(t.text, events, offset)) {
+                fprintf(stderr, "bad trace %s\n", t.name);
+                return 1;
+            }
+            offset += 1000000000ull;
+        }
+    }
+    const gesture_traces::Frames frames = gesture_traces::split_frames(events);
+
+    uint64_t gestures = 0;
+    GestureRecognizer rec;
+    const double replay_ns = rce_bench::best_ns_per_op(reps, 1, [&] {
+        rec.reset();
+        gestures = 0;
+        gesture_traces::replay(rec, frames, [&gestures](GestureSpan gs) { gestures += gs.size(); });
+    });
+    rce_bench::keep(gestures);
+
+    printf("gestures: %zu events in %zu frames -> %llu gestures\n",
+           events.size(), frames.begin.size(), (unsigned long long)gestures);
+    rce_bench::report("replay", replay_ns / (double)events.size(), "event");
+    rce_bench::report("replay", replay_ns / (double)frames.begin.size(), "frame");
+
+    // Idle frames: only the per-slot long-press / update scan runs.
+    const uint32_t idle = quick ? 10000 : 1000000;
+    const EventSpan none(nullptr, 0);
+    uint64_t now = offset;
+    const double idle_ns = rce_bench::best_ns_per_op(reps, idle, [&] {
+        for (uint32_t i = 0; i < idle; i++) {
+            now += 16666667;
+            rec.update(none, now);
+        }
+    });
+    rce_bench::keep(now);
+    rce_bench::report("update, no events", idle_ns, "frame");
+    return 0;
+}
@@ -0,0 +1,154 @@
+#include "luax/lua_alloc.h"
+#include "bench_util.h"
+
+extern "C" {
+#include "lua.h"
+#include "lauxlib.h"
+#include "lualib.h"
+}
+
+// Allocation-heavy Lua workloads on LuaPoolAllocator against the default
+// realloc-based allocator (luaL_newstate). Each workload is a function run
+// `iters` times in a fresh state, with a full GC between iterations so the
+// free lists actually get reused.
+
+struct Workload {
+    const char* name;
+    const char* code; // defines run(n)
+    int n;
+};
+
+// The old main.lua spickle(_G) dump: tostring/string.rep/table.sort/concat per key.
+static const char* kSpickle = R"LUA(
+local spickle
+spickle = function(intable, hide_non_text, depth, visited, output_func)
+    if visited[intable] then
+        output_func(string.rep("\t", depth) .. "<circular reference>")
+        return
+    end
+    visited[intable] = true
+    output_func(string.rep("\t", depth) .. "{")
+    local indent = string.rep("\t", depth + 1)
+    local sortedKeys = {}
+    for k, _ in pairs(intable) do table.insert(sortedKeys, k) end
+    table.sort(sortedKeys, function(a, b) return tostring(a) < tostring(b) end)
+    for _, k in ipairs(sortedKeys) do
+        local v = intable[k]
+        local keyStr = (type(k) == "string" and k:match("^%a[%w_]*$")) and k or ("[" .. tostring(k) .. "]")
+        local line
+        if type(v) == "table" then
+            output_func(indent .. keyStr .. " = ")
+            spickle(v, hide_non_text, depth + 1, visited, output_func)
+            output_func(indent .. ",")
+        elseif type(v) == "string" then
+            line = indent .. keyStr .. " = \"" .. v .. "\","
+        elseif type(v) == "number" or type(v) == "boolean" or type(v) == "nil" then
+            line = indent .. keyStr .. " = " .. tostring(v) .. ","
+        elseif not hide_non_text then
+            line = indent .. keyStr .. " = <" .. type(v) .. ">,"
+        end
+        if line then output_func(line) end
+    end
+    output_func(string.rep("\t", depth) .. "}")
+end
+function run(n)
+    local bytes = 0
+    for i = 1, n do
+        spickle(_G, false, 0, {}, function(chunk) bytes = bytes + #chunk end)
+    end
+    return bytes
+end
+)LUA";
+
+static const char* kTables = R"LUA(
+function run(n)
+    local keep = {}
+    for i = 1, n do
+        local t = { x = i, y = i * 2, name = "p", list = { i, i + 1, i + 2 } }
+        keep[(i % 512) + 1] = t
+    end
+    return #keep
+end
+)LUA";
+
+static const char* kStrings = R"LUA(
+function run(n)
+    local acc = 0
+    for i = 1, n do
+        local s = "item_" .. i .. ":" .. (i * 3)
+        acc = acc + #s
+    end
+    return acc
+end
+)LUA";
+
+static const char* kClosures = R"LUA(
+function run(n)
+    local acc = 0
+    for i = 1, n do
+        local f = function(a) return a + i end
+        acc = f(acc) % 1000003
+    end
+    return acc
+end
+)LUA";
+
+static double run_workload(const Workload& w, bool pool, int iters, LuaAllocStats* stats_out) {
+    LuaPoolAllocator alloc;
+    lua_State* L = pool ? lua_newstate(LuaPoolAllocator::lua_alloc, &alloc) : luaL_newstate();
+    luaL_openlibs(L);
+    if (luaL_dostring(L, w.code) != 0) {
+        fprintf(stderr, "%s: %s\n", w.name, lua_tostring(L, -1));
+        lua_close(L);
+        return 0.0;
+    }
+
+    const uint64_t t0 = rce_bench::now_ns();
+    for (int i = 0; i < iters; i++) {
+        lua_getglobal(L, "run");
+        lua_pushinteger(L, w.n);
+        if (lua_pcall(L, 1, 1, 0) != 0) fprintf(stderr, "%s: %s\n", w.name, lua_tostring(L, -1));
+        lua_pop(L, 1);
+        lua_gc(L, LUA_GCCOLLECT, 0);
+    }
+    const uint64_t t1 = rce_bench::now_ns();
+
+    if (stats_out) *stats_out = alloc.stats();
+    lua_close(L);
+    return (double)(t1 - t0) / iters;
+}
+
+int main(int argc, char** argv) {
+    const bool quick = rce_bench::quick_mode(argc, argv);
+    const int scale = quick ? 20 : 1;
+    const int iters = quick ? 1 : 5;
+    const int reps = quick ? 1 : 3;
+
+    const Workload workloads[] = {
+        {"spickle(_G)", kSpickle, 20 / scale ? 20 / scale : 1},
+        {"tables", kTables, 200000 / scale},
+        {"strings", kStrings, 200000 / scale},
+        {"closures", kClosures, 200000 / scale},
+    };
+
+    printf("lua allocator, %d iteration(s) per run, best of %d\n", iters, reps);
+    for (const Workload& w : workloads) {
+        double best_default = 0, best_pool = 0;
+        LuaAllocStats st;
+        for (int r = 0; r < reps; r++) {
+            const double d = run_workload(w, false, iters, nullptr);
+            const double p = run_workload(w, true, iters, &st);
+            if (r == 0 || d < best_default) best_default = d;
+            if (r == 0 || p < best_pool) best_pool = p;
+        }
+        char name[64];
+        snprintf(name, sizeof(name), "%s, default l_alloc", w.name);
+        rce_bench::report(name, best_default, "iter");
+        snprintf(name, sizeof(name), "%s, LuaPoolAllocator", w.name);
+        rce_bench::report(name, best_pool, "iter");
+        printf("    pool: allocs=%llu large=%llu peak=%llu KB reserved=%llu KB\n",
+               (unsigned long long)st.allocs, (unsigned long long)st.large_allocs,
+               (unsigned long long)(st.peak_bytes / 1024), (unsigned long long)(st.pool_reserved / 1024));
+    }
+    return 0;
+}
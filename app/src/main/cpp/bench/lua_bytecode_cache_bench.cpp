@@ -0,0 +1,119 @@
+#include "app/paths.h"
+#include "luax/lua_bytecode_cache.h"
+#include "bench_util.h"
+
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "lua.h"
+#include "lauxlib.h"
+#include "lualib.h"
+}
+
+// Startup cost of loading a large script set: cold parse (luaL_loadfile)
+// against the bytecode cache, first run (parse + dump + write) and warm (lundump).
+// Scripts are generated into a temp dir; nothing is written to the repo.
+
+static std::string write_module(const std::string& dir, int index, int funcs) {
+    std::string src;
+    src.reserve((size_t)funcs * 200);
+    char line[256];
+    snprintf(line, sizeof(line), "local M = {}\nlocal lookup = { name = \"mod%d\", size = %d }\n", index, funcs);
+    src += line;
+    for (int f = 0; f < funcs; f++) {
+        snprintf(line, sizeof(line),
+                 "function M.f%d(a, b, t)\n"
+                 "  local s = 0\n"
+                 "  for i = 1, #t do if t[i] > a then s = s + t[i] * %d else s = s - b end end\n"
+                 "  return s, lookup.name .. \"_%d\", { x = a, y = b, n = %d.5 }\n"
+                 "end\n", f, f + 1, f, f);
+        src += line;
+    }
+    src += "return M\n";
+
+    char name[32];
+    snprintf(name, sizeof(name), "mod%03d.lua", index);
+    const std::string path = app::paths::join(dir, name);
+    FILE* fp = fopen(path.c_str(), "wb");
+    if (!fp) return {};
+    fwrite(src.data(), 1, src.size(), fp);
+    fclose(fp);
+    return path;
+}
+
+// Loads (compiles or undumps) every file once; returns ns for the whole set.
+template <typename Load>
+static uint64_t load_all(lua_State* L, const std::vector<std::string>& files, Load load) {
+    const uint64_t t0 = rce_bench::now_ns();
+    for (const std::string& f : files) {
+        if (load(L, f.c_str()) != 0) {
+            fprintf(stderr, "load failed: %s\n", lua_tostring(L, -1));
+        }
+        lua_pop(L, 1);
+    }
+    return rce_bench::now_ns() - t0;
+}
+
+int main(int argc, char** argv) {
+    const bool quick = rce_bench::quick_mode(argc, argv);
+    const int modules = quick ? 10 : 200;
+    const int funcs = quick ? 20 : 150;
+    const int reps = quick ? 1 : 5;
+
+    char tmpl[] = "/tmp/rce_luac_bench_XXXXXX";
+    if (!mkdtemp(tmpl)) {
+        perror("mkdtemp");
+        return 1;
+    }
+    const std::string root = tmpl;
+    const std::string src_dir = app::paths::join(root, "scripts");
+    mkdir(src_dir.c_str(), 0755);
+
+    std::vector<std::string> files;
+    size_t total_bytes = 0;
+    for (int i = 0; i < modules; i++) {
+        files.push_back(write_module(src_dir, i, funcs));
+        FILE* fp = fopen(files.back().c_str(), "rb");
+        if (fp) { fseek(fp, 0, SEEK_END); total_bytes += (size_t)ftell(fp); fclose(fp); }
+    }
+
+    app::paths::AppPaths p;
+    p.data = root;
+    p.cache = app::paths::join(root, "cache");
+    app::paths::set(p);
+
+    lua_State* L = luaL_newstate();
+
+    uint64_t cold = 0, first = 0, warm = 0;
+    for (int r = 0; r < reps; r++) {
+        const uint64_t c = load_all(L, files, luaL_loadfile);
+        if (r == 0 || c < cold) cold = c;
+    }
+
+    // First cached run compiles and writes every entry; later runs hit.
+    first = load_all(L, files, luax_loadfile_cached);
+    for (int r = 0; r < reps; r++) {
+        const uint64_t w = load_all(L, files, luax_loadfile_cached);
+        if (r == 0 || w < warm) warm = w;
+    }
+
+    const LuaBytecodeCacheStats st = luax_bytecode_cache_stats();
+    lua_close(L);
+
+    printf("bytecode cache: %d modules, %zu KB of source\n", modules, total_bytes / 1024);
+    rce_bench::report("cold parse (luaL_loadfile)", (double)cold / modules, "module");
+    rce_bench::report("cache miss (parse + dump + write)", (double)first / modules, "module");
+    rce_bench::report("cache hit (lundump)", (double)warm / modules, "module");
+    printf("cache: hits=%llu misses=%llu writes=%llu write_errors=%llu\n",
+           (unsigned long long)st.hits, (unsigned long long)st.misses,
+           (unsigned long long)st.writes, (unsigned long long)st.write_errors);
+
+    const std::string cmd = "rm -rf '" + root + "'";
+    if (system(cmd.c_str()) != 0) fprintf(stderr, "could not remove %s\n", root.c_str());
+
+    // A warm run that didn't hit means the cache is broken, not just slow.
+    return (st.hits == (uint64_t)modules * (uint64_t)reps && st.write_errors == 0) ? 0 : 1;
+}
@@ -0,0 +1,147 @@
+#include "bench_util.h"
+
+extern "C" {
+#include "lua.h"
+#include "lauxlib.h"
+#include "lualib.h"
+}
+
+// Lua VM micro-benchmarks. Built twice (see CMakeLists.txt): lua_vm_bench
+// uses the VM as configured, lua_vm_bench_stock the stock switch VM, so
+// running both side by side shows what RCE_LUA_FAST_VM buys.
+
+#ifndef RCE_LUA_VM_LABEL
+#define RCE_LUA_VM_LABEL "?"
+#endif
+
+struct Case {
+    const char* name;
+    const char* code; // defines run(n); n is the op count reported on
+    int n;
+};
+
+static const Case kCases[] = {
+    {"numeric for + add", R"LUA(
+function run(n)
+    local s = 0
+    for i = 1, n do s = s + i end
+    return s
+end)LUA", 20000000},
+
+    {"arith mix (mul/div/sub/mod)", R"LUA(
+function run(n)
+    local x, y = 1.5, 0
+    for i = 1, n do
+        y = (y + x * i) / 1.0001 - (i % 7)
+    end
+    return y
+end)LUA", 10000000},
+
+    {"while + compare (lt/le/eq)", R"LUA(
+function run(n)
+    local i, c = 0, 0
+    while i < n do
+        if i <= c then c = c + 2 end
+        if i == 1000 then c = c - 1 end
+        i = i + 1
+    end
+    return c
+end)LUA", 10000000},
+
+    {"array read/write", R"LUA(
+function run(n)
+    local t = {}
+    for i = 1, 1024 do t[i] = i end
+    local s = 0
+    for i = 1, n do
+        local k = (i % 1024) + 1
+        t[k] = t[k] + 1
+        s = s + t[k]
+    end
+    return s
+end)LUA", 10000000},
+
+    {"hash field get/set", R"LUA(
+function run(n)
+    local p = { x = 0, y = 0, vx = 1, vy = 2 }
+    for i = 1, n do
+        p.x = p.x + p.vx
+        p.y = p.y + p.vy
+    end
+    return p.x + p.y
+end)LUA", 10000000},
+
+    {"lua function calls", R"LUA(
+local function add(a, b) return a + b end
+function run(n)
+    local s = 0
+    for i = 1, n do s = add(s, i) end
+    return s
+end)LUA", 10000000},
+
+    {"method calls (self)", R"LUA(
+local V = {}
+V.__index = V
+function V:len2() return self.x * self.x + self.y * self.y end
+function run(n)
+    local v = setmetatable({ x = 3, y = 4 }, V)
+    local s = 0
+    for i = 1, n do s = s + v:len2() end
+    return s
+end)LUA", 5000000},
+
+    {"string concat + len", R"LUA(
+function run(n)
+    local s = 0
+    for i = 1, n do
+        local str = "k" .. (i % 100)
+        s = s + #str
+    end
+    return s
+end)LUA", 2000000},
+
+    {"string.format / sub / find", R"LUA(
+function run(n)
+    local s = 0
+    for i = 1, n do
+        local str = string.format("item_%d", i)
+        if string.find(str, "_", 1, true) then s = s + #string.sub(str, 2, 4) end
+    end
+    return s
+end)LUA", 1000000},
+};
+
+int main(int argc, char** argv) {
+    const bool quick = rce_bench::quick_mode(argc, argv);
+    const int div = quick ? 100 : 1;
+    const int reps = quick ? 1 : 3;
+
+    lua_State* L = luaL_newstate();
+    luaL_openlibs(L);
+
+    printf("lua vm: %s\n", RCE_LUA_VM_LABEL);
+    int errors = 0;
+    for (const Case& c : kCases) {
+        if (luaL_dostring(L, c.code) != 0) {
+            fprintf(stderr, "%s: %s\n", c.name, lua_tostring(L, -1));
+            lua_pop(L, 1);
+            errors++;
+            continue;
+        }
+        const int n = c.n / div;
+        const double ns = rce_bench::best_ns_per_op(reps, (uint64_t)n, [&] {
+            lua_getglobal(L, "run");
+            lua_pushinteger(L, n);
+            if (lua_pcall(L, 1, 1, 0) != 0) {
+                fprintf(stderr, "%s: %s\n", c.name, lua_tostring(L, -1));
+                errors++;
+            }
+            lua_pop(L, 1);
+        });
+        rce_bench::report(c.name, ns, "iter");
+        lua_gc(L, LUA_GCCOLLECT, 0);
+    }
+
+    lua_close(L);
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,61 @@
+#include "gfx/render_commands.h"
+#include "bench_util.h"
+
+#include <vector>
+
+// Record + sort + replay into a null backend, per command, for 1k..100k draws.
+// "shuffled" keys vary in layer/material/depth; "in order" skips the sort.
+
+namespace {
+
+class NullBackend : public RenderBackend {
+public:
+    void clear(const CmdClear&) override { n++; }
+    void viewport(const RectI&) override { n++; }
+    void scissor(const CmdScissor&) override { n++; }
+    void draw(const CmdDraw& d) override { n += d.count; }
+    void sprites(const CmdSprites& s) override { n += s.count; }
+    uint64_t n = 0;
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const bool quick = rce_bench::quick_mode(argc, argv);
+    const int reps = quick ? 1 : 7;
+    const uint32_t sizes[] = {1000, 10000, 100000};
+
+    RenderCommandBuffer buf;
+    NullBackend backend;
+
+    for (uint32_t n : sizes) {
+        if (quick && n > 10000) break;
+
+        std::vector<uint64_t> shuffled(n), ordered(n);
+        uint32_t rng = 42;
+        for (uint32_t i = 0; i < n; i++) {
+            rng = rng * 1664525u + 1013904223u;
+            const uint8_t layer = (rng >> 30) ? render_key::LAYER_WORLD : render_key::LAYER_UI;
+            shuffled[i] = render_key::draw(layer, 0, (rng >> 8) % 64, (rng >> 14) % 4096);
+            ordered[i] = render_key::draw(render_key::LAYER_WORLD, 0, 1, i);
+        }
+
+        for (int variant = 0; variant < 2; variant++) {
+            const std::vector<uint64_t>& keys = variant == 0 ? shuffled : ordered;
+            uint32_t passes = 0;
+            const double ns = rce_bench::best_ns_per_op(reps, n, [&] {
+                buf.reset();
+                buf.viewport(render_key::state(render_key::LAYER_PRESENT, 0), RectI{0, 0, 1920, 1080});
+                for (uint32_t i = 0; i < n; i++) buf.draw(keys[i], CmdDraw{i, 0, 0, 1});
+                buf.submit(backend);
+                passes = buf.stats().sort_passes;
+            });
+            char name[64];
+            snprintf(name, sizeof(name), "%u draws, %s (%u sort passes)", n,
+                     variant == 0 ? "shuffled" : "in order", passes);
+            rce_bench::report(name, ns, "cmd");
+        }
+    }
+    rce_bench::keep(backend.n);
+    return 0;
+}
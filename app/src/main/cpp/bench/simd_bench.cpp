@@ -0,0 +1,65 @@
+#include "gfx/simd_kernels.h"
+#include "gfx/sprite_batch.h"
+#include "bench_util.h"
+
+#include <vector>
+
+// Each 2D kernel, vector path against its *_scalar reference, ns per element
+// on 4096-element SoA arrays (cache resident), repeated.
+
+int main(int argc, char** argv) {
+    const bool quick = rce_bench::quick_mode(argc, argv);
+    const uint32_t n = 4096;
+    const uint32_t loops = quick ? 10 : 2000;
+    const int reps = quick ? 1 : 5;
+    const uint64_t ops = (uint64_t)n * loops;
+
+    std::vector<float> in[10];
+    uint32_t rng = 5;
+    for (auto& v : in) {
+        v.resize(n);
+        for (float& f : v) {
+            rng = rng * 1664525u + 1013904223u;
+            f = (float)(rng >> 8) * (1.0f / 16777216.0f);
+        }
+    }
+    std::vector<float> o0(n), o1(n), o2(n);
+    std::vector<uint32_t> packed(n);
+    std::vector<SpriteVertex> verts((size_t)n * SPRITE_VERTICES_PER_QUAD);
+    const QuadCornersSoA soa{in[0].data(), in[1].data(), in[2].data(), in[3].data(), in[4].data(),
+                             in[5].data(), in[6].data(), in[7].data(), in[8].data(), in[9].data()};
+
+    printf("simd kernels (%s), %u elements x %u\n", simd_backend_name(), n, loops);
+    auto pair = [&](const char* name, auto&& vec, auto&& scalar) {
+        const double v = rce_bench::best_ns_per_op(reps, ops, [&] { for (uint32_t l = 0; l < loops; l++) vec(); });
+        const double s = rce_bench::best_ns_per_op(reps, ops, [&] { for (uint32_t l = 0; l < loops; l++) scalar(); });
+        rce_bench::report(name, v, "elem");
+        char label[64];
+        snprintf(label, sizeof(label), "%s_scalar", name);
+        rce_bench::report(label, s, "elem");
+        printf("    speedup x%.2f\n", v > 0.0 ? s / v : 0.0);
+    };
+
+    pair("simd_quad_corners",
+         [&] { simd_quad_corners(soa, n, verts.data()); rce_bench::keep(verts[0].x); },
+         [&] { simd_quad_corners_scalar(soa, n, verts.data()); rce_bench::keep(verts[0].x); });
+    pair("simd_sincos",
+         [&] { simd_sincos(in[0].data(), n, o0.data(), o1.data()); rce_bench::keep(o0[0]); },
+         [&] { simd_sincos_scalar(in[0].data(), n, o0.data(), o1.data()); rce_bench::keep(o0[0]); });
+    pair("simd_pack_rgba8",
+         [&] { simd_pack_rgba8(in[0].data(), in[1].data(), in[2].data(), in[3].data(), n, packed.data());
+               rce_bench::keep(packed[0]); },
+         [&] { simd_pack_rgba8_scalar(in[0].data(), in[1].data(), in[2].data(), in[3].data(), n, packed.data());
+               rce_bench::keep(packed[0]); });
+    pair("simd_hsv_to_rgb",
+         [&] { simd_hsv_to_rgb(in[0].data(), in[1].data(), in[2].data(), n, o0.data(), o1.data(), o2.data());
+               rce_bench::keep(o0[0]); },
+         [&] { simd_hsv_to_rgb_scalar(in[0].data(), in[1].data(), in[2].data(), n, o0.data(), o1.data(), o2.data());
+               rce_bench::keep(o0[0]); });
+    pair("simd_rgb_to_hsv",
+         [&] { simd_rgb_to_hsv(in[0].data(), in[1].data(), in[2].data(), n, o0.data(), o1.data(), o2.data());
+               rce_bench::keep(o0[0]); },
+         [&] { simd_rgb_to_hsv_scalar(in[0].data(), in[1].data(), in[2].data(), n, o0.data(), o1.data(), o2.data());
+               rce_bench::keep(o0[0]); });
+    return 0;
+}
@@ -0,0 +1,113 @@
+#include "gfx/simd_kernels.h"
+#include "gfx/sprite_batch.h"
+#include "bench_util.h"
+
+#include <vector>
+
+// CPU side of the sprite path for 10k..100k sprites per frame: vertex
+// generation alone, and SpriteBatcher with the block/flush loop
+// GlSpriteRenderer runs (blocks of at most SPRITE_MAX_QUADS_PER_DRAW quads
+// in a host-memory stand-in for the mapped ring region).
+
+namespace {
+
+struct FrameResult {
+    uint32_t sprites = 0;
+    uint32_t batches = 0;
+    uint32_t draw_calls = 0;
+};
+
+FrameResult run_frame(SpriteBatcher& batcher, std::vector<SpriteVertex>& region, const std::vector<Sprite>& sprites) {
+    batcher.begin_frame();
+    const uint32_t capacity = (uint32_t)(region.size() / SPRITE_VERTICES_PER_QUAD);
+    uint32_t used = 0;
+    bool mapped = false;
+
+    auto flush = [&] {
+        if (!mapped) return;
+        mapped = false;
+        used += batcher.quad_count();
+        batcher.stats().draw_calls += batcher.batch_count();
+    };
+
+    const Sprite* p = sprites.data();
+    uint32_t count = (uint32_t)sprites.size();
+    while (count > 0) {
+        if (!mapped) {
+            const uint32_t left = capacity - used;
+            if (left == 0) break;
+            batcher.begin(region.data() + (size_t)used * SPRITE_VERTICES_PER_QUAD,
+                          left < SPRITE_MAX_QUADS_PER_DRAW ? left : SPRITE_MAX_QUADS_PER_DRAW);
+            mapped = true;
+        }
+        const uint32_t n = batcher.add(p, count);
+        p += n;
+        count -= n;
+        if (count > 0) flush();
+    }
+    flush();
+
+    FrameResult r;
+    r.sprites = batcher.stats().sprites;
+    r.batches = batcher.stats().batches;
+    r.draw_calls = batcher.stats().draw_calls;
+    return r;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const bool quick = rce_bench::quick_mode(argc, argv);
+    const int reps = quick ? 1 : 9;
+    const uint32_t sizes[] = {10000, 25000, 50000, 100000};
+    printf("sprites: simd=%s\n", simd_backend_name());
+
+    SpriteBatcher batcher;
+    bool ok = true;
+    for (uint32_t n : sizes) {
+        if (quick && n > 10000) break;
+
+        // Rotated, tinted sprites spread over a 1080p screen (deterministic LCG).
+        std::vector<Sprite> sprites(n);
+        uint32_t rng = 777;
+        auto next = [&rng] { rng = rng * 1664525u + 1013904223u; return rng >> 8; };
+        for (Sprite& s : sprites) {
+            s = Sprite{};
+            s.x = (float)(next() % 1920);
+            s.y = (float)(next() % 1080);
+            s.w = s.h = 16.0f + (float)(next() % 48);
+            s.ox = s.oy = 0.5f;
+            s.rotation = (float)(next() % 6283) * 0.001f;
+            s.u1 = s.v1 = 1.0f;
+            s.color = 0xff000000u | next();
+        }
+
+        std::vector<SpriteVertex> region((size_t)n * SPRITE_VERTICES_PER_QUAD);
+        const double build_ns = rce_bench::best_ns_per_op(reps, n, [&] {
+            sprite_build_vertices(sprites.data(), n, region.data());
+        });
+        rce_bench::keep(region[0].x);
+        char name[96];
+        snprintf(name, sizeof(name), "%u sprite_build_vertices", n);
+        rce_bench::report(name, build_ns, "sprite");
+
+        // Texture layouts: one atlas, 8 textures sorted, 8 textures interleaved
+        // (every sprite breaks the run: the batcher's worst case).
+        static const char* kLayouts[] = {"1 texture", "8 textures sorted", "8 textures interleaved"};
+        for (uint32_t layout = 0; layout < 3; layout++) {
+            for (uint32_t i = 0; i < n; i++) {
+                sprites[i].texture = layout == 0 ? 1 : layout == 1 ? 1 + i * 8 / n : 1 + i % 8;
+            }
+            FrameResult r;
+            const double ns = rce_bench::best_ns_per_op(reps, n, [&] { r = run_frame(batcher, region, sprites); });
+            snprintf(name, sizeof(name), "%u batched, %s", n, kLayouts[layout]);
+            rce_bench::report(name, ns, "sprite");
+            printf("    batches=%u draw_calls=%u (vs %u with one draw per sprite)\n", r.batches, r.draw_calls, n);
+            if (r.sprites != n) {
+                fprintf(stderr, "only %u of %u sprites batched\n", r.sprites, n);
+                ok = false;
+            }
+        }
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,54 @@
+#include "app/timer.h"
+#include "bench_util.h"
+
+#include <vector>
+
+using namespace rce;
+
+// timers_update with 100k live repeating timers at 60 Hz, plus add/cancel churn.
+
+static uint64_t g_fired = 0;
+
+int main(int argc, char** argv) {
+    const bool quick = rce_bench::quick_mode(argc, argv);
+    const uint32_t live = quick ? 10000 : 100000;
+    const uint32_t frames = quick ? 60 : 600;
+    const uint64_t step_ns = 16666667;
+
+    timers_init();
+
+    // Intervals spread over 0.1 .. 10 s (deterministic LCG).
+    uint32_t rng = 12345;
+    auto next_rand = [&rng] { rng = rng * 1664525u + 1013904223u; return rng >> 8; };
+    for (uint32_t i = 0; i < live; i++) {
+        const float interval = 0.1f + (float)(next_rand() % 9900) * 0.001f;
+        timers_every(interval, [](TimerId) { g_fired++; });
+    }
+
+    const uint64_t t0 = rce_bench::now_ns();
+    for (uint32_t f = 0; f < frames; f++) timers_update(step_ns);
+    const uint64_t t1 = rce_bench::now_ns();
+
+    printf("timers: %u live repeating, %u frames at 60 Hz, %llu fires\n",
+           live, frames, (unsigned long long)g_fired);
+    rce_bench::report("timers_update", (double)(t1 - t0) / frames, "frame");
+    rce_bench::report("timers_update", g_fired ? (double)(t1 - t0) / (double)g_fired : 0.0, "fire");
+
+    // Churn on top of the live set: one-shots added and canceled before they fire.
+    const uint32_t churn = quick ? 10000 : 1000000;
+    std::vector<TimerId> ids(1024);
+    const double churn_ns = rce_bench::best_ns_per_op(quick ? 1 : 3, churn, [&] {
+        for (uint32_t i = 0; i < churn; i += 1024) {
+            for (size_t k = 0; k < ids.size(); k++) ids[k] = timers_after(60.0f, [](TimerId) { g_fired++; });
+            for (size_t k = 0; k < ids.size(); k++) timers_cancel(ids[k]);
+        }
+    });
+    rce_bench::report("timers_after + timers_cancel", churn_ns, "pair");
+
+    const uint64_t t2 = rce_bench::now_ns();
+    timers_update(step_ns);
+    rce_bench::report("timers_update after churn", (double)(rce_bench::now_ns() - t2), "frame");
+
+    timers_init();
+    return 0;
+}
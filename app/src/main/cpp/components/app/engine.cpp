@@ -4,29 +4,93 @@
 #include "app/log.h"
 
 #include "app/timer.h"
+#include "gfx/render_commands.h"
+#include "luax/lua_runtime.h"
 
 namespace rce {
 
+static LuaRuntime g_lua;
+static RenderCommandBuffer g_render;
+static FixedStep g_fixed;
+static float g_alpha = 0.0f;
+static uint64_t g_sim_ns = 0;
+
+// platform -> Lua forwarders; dropped in engine_shutdown so a re-init doesn't stack them
+static EPSubscription g_lua_subs[4] = {};
+
 void engine_init() {
     timers_init();
+    g_fixed.configure(FixedStepConfig{});
+    g_alpha = 0.0f;
+    g_sim_ns = 0;
 
     // quick proof:
     timers_every(1.0f, [](rce::TimerId) {
         LOGI("timer: 1 second tick");
     });
+
+    g_lua.init();
+
+    // Forward platform -> engine messages to the script's on_event hook.
+    g_lua_subs[0] = ep_subscribe(EPType::InsetsChanged,  [](const EPMsg& msg) { g_lua.dispatch_event(msg); });
+    g_lua_subs[1] = ep_subscribe(EPType::SurfaceResized, [](const EPMsg& msg) { g_lua.dispatch_event(msg); });
+    g_lua_subs[2] = ep_subscribe(EPType::Gesture,        [](const EPMsg& msg) { g_lua.dispatch_event(msg); });
+    g_lua_subs[3] = ep_subscribe(EPType::Pointer,        [](const EPMsg& msg) { g_lua.dispatch_event(msg); });
+}
+
+void engine_shutdown() {
+    for (EPSubscription& sub : g_lua_subs) {
+        ep_unsubscribe(sub);
+        sub = 0;
+    }
+    g_lua.shutdown();
+}
+
+bool engine_load_script(const char* path) {
+    return g_lua.load_entry(path);
 }
 
-void engine_tick(float dt) {
+LuaRuntime& engine_lua() { return g_lua; }
+RenderCommandBuffer& engine_render_commands() { return g_render; }
+
+void engine_set_fixed_step(const FixedStepConfig& cfg) {
+    g_fixed.configure(cfg);
+}
+
+float engine_interp_alpha() { return g_alpha; }
+uint64_t engine_sim_time_ns() { return g_sim_ns; }
+
+void engine_tick(uint64_t dt_ns) {
+    const uint64_t frame_start_ns = time_now_ns();
+
+    // 0. New frame of render commands (arena memory is reused)
+    g_render.reset();
 
     // 1. Dispatch platform -> engine events
     ep_dispatch_all_p2e();
 
-    // 2. Update game logic (future)
-    // 3. Update timers
-	timers_update(dt);
-    // 4. Submit rendering (future)
-    // ...
-    (void)dt;
+    // 2. Fixed-step simulation: N steps per rendered frame, independent of frame rate
+    const FixedStepFrame frame = g_fixed.advance(dt_ns);
+    const uint64_t step_ns = g_fixed.step_ns();
+    const float step_s = time_ns_to_s(step_ns);
+    for (uint32_t i = 0; i < frame.steps; i++) {
+        // 2a. Update game logic (scripts)
+        g_lua.tick(step_s);
+        // 2b. Update timers
+        timers_update(step_ns);
+        g_sim_ns += step_ns;
+    }
+    g_alpha = frame.alpha;
+
+    // 3. Rendering: systems above recorded into g_render with sort keys. The
+    //    platform appends its present pass after engine_tick and submits the
+    //    buffer (sorted once, there) to its RenderBackend.
+
+    // 4. Hand this frame's console_print output to the log in one batch
+    g_lua.flush_console();
+
+    // 5. Lua GC, bounded to what's left of the frame budget
+    g_lua.gc_step(frame_start_ns);
 }
 
 }
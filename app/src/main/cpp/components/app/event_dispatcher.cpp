@@ -2,20 +2,116 @@
 
 namespace rce {
 
-static std::unordered_map<EPType, std::vector<EPCallback>> g_listeners;
+// One dense, fixed-capacity listener list per EPType (indexed by ep_type_index).
+// Lists are only compacted when no dispatch is running, so indices stay stable
+// while callbacks subscribe/unsubscribe.
+struct ListenerList {
+    EPListener items[EP_MAX_LISTENERS_PER_TYPE];
+    uint32_t count = 0;
+    bool has_dead = false;
+};
 
-void ep_subscribe(EPType type, EPCallback cb) {
-    g_listeners[type].push_back(std::move(cb));
+static ListenerList g_lists[EP_TYPE_COUNT];
+static uint32_t g_dispatch_depth = 0;
+static uint32_t g_next_serial = 1;
+
+// Handle layout: [31..24] type index + 1, [23..0] serial (never 0).
+static EPSubscription make_id(uint32_t ti) {
+    uint32_t serial = g_next_serial++ & 0x00FFFFFFu;
+    if (serial == 0) serial = g_next_serial++ & 0x00FFFFFFu;
+    return ((ti + 1) << 24) | serial;
+}
+
+static void compact(ListenerList& list) {
+    uint32_t write = 0;
+    for (uint32_t read = 0; read < list.count; ++read) {
+        EPListener& src = list.items[read];
+        if (!src.alive) {
+            if (src.destroy) src.destroy(src.storage);
+            src = EPListener{};
+            continue;
+        }
+        if (write != read) {
+            EPListener& dst = list.items[write];
+            src.relocate(dst.storage, src.storage);
+            dst.invoke = src.invoke;
+            dst.relocate = src.relocate;
+            dst.destroy = src.destroy;
+            dst.id = src.id;
+            dst.alive = true;
+            src = EPListener{};
+        }
+        ++write;
+    }
+    list.count = write;
+    list.has_dead = false;
+}
+
+namespace detail {
+
+EPListener* ep_alloc_listener(EPType type) {
+    const uint32_t ti = ep_type_index(type);
+    if (ti >= EP_TYPE_COUNT) return nullptr;
+
+    ListenerList& list = g_lists[ti];
+    if (list.count >= EP_MAX_LISTENERS_PER_TYPE && list.has_dead && g_dispatch_depth == 0) {
+        compact(list);
+    }
+    if (list.count >= EP_MAX_LISTENERS_PER_TYPE) return nullptr;
+
+    EPListener& l = list.items[list.count++];
+    l.id = make_id(ti);
+    l.alive = true;
+    return &l;
+}
+
+} // namespace detail
+
+void ep_unsubscribe(EPSubscription sub) {
+    if (sub == 0) return;
+    const uint32_t ti = (sub >> 24) - 1;
+    if (ti >= EP_TYPE_COUNT) return;
+
+    ListenerList& list = g_lists[ti];
+    for (uint32_t i = 0; i < list.count; ++i) {
+        EPListener& l = list.items[i];
+        if (l.alive && l.id == sub) {
+            // Don't destroy yet: we may be inside this very callable.
+            l.alive = false;
+            list.has_dead = true;
+            if (g_dispatch_depth == 0) compact(list);
+            return;
+        }
+    }
+}
+
+void ep_dispatch(const EPMsg& msg) {
+    const uint32_t ti = ep_type_index(msg.type);
+    if (ti >= EP_TYPE_COUNT) return;
+
+    ListenerList& list = g_lists[ti];
+    const uint32_t n = list.count; // listeners added during dispatch start with the next message
+
+    ++g_dispatch_depth;
+    for (uint32_t i = 0; i < n; ++i) {
+        EPListener& l = list.items[i];
+        if (l.alive) l.invoke(l.storage, msg);
+    }
+    --g_dispatch_depth;
+
+    if (g_dispatch_depth == 0) {
+        for (auto& other : g_lists) {
+            if (other.has_dead) compact(other);
+        }
+    }
 }
 
 void ep_dispatch_all_p2e() {
-    EPMsg msg;
-    while (ep_poll_p2e(&msg)) {
-        auto it = g_listeners.find(msg.type);
-        if (it != g_listeners.end()) {
-            for (auto& fn : it->second) {
-                fn(msg);
-            }
+    EPMsg batch[32];
+    size_t n;
+    while ((n = ep_drain_p2e(batch, 32)) > 0) {
+        for (size_t i = 0; i < n; i++) {
+            ep_dispatch(batch[i]);
         }
     }
 }
@@ -1,55 +1,179 @@
 #include "app/event_pipe.h"
-#include <mutex>
+#include <atomic>
+#include <stddef.h>
+#include <string.h>
 
 namespace rce {
 
+// Power of two so the free-running indices can be masked instead of wrapped.
 static constexpr uint32_t CAP = 512;
+static constexpr uint32_t MASK = CAP - 1;
+static_assert((CAP & MASK) == 0, "CAP must be a power of two");
+
+static constexpr size_t CACHE_LINE = 64;
+
+// Mailbox for a coalesced type: holds only the newest message.
+// Written by the ring's producer, read by its consumer, guarded by a seqlock
+// (odd seq = write in progress). Payload words are atomics so the consumer's
+// speculative read is race-free; a torn read is simply retried.
+// Every store advances seq by 2, so the consumer remembers the seq it last
+// delivered: a different even seq means a newer message, and the gap says how
+// many were replaced unseen. There is no separate pending flag to race with.
+struct CoalesceSlot {
+    std::atomic<uint32_t> seq{0};
+    std::atomic<uint32_t> words[5]{}; // type|flags, a, b, c, d
+    uint32_t delivered = 0; // consumer only
+};
 
+// Single-producer / single-consumer ring.
+// head is only written by the producer, tail only by the consumer; each lives
+// on its own cache line together with the counters that side owns, so the two
+// threads never write to the same line.
+// Indices run freely (uint32 wrap is fine): count = head - tail.
 struct Ring {
-    EPMsg buf[CAP]{};
-    uint32_t head = 0; // next write
-    uint32_t tail = 0; // next read
-    uint32_t count = 0;
-    std::mutex m;
-
-    uint64_t pushed = 0;
-    uint64_t popped = 0;
-    uint64_t dropped = 0;
-    uint64_t highwater = 0;
+    // ---- producer side
+    alignas(CACHE_LINE) std::atomic<uint32_t> head{0}; // next write
+    uint32_t tail_cache = 0; // producer's last seen tail (avoids re-reading the consumer line)
+    std::atomic<uint64_t> pushed{0};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<uint64_t> highwater{0};
+
+    // ---- consumer side
+    alignas(CACHE_LINE) std::atomic<uint32_t> tail{0}; // next read
+    uint32_t head_cache = 0; // consumer's last seen head
+    std::atomic<uint64_t> popped{0};
+    std::atomic<uint64_t> coalesced{0}; // counted when the newer message is delivered
+
+    alignas(CACHE_LINE) CoalesceSlot slots[EP_TYPE_COUNT];
+
+    alignas(CACHE_LINE) EPMsg buf[CAP]{};
 };
 
 static Ring g_p2e;
 static Ring g_e2p;
 static bool g_inited = false;
 
+// "Latest state wins" types coalesce by default.
+static std::atomic<bool> g_coalesce[EP_TYPE_COUNT] = { {true}, {true}, {false}, {false}, {false}, {false} };
+
+// Counters are only ever written by one side, so a relaxed load + store is
+// enough (no RMW needed) and readers never block.
+static inline void bump(std::atomic<uint64_t>& c) {
+    c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+static void slot_store(CoalesceSlot& s, const EPMsg& msg) {
+    const uint32_t q = s.seq.load(std::memory_order_relaxed);
+    s.seq.store(q + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    s.words[0].store((uint32_t)msg.type | ((uint32_t)msg.flags << 16), std::memory_order_relaxed);
+    s.words[1].store(msg.a, std::memory_order_relaxed);
+    s.words[2].store(msg.b, std::memory_order_relaxed);
+    s.words[3].store(msg.c, std::memory_order_relaxed);
+    s.words[4].store(msg.d, std::memory_order_relaxed);
+
+    s.seq.store(q + 2, std::memory_order_release);
+}
+
+// Returns the seq the message was read at.
+static uint32_t slot_load(const CoalesceSlot& s, EPMsg* out) {
+    uint32_t w[5];
+    uint32_t q0, q1;
+    do {
+        q0 = s.seq.load(std::memory_order_acquire);
+        for (int i = 0; i < 5; i++) w[i] = s.words[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        q1 = s.seq.load(std::memory_order_relaxed);
+    } while ((q0 & 1u) || q0 != q1);
+
+    out->type  = (EPType)(w[0] & 0xFFFFu);
+    out->flags = (uint16_t)(w[0] >> 16);
+    out->a = w[1];
+    out->b = w[2];
+    out->c = w[3];
+    out->d = w[4];
+    return q0;
+}
+
+static bool push_coalesced(Ring& r, CoalesceSlot& s, const EPMsg& msg) {
+    slot_store(s, msg);
+    bump(r.pushed);
+    return true;
+}
+
 static bool push(Ring& r, const EPMsg& msg) {
-    std::lock_guard<std::mutex> lock(r.m);
+    const uint32_t ti = ep_type_index(msg.type);
+    if (ti < EP_TYPE_COUNT && g_coalesce[ti].load(std::memory_order_relaxed)) {
+        return push_coalesced(r, r.slots[ti], msg);
+    }
+
+    const uint32_t head = r.head.load(std::memory_order_relaxed);
 
-    if (r.count >= CAP) {
-        r.dropped++;
-        return false;
+    if (head - r.tail_cache >= CAP) {
+        r.tail_cache = r.tail.load(std::memory_order_acquire);
+        if (head - r.tail_cache >= CAP) {
+            bump(r.dropped);
+            return false;
+        }
     }
 
-    r.buf[r.head] = msg;
-    r.head = (r.head + 1) % CAP;
-    r.count++;
-    r.pushed++;
-    if (r.count > r.highwater) r.highwater = r.count;
+    r.buf[head & MASK] = msg;
+    r.head.store(head + 1, std::memory_order_release);
+
+    bump(r.pushed);
+    // Uses the cached tail, so this is an upper bound on the true fill level.
+    const uint64_t count = (uint64_t)(head + 1 - r.tail_cache);
+    if (count > r.highwater.load(std::memory_order_relaxed)) {
+        r.highwater.store(count, std::memory_order_relaxed);
+    }
     return true;
 }
 
-static bool pop(Ring& r, EPMsg* out) {
-    if (!out) return false;
+static size_t drain(Ring& r, EPMsg* out, size_t max) {
+    if (!out || max == 0) return 0;
 
-    std::lock_guard<std::mutex> lock(r.m);
+    const uint32_t tail = r.tail.load(std::memory_order_relaxed);
+    size_t n = 0;
 
-    if (r.count == 0) return false;
+    if (r.head_cache - tail < max) {
+        r.head_cache = r.head.load(std::memory_order_acquire);
+    }
 
-    *out = r.buf[r.tail];
-    r.tail = (r.tail + 1) % CAP;
-    r.count--;
-    r.popped++;
-    return true;
+    const uint32_t avail = r.head_cache - tail;
+    if (avail > 0) {
+        n = (avail < max) ? avail : max;
+
+        // At most two contiguous runs: [tail, end of buffer) and [0, rest).
+        const uint32_t start = tail & MASK;
+        const size_t first = (n < CAP - start) ? n : (size_t)(CAP - start);
+        memcpy(out, &r.buf[start], first * sizeof(EPMsg));
+        if (n > first) memcpy(out + first, &r.buf[0], (n - first) * sizeof(EPMsg));
+
+        r.tail.store(tail + (uint32_t)n, std::memory_order_release);
+    }
+
+    // Coalesced mailboxes come after the ring contents.
+    for (uint32_t i = 0; i < EP_TYPE_COUNT && n < max; i++) {
+        CoalesceSlot& s = r.slots[i];
+        if (s.seq.load(std::memory_order_relaxed) == s.delivered) continue;
+        const uint32_t q = slot_load(s, &out[n++]);
+        // Each store is 2 apart; all but the one just read were replaced unseen.
+        const uint32_t replaced = (q - s.delivered) / 2 - 1;
+        if (replaced) {
+            r.coalesced.store(r.coalesced.load(std::memory_order_relaxed) + replaced, std::memory_order_relaxed);
+        }
+        s.delivered = q;
+    }
+
+    if (n > 0) {
+        r.popped.store(r.popped.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+    return n;
+}
+
+static bool pop(Ring& r, EPMsg* out) {
+    return drain(r, out, 1) == 1;
 }
 
 void ep_init() {
@@ -63,22 +187,34 @@ bool ep_poll_p2e(EPMsg* out)       { ep_init(); return pop(g_p2e, out);  }
 bool ep_post_e2p(const EPMsg& msg) { ep_init(); return push(g_e2p, msg); }
 bool ep_poll_e2p(EPMsg* out)       { ep_init(); return pop(g_e2p, out);  }
 
+size_t ep_drain_p2e(EPMsg* out, size_t max) { ep_init(); return drain(g_p2e, out, max); }
+size_t ep_drain_e2p(EPMsg* out, size_t max) { ep_init(); return drain(g_e2p, out, max); }
+
+void ep_set_coalesce(EPType type, bool enabled) {
+    const uint32_t ti = ep_type_index(type);
+    if (ti >= EP_TYPE_COUNT) return;
+    g_coalesce[ti].store(enabled, std::memory_order_relaxed);
+}
+
+bool ep_get_coalesce(EPType type) {
+    const uint32_t ti = ep_type_index(type);
+    if (ti >= EP_TYPE_COUNT) return false;
+    return g_coalesce[ti].load(std::memory_order_relaxed);
+}
+
 EPCounters ep_get_counters() {
     EPCounters c{};
-    {
-        std::lock_guard<std::mutex> lock(g_p2e.m);
-        c.p2e_pushed = g_p2e.pushed;
-        c.p2e_popped = g_p2e.popped;
-        c.p2e_dropped = g_p2e.dropped;
-        c.p2e_highwater = g_p2e.highwater;
-    }
-    {
-        std::lock_guard<std::mutex> lock(g_e2p.m);
-        c.e2p_pushed = g_e2p.pushed;
-        c.e2p_popped = g_e2p.popped;
-        c.e2p_dropped = g_e2p.dropped;
-        c.e2p_highwater = g_e2p.highwater;
-    }
+    c.p2e_pushed    = g_p2e.pushed.load(std::memory_order_relaxed);
+    c.p2e_popped    = g_p2e.popped.load(std::memory_order_relaxed);
+    c.p2e_dropped   = g_p2e.dropped.load(std::memory_order_relaxed);
+    c.p2e_highwater = g_p2e.highwater.load(std::memory_order_relaxed);
+    c.p2e_coalesced = g_p2e.coalesced.load(std::memory_order_relaxed);
+
+    c.e2p_pushed    = g_e2p.pushed.load(std::memory_order_relaxed);
+    c.e2p_popped    = g_e2p.popped.load(std::memory_order_relaxed);
+    c.e2p_dropped   = g_e2p.dropped.load(std::memory_order_relaxed);
+    c.e2p_highwater = g_e2p.highwater.load(std::memory_order_relaxed);
+    c.e2p_coalesced = g_e2p.coalesced.load(std::memory_order_relaxed);
     return c;
 }
 
@@ -0,0 +1,693 @@
+#include "app/log.h"
+#include "app/paths.h"
+#include "app/time.h"
+
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__ANDROID__)
+  #include <android/log.h>
+#endif
+
+namespace rce {
+
+static constexpr const char* LOG_TAG = "MyLuaApp";
+
+// Per-thread ring of variable-length records. Power of two; offsets run freely.
+static constexpr uint32_t RING_BYTES = 64 * 1024;
+static constexpr uint32_t RING_MASK  = RING_BYTES - 1;
+static constexpr uint32_t MAX_RECORD = RING_BYTES / 4;
+static constexpr uint32_t MAX_STR    = 2048;   // longer %s arguments are cut
+
+static constexpr size_t FILE_MAX_BYTES = 1u << 20; // rotate at 1 MiB
+static constexpr int FILE_KEEP = 3;                // rce.log.1 .. rce.log.3
+
+static constexpr uint64_t SITE_WINDOW_NS = 1000000000ull;
+
+enum : uint8_t { REC_FMT = 0, REC_RAW = 1, REC_PAD = 2 };
+
+// Record layout (8-byte aligned):
+//   RecordHeader
+//   REC_FMT: nargs tag bytes, pad to 8, nargs 8-byte slots, string bytes (NUL terminated)
+//   REC_RAW: text bytes + NUL
+//   REC_PAD: only size/kind are valid; fills the end of the buffer before a wrap
+struct RecordHeader {
+    uint32_t size;      // whole record, multiple of 8
+    uint8_t kind;
+    uint8_t level;
+    uint16_t nargs;
+    uint64_t ts_ns;
+    const char* fmt;
+};
+
+static inline uint32_t align8(uint32_t n) { return (n + 7u) & ~7u; }
+
+// Single producer (the owning thread) / single consumer (the writer).
+struct LogRing {
+    alignas(64) std::atomic<uint32_t> head{0};
+    uint32_t tail_cache = 0;
+
+    alignas(64) std::atomic<uint32_t> tail{0};
+    std::atomic<bool> retired{false};   // owning thread exited
+    LogRing* next = nullptr;            // registry list (guarded by g_mu)
+
+    alignas(64) uint8_t buf[RING_BYTES];
+};
+
+// Marks the ring retired when its thread exits; the writer frees it once drained.
+struct ThreadRing {
+    LogRing* ring = nullptr;
+    ~ThreadRing() { if (ring) ring->retired.store(true, std::memory_order_release); }
+};
+static thread_local ThreadRing t_ring;
+
+enum : int { ST_IDLE = 0, ST_RUNNING = 1, ST_STOPPING = 2, ST_STOPPED = 3 };
+
+static std::mutex g_mu;                      // registry, file config, flush handshake
+static std::condition_variable g_wake;       // wakes the writer
+static std::condition_variable g_flushed;    // wakes log_flush callers
+static LogRing* g_rings = nullptr;
+static std::thread g_thread;
+static std::atomic<int> g_state{ST_IDLE};
+static std::atomic<bool> g_writer_sleeping{false};
+static uint64_t g_flush_req = 0;
+static uint64_t g_flush_done = 0;
+static std::string g_file_dir;               // pending log_open_file()
+static bool g_file_dir_changed = false;
+
+static std::atomic<uint64_t> g_written{0};
+static std::atomic<uint64_t> g_dropped{0};
+static std::atomic<uint64_t> g_rate_limited{0};
+static uint64_t g_start_ns = 0;
+
+// ---- file sink (writer thread only, or under g_mu when synchronous)
+
+struct FileSink {
+    std::string path;
+    FILE* f = nullptr;
+    size_t bytes = 0;
+
+    void close() {
+        if (f) std::fclose(f);
+        f = nullptr;
+    }
+
+    void open(const std::string& dir) {
+        close();
+        if (dir.empty() || !app::paths::make_dirs(dir)) return;
+        path = app::paths::join(dir, "rce.log");
+        f = std::fopen(path.c_str(), "ab");
+        if (!f) return;
+        std::fseek(f, 0, SEEK_END);
+        const long pos = std::ftell(f);
+        bytes = pos > 0 ? (size_t)pos : 0;
+    }
+
+    void rotate() {
+        close();
+        char from[512], to[512];
+        for (int i = FILE_KEEP - 1; i >= 1; i--) {
+            std::snprintf(from, sizeof(from), "%s.%d", path.c_str(), i);
+            std::snprintf(to, sizeof(to), "%s.%d", path.c_str(), i + 1);
+            std::rename(from, to);
+        }
+        std::snprintf(to, sizeof(to), "%s.1", path.c_str());
+        std::rename(path.c_str(), to);
+        f = std::fopen(path.c_str(), "wb");
+        bytes = 0;
+    }
+
+    void write(LogLevel level, uint64_t ts_ns, const char* text, size_t len) {
+        if (!f) return;
+        const double t = (double)(ts_ns - g_start_ns) * 1e-9;
+        const int n = std::fprintf(f, "[%12.6f] %c ", t, level == LogLevel::Error ? 'E' : 'I');
+        std::fwrite(text, 1, len, f);
+        std::fputc('\n', f);
+        bytes += (n > 0 ? (size_t)n : 0) + len + 1;
+        if (bytes >= FILE_MAX_BYTES) rotate();
+    }
+};
+
+static FileSink g_file;
+
+static void sink_platform(LogLevel level, const char* text) {
+#if defined(__ANDROID__)
+    __android_log_write(level == LogLevel::Error ? ANDROID_LOG_ERROR : ANDROID_LOG_INFO, LOG_TAG, text);
+#else
+    FILE* out = (level == LogLevel::Error) ? stderr : stdout;
+    std::fputs(text, out);
+    std::fputc('\n', out);
+#endif
+}
+
+static void sink_all(LogLevel level, uint64_t ts_ns, const std::string& text) {
+    sink_platform(level, text.c_str());
+    g_file.write(level, ts_ns, text.data(), text.size());
+    g_written.fetch_add(1, std::memory_order_relaxed);
+}
+
+// ---- encoding (producer side)
+
+static uint32_t record_size(const detail::LogArg* args, uint32_t nargs, uint32_t* str_lens) {
+    uint32_t size = align8((uint32_t)sizeof(RecordHeader) + nargs) + 8u * nargs;
+    for (uint32_t i = 0; i < nargs; i++) {
+        if (args[i].tag != detail::LOG_STR) continue;
+        const char* s = args[i].s ? args[i].s : "(null)";
+        const size_t len = std::strlen(s);
+        str_lens[i] = len < MAX_STR ? (uint32_t)len : MAX_STR;
+        size += str_lens[i] + 1;
+    }
+    return align8(size);
+}
+
+static void encode(uint8_t* dst, uint32_t size, LogLevel level, uint64_t ts_ns, const char* fmt,
+                   const detail::LogArg* args, uint32_t nargs, const uint32_t* str_lens) {
+    RecordHeader h;
+    h.size = size;
+    h.kind = REC_FMT;
+    h.level = (uint8_t)level;
+    h.nargs = (uint16_t)nargs;
+    h.ts_ns = ts_ns;
+    h.fmt = fmt;
+    std::memcpy(dst, &h, sizeof(h));
+
+    uint8_t* tags = dst + sizeof(RecordHeader);
+    uint8_t* slots = dst + align8((uint32_t)sizeof(RecordHeader) + nargs);
+    uint8_t* strs = slots + 8u * nargs;
+
+    for (uint32_t i = 0; i < nargs; i++) {
+        tags[i] = args[i].tag;
+        if (args[i].tag == detail::LOG_STR) {
+            const char* s = args[i].s ? args[i].s : "(null)";
+            std::memcpy(slots + 8u * i, &str_lens[i], sizeof(uint32_t));
+            std::memcpy(strs, s, str_lens[i]);
+            strs[str_lens[i]] = 0;
+            strs += str_lens[i] + 1;
+        } else {
+            std::memcpy(slots + 8u * i, &args[i].u64, 8);
+        }
+    }
+}
+
+static LogRing* this_thread_ring() {
+    if (t_ring.ring) return t_ring.ring;
+    LogRing* r = new LogRing();
+    {
+        std::lock_guard<std::mutex> lk(g_mu);
+        r->next = g_rings;
+        g_rings = r;
+    }
+    t_ring.ring = r;
+    return r;
+}
+
+// Returns where to write `size` bytes, or nullptr if the ring is full.
+// *new_head is what to publish once the record is written.
+static uint8_t* ring_reserve(LogRing& r, uint32_t size, uint32_t* new_head) {
+    const uint32_t head = r.head.load(std::memory_order_relaxed);
+    const uint32_t pos = head & RING_MASK;
+    const uint32_t contig = RING_BYTES - pos;
+    const uint32_t need = (size <= contig) ? size : contig + size;
+
+    if (RING_BYTES - (head - r.tail_cache) < need) {
+        r.tail_cache = r.tail.load(std::memory_order_acquire);
+        if (RING_BYTES - (head - r.tail_cache) < need) return nullptr;
+    }
+
+    if (size > contig) {
+        // Not enough room before the end: pad it out and start at 0.
+        const uint32_t pad_size = contig;
+        const uint8_t kind = REC_PAD;
+        std::memcpy(&r.buf[pos], &pad_size, sizeof(pad_size));
+        std::memcpy(&r.buf[pos + 4], &kind, 1);
+        *new_head = head + contig + size;
+        return &r.buf[0];
+    }
+    *new_head = head + size;
+    return &r.buf[pos];
+}
+
+static void wake_writer() {
+    if (g_writer_sleeping.load(std::memory_order_relaxed) &&
+        g_writer_sleeping.exchange(false, std::memory_order_relaxed)) {
+        g_wake.notify_one();
+    }
+}
+
+// ---- formatting (writer side)
+
+#if defined(__GNUC__)
+  #pragma GCC diagnostic push
+  #pragma GCC diagnostic ignored "-Wformat-nonliteral"
+  #pragma GCC diagnostic ignored "-Wformat-security"
+#endif
+
+template <typename T>
+static void append_spec(std::string& out, const char* spec, const int* stars, int nstars, T v) {
+    char tmp[256];
+    int n;
+    if (nstars == 0)      n = std::snprintf(tmp, sizeof(tmp), spec, v);
+    else if (nstars == 1) n = std::snprintf(tmp, sizeof(tmp), spec, stars[0], v);
+    else                  n = std::snprintf(tmp, sizeof(tmp), spec, stars[0], stars[1], v);
+    if (n < 0) return;
+    if ((size_t)n < sizeof(tmp)) {
+        out.append(tmp, (size_t)n);
+        return;
+    }
+    const size_t at = out.size();
+    out.resize(at + (size_t)n + 1);
+    if (nstars == 0)      std::snprintf(&out[at], (size_t)n + 1, spec, v);
+    else if (nstars == 1) std::snprintf(&out[at], (size_t)n + 1, spec, stars[0], v);
+    else                  std::snprintf(&out[at], (size_t)n + 1, spec, stars[0], stars[1], v);
+    out.resize(at + (size_t)n);
+}
+
+#if defined(__GNUC__)
+  #pragma GCC diagnostic pop
+#endif
+
+struct ArgReader {
+    const uint8_t* tags;
+    const uint8_t* slots;
+    const char* strs;
+    uint32_t n;
+    uint32_t i = 0;
+
+    bool next(uint8_t* tag, uint64_t* bits, const char** str) {
+        if (i >= n) return false;
+        *tag = tags[i];
+        std::memcpy(bits, slots + 8u * i, 8);
+        if (*tag == detail::LOG_STR) {
+            uint32_t len;
+            std::memcpy(&len, bits, sizeof(len));
+            *str = strs;
+            strs += len + 1;
+        }
+        i++;
+        return true;
+    }
+
+    int next_int() {
+        uint8_t tag;
+        uint64_t bits;
+        const char* s;
+        if (!next(&tag, &bits, &s)) return 0;
+        int32_t v;
+        std::memcpy(&v, &bits, sizeof(v));
+        return v;
+    }
+};
+
+// Formats one spec ("%-8.3f", "%llu", ...) with the next argument. The length
+// modifier is rebuilt from the stored argument size, so it always matches.
+static void format_one(std::string& out, const char* spec_begin, const char* spec_end,
+                       char conv, const int* stars, int nstars, ArgReader& ar) {
+    uint8_t tag;
+    uint64_t bits;
+    const char* str = nullptr;
+    if (!ar.next(&tag, &bits, &str)) {
+        out.append("(missing)");
+        return;
+    }
+
+    char spec[48];
+    size_t len = (size_t)(spec_end - spec_begin);
+    if (len > sizeof(spec) - 4) len = sizeof(spec) - 4;
+    std::memcpy(spec, spec_begin, len);
+
+    int32_t i32; uint32_t u32; int64_t i64; uint64_t u64; double f64; const void* p;
+    std::memcpy(&i32, &bits, 4); std::memcpy(&u32, &bits, 4);
+    std::memcpy(&i64, &bits, 8); std::memcpy(&u64, &bits, 8);
+    std::memcpy(&f64, &bits, 8); std::memcpy(&p, &bits, sizeof(p));
+
+    switch (conv) {
+        case 'd': case 'i': case 'o': case 'u': case 'x': case 'X': case 'c': {
+            const bool wide = (tag == detail::LOG_I64 || tag == detail::LOG_U64);
+            if (wide) { spec[len++] = 'l'; spec[len++] = 'l'; }
+            spec[len++] = conv;
+            spec[len] = 0;
+            switch (tag) {
+                case detail::LOG_I32: append_spec(out, spec, stars, nstars, i32); break;
+                case detail::LOG_U32: append_spec(out, spec, stars, nstars, u32); break;
+                case detail::LOG_I64: append_spec(out, spec, stars, nstars, (long long)i64); break;
+                case detail::LOG_U64: append_spec(out, spec, stars, nstars, (unsigned long long)u64); break;
+                case detail::LOG_F64: append_spec(out, spec, stars, nstars, (int)f64); break;
+                default: out.append("(?)"); break;
+            }
+            return;
+        }
+        case 'e': case 'E': case 'f': case 'F': case 'g': case 'G': case 'a': case 'A':
+            spec[len++] = conv;
+            spec[len] = 0;
+            append_spec(out, spec, stars, nstars, tag == detail::LOG_F64 ? f64 : (double)i64);
+            return;
+        case 's':
+            spec[len++] = 's';
+            spec[len] = 0;
+            append_spec(out, spec, stars, nstars, tag == detail::LOG_STR ? str : "(?)");
+            return;
+        case 'p':
+            spec[len++] = 'p';
+            spec[len] = 0;
+            append_spec(out, spec, stars, nstars, tag == detail::LOG_STR ? (const void*)str : p);
+            return;
+        default:
+            out.append("(?)");
+            return;
+    }
+}
+
+static void format_record(const uint8_t* rec, std::string& out) {
+    RecordHeader h;
+    std::memcpy(&h, rec, sizeof(h));
+
+    if (h.kind == REC_RAW) {
+        out.assign((const char*)rec + sizeof(RecordHeader));
+        return;
+    }
+
+    ArgReader ar;
+    ar.tags = rec + sizeof(RecordHeader);
+    ar.slots = rec + align8((uint32_t)sizeof(RecordHeader) + h.nargs);
+    ar.strs = (const char*)ar.slots + 8u * h.nargs;
+    ar.n = h.nargs;
+
+    out.clear();
+    const char* f = h.fmt;
+    while (*f) {
+        if (*f != '%') {
+            const char* run = f;
+            while (*f && *f != '%') f++;
+            out.append(run, (size_t)(f - run));
+            continue;
+        }
+        if (f[1] == '%') { out.push_back('%'); f += 2; continue; }
+
+        const char* spec_begin = f++;
+        int stars[2];
+        int nstars = 0;
+        while (*f && std::strchr("-+ #0", *f)) f++;
+        if (*f == '*') { stars[nstars++] = ar.next_int(); f++; }
+        else while (*f >= '0' && *f <= '9') f++;
+        if (*f == '.') {
+            f++;
+            if (*f == '*') { stars[nstars++] = ar.next_int(); f++; }
+            else while (*f >= '0' && *f <= '9') f++;
+        }
+        const char* spec_end = f;                   // flags/width/precision only
+        while (*f && std::strchr("hljztL", *f)) f++;  // original length modifier is dropped
+        const char conv = *f;
+        if (!conv) break;
+        f++;
+        if (conv == 'n') continue;
+        format_one(out, spec_begin, spec_end, conv, stars, nstars, ar);
+    }
+}
+
+// ---- writer
+
+static size_t drain_ring(LogRing& r, std::string& line) {
+    uint32_t tail = r.tail.load(std::memory_order_relaxed);
+    const uint32_t head = r.head.load(std::memory_order_acquire);
+    size_t n = 0;
+
+    while (tail != head) {
+        const uint8_t* rec = &r.buf[tail & RING_MASK];
+        uint32_t size;
+        uint8_t kind;
+        std::memcpy(&size, rec, sizeof(size));
+        std::memcpy(&kind, rec + 4, 1);
+
+        if (kind != REC_PAD) {
+            RecordHeader h;
+            std::memcpy(&h, rec, sizeof(h));
+            format_record(rec, line);
+            sink_all((LogLevel)h.level, h.ts_ns, line);
+            n++;
+        }
+        tail += size;
+        r.tail.store(tail, std::memory_order_release);
+    }
+    return n;
+}
+
+static void writer_main() {
+    std::string line;
+    line.reserve(1024);
+
+    std::unique_lock<std::mutex> lk(g_mu);
+    for (;;) {
+        const uint64_t flush_target = g_flush_req;
+        const bool stopping = g_state.load(std::memory_order_acquire) == ST_STOPPING;
+        if (g_file_dir_changed) {
+            g_file.open(g_file_dir);
+            g_file_dir_changed = false;
+        }
+
+        // New rings are only ever pushed at the head, so a snapshot is safe to walk unlocked.
+        LogRing* rings = g_rings;
+        lk.unlock();
+
+        size_t n = 0;
+        for (LogRing* r = rings; r; r = r->next) n += drain_ring(*r, line);
+
+        lk.lock();
+
+        // Free rings whose thread is gone and which are fully drained.
+        for (LogRing** pp = &g_rings; *pp;) {
+            LogRing* r = *pp;
+            if (r->retired.load(std::memory_order_acquire) &&
+                r->tail.load(std::memory_order_relaxed) == r->head.load(std::memory_order_acquire)) {
+                *pp = r->next;
+                delete r;
+            } else {
+                pp = &r->next;
+            }
+        }
+
+        if (flush_target > g_flush_done) {
+            std::fflush(stdout);
+            std::fflush(stderr);
+            if (g_file.f) std::fflush(g_file.f);
+            g_flush_done = flush_target;
+            g_flushed.notify_all();
+        }
+
+        if (stopping && n == 0) break;
+        if (n == 0 && g_flush_req == flush_target && !g_file_dir_changed) {
+            g_writer_sleeping.store(true, std::memory_order_relaxed);
+            g_wake.wait_for(lk, std::chrono::milliseconds(50));
+            g_writer_sleeping.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    std::fflush(stdout);
+    std::fflush(stderr);
+    g_file.close();
+    g_flush_done = g_flush_req;
+    g_flushed.notify_all();
+}
+
+// ---- API
+
+// A joinable std::thread destroyed at exit calls std::terminate, so any exit
+// path that skips log_shutdown (early return from main, exit() after a Lua
+// panic...) stops the writer here instead. Registered on first start, i.e.
+// after g_thread was constructed, so it runs before g_thread's destructor.
+static void log_atexit() {
+    log_shutdown();
+}
+
+void log_init() {
+    static bool s_atexit = false;
+    std::lock_guard<std::mutex> lk(g_mu);
+    const int st = g_state.load(std::memory_order_acquire);
+    if (st == ST_RUNNING || st == ST_STOPPING) return;
+    if (g_start_ns == 0) g_start_ns = time_now_ns();
+    g_file_dir_changed = !g_file_dir.empty(); // reopen after a shutdown
+    g_state.store(ST_RUNNING, std::memory_order_release);
+    g_thread = std::thread(writer_main);
+    if (!s_atexit) {
+        s_atexit = true;
+        std::atexit(log_atexit);
+    }
+}
+
+void log_open_file(const char* dir) {
+    {
+        std::lock_guard<std::mutex> lk(g_mu);
+        g_file_dir = dir ? dir : "";
+        g_file_dir_changed = true;
+        if (g_state.load(std::memory_order_acquire) != ST_RUNNING) {
+            g_file.open(g_file_dir); // synchronous mode writes directly
+            g_file_dir_changed = false;
+        }
+    }
+    g_wake.notify_one();
+}
+
+void log_flush() {
+    if (g_state.load(std::memory_order_acquire) != ST_RUNNING) {
+        std::fflush(stdout);
+        return;
+    }
+    std::unique_lock<std::mutex> lk(g_mu);
+    const uint64_t target = ++g_flush_req;
+    g_wake.notify_one();
+    g_flushed.wait(lk, [target] { return g_flush_done >= target; });
+}
+
+void log_shutdown() {
+    {
+        std::lock_guard<std::mutex> lk(g_mu);
+        if (g_state.load(std::memory_order_acquire) != ST_RUNNING) return;
+        g_state.store(ST_STOPPING, std::memory_order_release);
+    }
+    g_wake.notify_one();
+    g_thread.join();
+    g_state.store(ST_STOPPED, std::memory_order_release);
+}
+
+LogStats log_stats() {
+    LogStats s;
+    s.written = g_written.load(std::memory_order_relaxed);
+    s.dropped = g_dropped.load(std::memory_order_relaxed);
+    s.rate_limited = g_rate_limited.load(std::memory_order_relaxed);
+    return s;
+}
+
+// Writes a record straight to the sinks (writer stopped or never started).
+static void write_sync(const uint8_t* rec) {
+    static thread_local std::string line;
+    RecordHeader h;
+    std::memcpy(&h, rec, sizeof(h));
+    format_record(rec, line);
+    std::lock_guard<std::mutex> lk(g_mu);
+    sink_all((LogLevel)h.level, h.ts_ns, line);
+}
+
+static bool ensure_running() {
+    int st = g_state.load(std::memory_order_acquire);
+    if (st == ST_IDLE) {
+        log_init();
+        st = g_state.load(std::memory_order_acquire);
+    }
+    return st == ST_RUNNING;
+}
+
+static void push_record(LogLevel level, uint64_t ts, const char* fmt,
+                        const detail::LogArg* args, uint32_t nargs) {
+    uint32_t str_lens[64];
+    if (nargs > 64) nargs = 64;
+    const uint32_t size = record_size(args, nargs, str_lens);
+
+    if (!ensure_running()) {
+        std::vector<uint8_t> tmp(size);
+        encode(tmp.data(), size, level, ts, fmt, args, nargs, str_lens);
+        write_sync(tmp.data());
+        return;
+    }
+
+    if (size > MAX_RECORD) {
+        g_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    LogRing& r = *this_thread_ring();
+    uint32_t new_head;
+    uint8_t* dst = ring_reserve(r, size, &new_head);
+    if (!dst) {
+        g_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    encode(dst, size, level, ts, fmt, args, nargs, str_lens);
+    r.head.store(new_head, std::memory_order_release);
+    wake_writer();
+}
+
+namespace detail {
+
+void log_submit(LogSite& site, LogLevel level, const char* fmt, const LogArg* args, uint32_t nargs) {
+    const uint64_t now = time_now_ns();
+
+    // Per-site rate limit: at most LOG_SITE_MAX_PER_SEC records per window.
+    uint64_t w = site.window_ns.load(std::memory_order_relaxed);
+    if (now - w >= SITE_WINDOW_NS && site.window_ns.compare_exchange_strong(w, now, std::memory_order_relaxed)) {
+        site.count.store(0, std::memory_order_relaxed);
+        const uint32_t suppressed = site.suppressed.exchange(0, std::memory_order_relaxed);
+        if (suppressed) {
+            LogArg note[2];
+            note[0].tag = LOG_U32; note[0].u32 = suppressed;
+            note[1].tag = LOG_STR; note[1].s = fmt;
+            push_record(level, now, "(log) %u lines suppressed from: %s", note, 2);
+        }
+    }
+    // Plain load/store instead of an RMW: the limit is approximate under contention anyway.
+    const uint32_t c = site.count.load(std::memory_order_relaxed);
+    site.count.store(c + 1, std::memory_order_relaxed);
+    if (c >= LOG_SITE_MAX_PER_SEC) {
+        site.suppressed.fetch_add(1, std::memory_order_relaxed);
+        g_rate_limited.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    push_record(level, now, fmt, args, nargs);
+}
+
+} // namespace detail
+
+void log_write_raw(LogLevel level, const char* text, size_t len) {
+    const uint64_t now = time_now_ns();
+    const uint32_t max_chunk = MAX_RECORD - (uint32_t)sizeof(RecordHeader) - 8;
+
+    while (len > 0) {
+        // Split on a line break when a chunk has to be cut.
+        size_t n = len;
+        if (n > max_chunk) {
+            n = max_chunk;
+            for (size_t i = max_chunk; i > max_chunk / 2; i--) {
+                if (text[i - 1] == '\n') { n = i; break; }
+            }
+        }
+        size_t body = n;
+        if (body > 0 && text[body - 1] == '\n') body--;
+
+        const uint32_t size = align8((uint32_t)sizeof(RecordHeader) + (uint32_t)body + 1);
+        RecordHeader h{};
+        h.size = size;
+        h.kind = REC_RAW;
+        h.level = (uint8_t)level;
+        h.ts_ns = now;
+
+        if (!ensure_running()) {
+            std::vector<uint8_t> tmp(size);
+            std::memcpy(tmp.data(), &h, sizeof(h));
+            std::memcpy(tmp.data() + sizeof(h), text, body);
+            tmp[sizeof(h) + body] = 0;
+            write_sync(tmp.data());
+        } else {
+            LogRing& r = *this_thread_ring();
+            uint32_t new_head;
+            uint8_t* dst = ring_reserve(r, size, &new_head);
+            if (!dst) {
+                g_dropped.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                std::memcpy(dst, &h, sizeof(h));
+                std::memcpy(dst + sizeof(h), text, body);
+                dst[sizeof(h) + body] = 0;
+                r.head.store(new_head, std::memory_order_release);
+                wake_writer();
+            }
+        }
+        text += n;
+        len -= n;
+    }
+}
+
+} // namespace rce
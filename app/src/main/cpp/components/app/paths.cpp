@@ -1,6 +1,8 @@
 #include "app/paths.h"
 
 #include <vector>
+#include <sys/stat.h>
+#include <sys/types.h>
 
 namespace app::paths {
 
@@ -146,4 +148,24 @@ std::string replace_extension(std::string_view p, std::string_view new_ext) {
     return s + ext;
 }
 
+bool make_dirs(std::string_view dir) {
+    if (dir.empty()) return false;
+    const std::string d = to_posix(dir);
+    std::string cur;
+    size_t i = 0;
+    while (i <= d.size()) {
+        size_t slash = d.find('/', i);
+        if (slash == std::string::npos) slash = d.size();
+        cur = d.substr(0, slash);
+        if (!cur.empty()) {
+            if (::mkdir(cur.c_str(), 0775) != 0) {
+                struct stat st;
+                if (::stat(cur.c_str(), &st) != 0 || !S_ISDIR(st.st_mode)) return false;
+            }
+        }
+        i = slash + 1;
+    }
+    return true;
+}
+
 } // namespace app::paths
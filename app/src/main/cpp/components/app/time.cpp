@@ -1,17 +1,48 @@
 #include "app/time.h"
+#include <chrono>
 
 namespace rce {
 
-static uint64_t g_last_ms = 0;
+static uint64_t g_last_ns = 0;
 
-void time_init(uint64_t start_ms) {
-    g_last_ms = start_ms;
+uint64_t time_now_ns() {
+    using namespace std::chrono;
+    return (uint64_t)duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
 }
 
-float time_update(uint64_t now_ms) {
-    uint64_t delta = now_ms - g_last_ms;
-    g_last_ms = now_ms;
-    return delta / 1000.0f;
+void time_init(uint64_t start_ns) {
+    g_last_ns = start_ns;
+}
+
+uint64_t time_update(uint64_t now_ns) {
+    if (now_ns < g_last_ns) now_ns = g_last_ns; // defensive: never return negative time
+    uint64_t delta = now_ns - g_last_ns;
+    g_last_ns = now_ns;
+    return delta;
+}
+
+void FixedStep::configure(const FixedStepConfig& cfg) {
+    cfg_ = cfg;
+    if (cfg_.step_ns == 0) cfg_.step_ns = 1;
+    if (cfg_.max_steps == 0) cfg_.max_steps = 1;
+    acc_ns_ = 0;
+}
+
+FixedStepFrame FixedStep::advance(uint64_t dt_ns) {
+    FixedStepFrame f;
+    acc_ns_ += dt_ns;
+
+    uint64_t steps = acc_ns_ / cfg_.step_ns;
+    if (steps > cfg_.max_steps) {
+        // Too far behind (breakpoint, app resume, hitch): run the cap and drop the rest.
+        f.dropped_ns = (steps - cfg_.max_steps) * cfg_.step_ns;
+        steps = cfg_.max_steps;
+    }
+    acc_ns_ -= (steps * cfg_.step_ns) + f.dropped_ns;
+
+    f.steps = (uint32_t)steps;
+    f.alpha = (float)((double)acc_ns_ / (double)cfg_.step_ns);
+    return f;
 }
 
 }
@@ -1,39 +1,122 @@
 #include "app/timer.h"
+#include "app/time.h"
+#include <algorithm>
 #include <vector>
 
 namespace rce {
 
-struct TimerEntry {
-    TimerId id = 0;
-    bool active = false;
+// Timers live in a slot array (stable index, generation-tagged) and are ordered
+// by absolute deadline in a binary min-heap. Canceling only retires the slot;
+// its heap entry goes stale and is skipped when it reaches the top (or swept
+// when stale entries outnumber live ones).
 
-    float remaining_s = 0.0f;
-    float repeat_s = 0.0f;
+// Generations are 44 bits and bump on every release, for ids and heap entries
+// alike. Wrapping needs 2^44 reuses of one slot, so a stale id or heap entry
+// can't alias a live timer in practice (12 bits used to wrap after 4095).
+static constexpr uint32_t INDEX_BITS = 20;
+static constexpr uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+static constexpr uint64_t GEN_MASK   = (1ull << (64 - INDEX_BITS)) - 1;
+static constexpr uint32_t NO_SLOT    = 0xFFFFFFFFu;
 
+struct TimerSlot {
     TimerCallback cb;
+    uint64_t repeat_ns = 0;
+    uint64_t gen = 1;          // never 0, so a TimerId is never 0
+    uint32_t next_free = NO_SLOT;
+    bool active = false;
+};
+
+struct HeapEntry {
+    uint64_t deadline_ns;
+    uint64_t seq;              // tie-break: equal deadlines fire in scheduling order
+    uint64_t gen;
+    uint32_t slot;
 };
 
-static std::vector<TimerEntry> g_timers;
-static TimerId g_next_id = 1;
+// std heap functions build a max-heap, so "less" means "fires later".
+static bool fires_later(const HeapEntry& a, const HeapEntry& b) {
+    if (a.deadline_ns != b.deadline_ns) return a.deadline_ns > b.deadline_ns;
+    return a.seq > b.seq;
+}
+
+static std::vector<TimerSlot> g_slots;
+static std::vector<HeapEntry> g_heap;
+static std::vector<HeapEntry> g_due;   // reused scratch for one update
+static uint32_t g_free_head = NO_SLOT;
+static uint32_t g_live = 0;
+static uint32_t g_stale = 0;           // canceled timers whose entry is still queued
+static uint64_t g_now_ns = 0;
+static uint64_t g_seq = 0;
+static bool g_updating = false;        // defers sweeps while g_due holds entries
+
+static TimerId make_id(uint32_t slot, uint64_t gen) {
+    return (gen << INDEX_BITS) | slot;
+}
+
+static uint64_t to_ns(float s) {
+    return time_s_to_ns((double)s);
+}
 
 void timers_init() {
-    g_timers.clear();
-    g_next_id = 1;
+    g_slots.clear();
+    g_heap.clear();
+    g_due.clear();
+    g_free_head = NO_SLOT;
+    g_live = 0;
+    g_stale = 0;
+    g_now_ns = 0;
+    g_seq = 0;
+    g_updating = false;
+}
+
+static void schedule(uint32_t slot, uint64_t gen, uint64_t deadline_ns) {
+    g_heap.push_back({deadline_ns, g_seq++, gen, slot});
+    std::push_heap(g_heap.begin(), g_heap.end(), fires_later);
+}
+
+static void release_slot(uint32_t slot) {
+    TimerSlot& t = g_slots[slot];
+    t.active = false;
+    t.cb = nullptr;
+    t.gen = (t.gen + 1) & GEN_MASK;
+    if (t.gen == 0) t.gen = 1;
+    t.next_free = g_free_head;
+    g_free_head = slot;
+    g_live--;
+}
+
+static void sweep_stale() {
+    auto is_stale = [](const HeapEntry& e) {
+        const TimerSlot& t = g_slots[e.slot];
+        return !t.active || t.gen != e.gen;
+    };
+    g_heap.erase(std::remove_if(g_heap.begin(), g_heap.end(), is_stale), g_heap.end());
+    std::make_heap(g_heap.begin(), g_heap.end(), fires_later);
+    g_stale = 0;
 }
 
 static TimerId add_impl(float delay_s, float repeat_s, TimerCallback cb) {
     if (!cb) return 0;
 
-    TimerEntry e;
-    e.id = g_next_id++;
-    if (e.id == 0) e.id = g_next_id++; // avoid 0
-    e.active = true;
-    e.remaining_s = (delay_s < 0.0f) ? 0.0f : delay_s;
-    e.repeat_s = repeat_s;
-    e.cb = std::move(cb);
+    uint32_t slot;
+    if (g_free_head != NO_SLOT) {
+        slot = g_free_head;
+        g_free_head = g_slots[slot].next_free;
+    } else {
+        if (g_slots.size() > INDEX_MASK) return 0; // out of ids
+        slot = (uint32_t)g_slots.size();
+        g_slots.emplace_back();
+    }
+
+    TimerSlot& t = g_slots[slot];
+    t.active = true;
+    t.next_free = NO_SLOT;
+    t.repeat_ns = (repeat_s > 0.0f) ? to_ns(repeat_s) : 0;
+    t.cb = std::move(cb);
+    g_live++;
 
-    g_timers.push_back(std::move(e));
-    return g_timers.back().id;
+    schedule(slot, t.gen, g_now_ns + to_ns(delay_s));
+    return make_id(slot, t.gen);
 }
 
 TimerId timers_add(const TimerSpec& spec, TimerCallback cb) {
@@ -52,60 +135,67 @@ TimerId timers_every(float interval_s, TimerCallback cb) {
 
 void timers_cancel(TimerId id) {
     if (id == 0) return;
-    for (auto& t : g_timers) {
-        if (t.active && t.id == id) {
-            t.active = false;
-            t.cb = nullptr;
-            return;
-        }
-    }
-}
+    const uint32_t slot = (uint32_t)(id & INDEX_MASK);
+    const uint64_t gen = id >> INDEX_BITS;
+    if (slot >= g_slots.size()) return;
+
+    TimerSlot& t = g_slots[slot];
+    if (!t.active || t.gen != gen) return;
 
-void timers_update(float dt_s) {
-    if (dt_s < 0.0f) dt_s = 0.0f;
+    release_slot(slot);
+    g_stale++; // its heap (or due-list) entry is now dead
 
-    // We allow callbacks to cancel timers (including themselves).
-    // Avoid iterator invalidation by not erasing during iteration.
-    for (auto& t : g_timers) {
-        if (!t.active) continue;
+    if (!g_updating && g_stale > 64 && g_stale > g_live) sweep_stale();
+}
 
-        t.remaining_s -= dt_s;
-        if (t.remaining_s > 0.0f) continue;
+void timers_update(uint64_t dt_ns) {
+    g_now_ns += dt_ns;
+
+    // Pull everything due first, so timers (re)scheduled by callbacks wait
+    // for the next update: each timer fires at most once per update.
+    g_updating = true;
+    g_due.clear();
+    while (!g_heap.empty() && g_heap.front().deadline_ns <= g_now_ns) {
+        std::pop_heap(g_heap.begin(), g_heap.end(), fires_later);
+        g_due.push_back(g_heap.back());
+        g_heap.pop_back();
+    }
 
-        // Fire
-        TimerId id = t.id;
-        TimerCallback cb = t.cb; // copy std::function (safe)
-        if (cb) cb(id);
+    for (const HeapEntry& e : g_due) {
+        TimerSlot* t = &g_slots[e.slot];
+        if (!t->active || t->gen != e.gen) {
+            g_stale--; // canceled before it got here
+            continue;
+        }
 
-        // Timer might have been canceled during cb
-        if (!t.active) continue;
+        // Move the callback out for the call: it may add timers (growing g_slots)
+        // or cancel itself, and no copy of the std::function is needed.
+        TimerCallback cb = std::move(t->cb);
+        cb(make_id(e.slot, e.gen));
 
-        if (t.repeat_s > 0.0f) {
-            // Repeat: carry over overshoot to keep cadence stable-ish
-            // Example: remaining_s = -0.010 and repeat=1.0 => next in 0.990
-            float overshoot = -t.remaining_s;
-            float next = t.repeat_s - overshoot;
-            if (next < 0.0f) next = 0.0f; // if dt was huge, don't go negative
-            t.remaining_s = next;
-        } else {
-            // One-shot: deactivate
-            t.active = false;
-            t.cb = nullptr;
+        t = &g_slots[e.slot];
+        if (!t->active || t->gen != e.gen) {
+            g_stale--; // canceled during its own callback
+            continue;
         }
-    }
 
-    // Optional cleanup pass to keep vector from growing forever
-    // (cheap and safe). You can do this less often if desired.
-    if (!g_timers.empty()) {
-        size_t write = 0;
-        for (size_t read = 0; read < g_timers.size(); ++read) {
-            if (g_timers[read].active) {
-                if (write != read) g_timers[write] = std::move(g_timers[read]);
-                ++write;
-            }
+        if (t->repeat_ns > 0) {
+            // Repeat: carry over overshoot to keep cadence stable.
+            // next deadline = this deadline + repeat (e.g. 10ms late, repeat=1s => next in 0.990s).
+            // If dt was huge, don't schedule in the past; fire on the next update.
+            uint64_t next = e.deadline_ns + t->repeat_ns;
+            if (next < g_now_ns) next = g_now_ns;
+            t->cb = std::move(cb);
+            schedule(e.slot, e.gen, next);
+        } else {
+            // One-shot: retire the slot
+            release_slot(e.slot);
         }
-        g_timers.resize(write);
     }
+    g_due.clear();
+    g_updating = false;
+
+    if (g_stale > 64 && g_stale > g_live) sweep_stale();
 }
 
 } // namespace rce
@@ -0,0 +1,80 @@
+#include "gfx/dynamic_resolution.h"
+
+#include <cmath>
+
+void DynamicResolution::configure(const DynamicResolutionConfig& cfg) {
+    cfg_ = cfg;
+    if (cfg_.step <= 0.0f) cfg_.step = 0.05f;
+    if (cfg_.max_scale <= 0.0f) cfg_.max_scale = 1.0f;
+    if (cfg_.min_scale <= 0.0f || cfg_.min_scale > cfg_.max_scale) cfg_.min_scale = cfg_.max_scale;
+    if (cfg_.smoothing <= 0.0f || cfg_.smoothing > 1.0f) cfg_.smoothing = 1.0f;
+    if (cfg_.down_frames == 0) cfg_.down_frames = 1;
+    if (cfg_.up_frames == 0) cfg_.up_frames = 1;
+    reset();
+}
+
+void DynamicResolution::reset() {
+    scale_ = quantize(cfg_.max_scale);
+    filtered_ms_ = 0.0f;
+    have_sample_ = false;
+    over_count_ = under_count_ = 0;
+    hold_ = 0;
+}
+
+float DynamicResolution::quantize(float s) const {
+    // Small epsilon so 0.9 / 0.05 doesn't land on 17.999.
+    s = std::floor(s / cfg_.step + 1e-3f) * cfg_.step;
+    if (s > cfg_.max_scale) s = cfg_.max_scale;
+    if (s < cfg_.min_scale) s = cfg_.min_scale;
+    return s;
+}
+
+bool DynamicResolution::update(uint64_t cpu_ns, uint64_t gpu_ns) {
+    stats_.frames++;
+
+    const uint64_t frame_ns = cpu_ns > gpu_ns ? cpu_ns : gpu_ns;
+    const float ms = (float)((double)frame_ns * 1e-6);
+    if (!have_sample_) {
+        filtered_ms_ = ms;
+        have_sample_ = true;
+    } else {
+        filtered_ms_ += (ms - filtered_ms_) * cfg_.smoothing;
+    }
+
+    if (hold_ > 0) {
+        hold_--;
+        return false;
+    }
+
+    const float budget_ms = (float)((double)cfg_.budget_ns * 1e-6);
+    if (filtered_ms_ > budget_ms * cfg_.over) {
+        under_count_ = 0;
+        if (++over_count_ < cfg_.down_frames || scale_ <= cfg_.min_scale) return false;
+
+        // Aim a bit under budget, at least one step down.
+        float want = scale_ * std::sqrt(budget_ms * cfg_.under / filtered_ms_);
+        if (want > scale_ - cfg_.step) want = scale_ - cfg_.step;
+        const float next = quantize(want);
+        over_count_ = 0;
+        if (next >= scale_) return false;
+        scale_ = next;
+        stats_.downs++;
+    } else if (filtered_ms_ < budget_ms * cfg_.under) {
+        over_count_ = 0;
+        if (++under_count_ < cfg_.up_frames || scale_ >= cfg_.max_scale) return false;
+
+        const float next = quantize(scale_ + cfg_.step);
+        under_count_ = 0;
+        if (next <= scale_) return false;
+        scale_ = next;
+        stats_.ups++;
+    } else {
+        // Inside the band: keep the scale.
+        over_count_ = under_count_ = 0;
+        return false;
+    }
+
+    // The filter still remembers the old size; let it catch up before judging.
+    hold_ = cfg_.hold_frames;
+    return true;
+}
@@ -5,6 +5,30 @@
 
 #include <EGL/egl.h>
 #include <GLES3/gl3.h>
+#include <string.h>
+
+// GL_EXT_disjoint_timer_query (not in gl3.h).
+static constexpr GLenum kGlTimeElapsed = 0x88BF;
+static constexpr GLenum kGlGpuDisjoint = 0x8FBB;
+
+// The real GLES3 entry points, for GlStateCache. Wrapped rather than taken by
+// address, since GL_APIENTRY need not match the default calling convention.
+static GlFunctions gles3_functions() {
+    GlFunctions f;
+    f.Enable = [](unsigned int cap) { glEnable(cap); };
+    f.Disable = [](unsigned int cap) { glDisable(cap); };
+    f.Viewport = [](int x, int y, int w, int h) { glViewport(x, y, w, h); };
+    f.Scissor = [](int x, int y, int w, int h) { glScissor(x, y, w, h); };
+    f.ClearColor = [](float r, float g, float b, float a) { glClearColor(r, g, b, a); };
+    f.Clear = [](unsigned int mask) { glClear(mask); };
+    f.UseProgram = [](unsigned int p) { glUseProgram(p); };
+    f.BindBuffer = [](unsigned int target, unsigned int b) { glBindBuffer(target, b); };
+    f.ActiveTexture = [](unsigned int unit) { glActiveTexture(unit); };
+    f.BindTexture = [](unsigned int target, unsigned int t) { glBindTexture(target, t); };
+    f.BlendFunc = [](unsigned int s, unsigned int d) { glBlendFunc(s, d); };
+    f.BindVertexArray = [](unsigned int a) { glBindVertexArray(a); };
+    return f;
+}
 
 EglRenderer::~EglRenderer() {
     shutdown();
@@ -92,8 +116,16 @@ bool EglRenderer::init(void* native_window) {
     vp_w_ = width_;
     vp_h_ = height_;
 
-    glViewport(0, 0, width_, height_);
+    // Fresh context: nothing the cache remembers is true any more.
+    gl_.set_functions(gles3_functions());
+    gl_.viewport(0, 0, width_, height_);
+
+    if (!sprites_.init(&gl_)) {
+        LOGE("sprite renderer unavailable; sprite commands will be ignored");
+    }
+    init_gpu_timer();
 
+    applied_generation_ = 0;
     ready_ = true;
     LOGI("EGL ready: %dx%d", width_, height_);
     return true;
@@ -106,6 +138,12 @@ void EglRenderer::shutdown() {
     EGLSurface surf = (EGLSurface)surface_;
     EGLContext ctx = (EGLContext)context_;
 
+    sprites_.shutdown(); // needs the context still current
+    destroy_render_target();
+    if (gpu_timer_) glDeleteQueries(GPU_QUERIES, gpu_queries_);
+    gpu_timer_ = false;
+    gpu_ns_ = 0;
+
     eglMakeCurrent(dpy, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
 
     if (ctx && ctx != EGL_NO_CONTEXT) eglDestroyContext(dpy, ctx);
@@ -173,6 +211,126 @@ void EglRenderer::clear_output_rect() {
     reset_viewport();
 }
 
+void EglRenderer::init_gpu_timer() {
+    const char* ext = (const char*)glGetString(GL_EXTENSIONS);
+    gpu_timer_ = ext && strstr(ext, "GL_EXT_disjoint_timer_query") != nullptr;
+    gpu_next_ = 0;
+    gpu_ns_ = 0;
+    for (bool& p : gpu_pending_) p = false;
+    if (!gpu_timer_) {
+        LOGI("GPU timer queries unavailable; frame timing is CPU only");
+        return;
+    }
+    glGenQueries(GPU_QUERIES, gpu_queries_);
+    GLint disjoint = 0;
+    glGetIntegerv(kGlGpuDisjoint, &disjoint); // reading it clears the flag
+}
+
+void EglRenderer::collect_gpu_timer() {
+    // A disjoint event (power state change, etc.) spoils every query in flight.
+    GLint disjoint = 0;
+    glGetIntegerv(kGlGpuDisjoint, &disjoint);
+
+    // Oldest first; stop at the first one that isn't done yet.
+    for (uint32_t i = 0; i < GPU_QUERIES; i++) {
+        const uint32_t q = (gpu_next_ + i) % GPU_QUERIES;
+        if (!gpu_pending_[q]) continue;
+        GLuint available = 0;
+        glGetQueryObjectuiv(gpu_queries_[q], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) break;
+        GLuint ns = 0;
+        glGetQueryObjectuiv(gpu_queries_[q], GL_QUERY_RESULT, &ns);
+        gpu_pending_[q] = false;
+        if (!disjoint) gpu_ns_ = ns;
+    }
+}
+
+void EglRenderer::set_render_target(int w, int h, const RectI& present_rect, bool linear) {
+    if (w <= 0 || h <= 0) {
+        clear_render_target();
+        return;
+    }
+    rt_w_ = w;
+    rt_h_ = h;
+    present_rect_ = present_rect;
+    present_linear_ = linear;
+}
+
+void EglRenderer::clear_render_target() {
+    // The GL objects go at the next begin_frame (or shutdown).
+    rt_w_ = rt_h_ = 0;
+}
+
+bool EglRenderer::ensure_render_target() {
+    if (!has_render_target()) {
+        destroy_render_target();
+        return false;
+    }
+    if (rt_fbo_ && rt_alloc_w_ == rt_w_ && rt_alloc_h_ == rt_h_) return true;
+    destroy_render_target();
+
+    glGenTextures(1, &rt_tex_);
+    gl_.bind_texture(0, rt_tex_);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, rt_w_, rt_h_);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    glGenFramebuffers(1, &rt_fbo_);
+    glBindFramebuffer(GL_FRAMEBUFFER, rt_fbo_);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, rt_tex_, 0);
+    const GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        LOGE("render target %dx%d incomplete (0x%x); drawing direct", rt_w_, rt_h_, status);
+        destroy_render_target();
+        rt_w_ = rt_h_ = 0;
+        return false;
+    }
+
+    rt_alloc_w_ = rt_w_;
+    rt_alloc_h_ = rt_h_;
+    LOGI("render target %dx%d", rt_w_, rt_h_);
+    return true;
+}
+
+void EglRenderer::destroy_render_target() {
+    if (rt_fbo_) glDeleteFramebuffers(1, &rt_fbo_);
+    if (rt_tex_) glDeleteTextures(1, &rt_tex_);
+    rt_fbo_ = rt_tex_ = 0;
+    rt_alloc_w_ = rt_alloc_h_ = 0;
+}
+
+void EglRenderer::present_render_target() {
+    // Border + blit on the surface. Scissor applies to blits, so it goes off.
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, rt_fbo_);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    gl_.disable(GL_SCISSOR_TEST);
+    gl_.viewport(0, 0, width_, height_);
+    gl_.clear_color(0.f, 0.f, 0.f, 1.f);
+    gl_.clear(GL_COLOR_BUFFER_BIT);
+
+    const RectI d = present_rect_;
+    glBlitFramebuffer(0, 0, rt_alloc_w_, rt_alloc_h_, d.x, d.y, d.x + d.w, d.y + d.h,
+                      GL_COLOR_BUFFER_BIT, present_linear_ ? GL_LINEAR : GL_NEAREST);
+
+    // The target is cleared again next frame: tell tilers not to write it back.
+    const GLenum color = GL_COLOR_ATTACHMENT0;
+    glInvalidateFramebuffer(GL_READ_FRAMEBUFFER, 1, &color);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+}
+
+bool EglRenderer::apply_presentation(const PresentationResult& pr, uint32_t generation) {
+    if (generation != 0 && generation == applied_generation_) return false;
+    applied_generation_ = generation;
+
+    set_output_rect(pr.output_rect);
+    if (pr.clip_to_output) set_scissor_rect(pr.output_rect);
+    else clear_scissor();
+    set_render_target(pr.render_w, pr.render_h, pr.present_rect, pr.present_linear);
+    return true;
+}
+
 void EglRenderer::set_scissor_rect(const RectI& r) {
     scissor_rect_ = r;
     has_scissor_ = true;
@@ -183,67 +341,107 @@ void EglRenderer::clear_scissor() {
 }
 
 
-void EglRenderer::render_frame(float r, float g, float b, float a) {
-    if (!ready_) return;
+static RectI clamp_to_surface(RectI r, int width, int height) {
+    if (r.x < 0) r.x = 0;
+    if (r.y < 0) r.y = 0;
+    if (r.w < 1) r.w = 1;
+    if (r.h < 1) r.h = 1;
 
-    // ----- PASS 1: clear the full surface to a border color (black)
-    glDisable(GL_SCISSOR_TEST);
-    glViewport(0, 0, width_, height_);
-    glClearColor(0.f, 0.f, 0.f, 1.f);
-    glClear(GL_COLOR_BUFFER_BIT);
+    if (r.x + r.w > width)  r.w = width  - r.x;
+    if (r.y + r.h > height) r.h = height - r.y;
 
-    // ----- Compute the content viewport (from your existing viewport logic)
-    int vx = 0, vy = 0, vw = width_, vh = height_;
+    if (r.w < 1) r.w = 1;
+    if (r.h < 1) r.h = 1;
+    return r;
+}
 
-    if (use_custom_viewport_) {
-        vx = vp_x_;
-        vy = vp_y_;
-        vw = vp_w_;
-        vh = vp_h_;
+void EglRenderer::record_frame(RenderCommandBuffer& cmds, float r, float g, float b, float a) const {
+    if (!ready_) return;
+
+    if (has_render_target()) {
+        // Everything lands in the target; the border is drawn at present time
+        // and the blit stays inside present_rect, so no scissor is needed.
+        const uint64_t content = render_key::state(render_key::LAYER_PRESENT, 1);
+        cmds.scissor_off(content);
+        cmds.viewport(content, RectI{0, 0, rt_w_, rt_h_});
+        cmds.clear(content, r, g, b, a);
+        return;
+    }
 
-        // Clamp viewport to surface bounds
-        if (vx < 0) vx = 0;
-        if (vy < 0) vy = 0;
-        if (vw < 1) vw = 1;
-        if (vh < 1) vh = 1;
+    // ----- PASS 0: clear the full surface to a border color (black)
+    const uint64_t border = render_key::state(render_key::LAYER_PRESENT, 0);
+    cmds.scissor_off(border);
+    cmds.viewport(border, RectI{0, 0, width_, height_});
+    cmds.clear(border, 0.f, 0.f, 0.f, 1.f);
 
-        if (vx + vw > width_)  vw = width_  - vx;
-        if (vy + vh > height_) vh = height_ - vy;
+    // ----- PASS 1: content viewport, optional scissor, content color
+    const uint64_t content = render_key::state(render_key::LAYER_PRESENT, 1);
+    RectI vp{0, 0, width_, height_};
+    if (use_custom_viewport_) vp = clamp_to_surface(RectI{vp_x_, vp_y_, vp_w_, vp_h_}, width_, height_);
+    cmds.viewport(content, vp);
 
-        if (vw < 1) vw = 1;
-        if (vh < 1) vh = 1;
+    if (has_scissor_) {
+        cmds.scissor(content, clamp_to_surface(scissor_rect_, width_, height_));
     }
+    cmds.clear(content, r, g, b, a);
+}
 
-    glViewport(vx, vy, vw, vh);
+void EglRenderer::submit(RenderCommandBuffer& cmds) {
+    if (!ready_) return;
+    cmds.submit(*this);
+}
 
-    // ----- PASS 2: optionally restrict to the scissor rect, then clear content color
-    if (has_scissor_) {
-        // Clamp scissor rect too (defensive)
-        int sx = scissor_rect_.x;
-        int sy = scissor_rect_.y;
-        int sw = scissor_rect_.w;
-        int sh = scissor_rect_.h;
+void EglRenderer::begin_frame() {
+    gl_.begin_frame();
+    sprites_.begin_frame();
+    if (ensure_render_target()) glBindFramebuffer(GL_FRAMEBUFFER, rt_fbo_);
 
-        if (sx < 0) sx = 0;
-        if (sy < 0) sy = 0;
-        if (sw < 1) sw = 1;
-        if (sh < 1) sh = 1;
+    if (gpu_timer_) {
+        collect_gpu_timer();
+        // Ring full of unfinished queries: skip timing this frame rather than stall.
+        if (!gpu_pending_[gpu_next_]) glBeginQuery(kGlTimeElapsed, gpu_queries_[gpu_next_]);
+    }
+}
 
-        if (sx + sw > width_)  sw = width_  - sx;
-        if (sy + sh > height_) sh = height_ - sy;
+// Queued sprites are drawn before any state change, so order is kept.
+void EglRenderer::clear(const CmdClear& c) {
+    sprites_.flush();
+    gl_.clear_color(c.r, c.g, c.b, c.a);
+    gl_.clear(GL_COLOR_BUFFER_BIT);
+}
 
-        if (sw < 1) sw = 1;
-        if (sh < 1) sh = 1;
+void EglRenderer::viewport(const RectI& r) {
+    sprites_.flush();
+    cur_viewport_ = r;
+    gl_.viewport(r.x, r.y, r.w, r.h);
+}
 
-        glEnable(GL_SCISSOR_TEST);
-        glScissor(sx, sy, sw, sh);
+void EglRenderer::scissor(const CmdScissor& s) {
+    sprites_.flush();
+    if (s.enabled) {
+        gl_.enable(GL_SCISSOR_TEST);
+        gl_.scissor(s.rect.x, s.rect.y, s.rect.w, s.rect.h);
     } else {
-        glDisable(GL_SCISSOR_TEST);
+        gl_.disable(GL_SCISSOR_TEST);
     }
+}
 
-    glClearColor(r, g, b, a);
-    glClear(GL_COLOR_BUFFER_BIT);
+void EglRenderer::draw(const CmdDraw& d) {
+    // No generic pipelines/meshes exist yet; draws are accepted and ignored.
+    (void)d;
+}
 
-    eglSwapBuffers((EGLDisplay)display_, (EGLSurface)surface_);
+void EglRenderer::sprites(const CmdSprites& s) {
+    sprites_.add(s.sprites, s.count, cur_viewport_);
 }
 
+void EglRenderer::end_frame() {
+    sprites_.end_frame();
+    if (rt_fbo_) present_render_target();
+    if (gpu_timer_ && !gpu_pending_[gpu_next_]) {
+        glEndQuery(kGlTimeElapsed);
+        gpu_pending_[gpu_next_] = true;
+        gpu_next_ = (gpu_next_ + 1) % GPU_QUERIES;
+    }
+    eglSwapBuffers((EGLDisplay)display_, (EGLSurface)surface_);
+}
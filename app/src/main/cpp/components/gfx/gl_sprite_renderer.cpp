@@ -0,0 +1,258 @@
+#include "gfx/gl_sprite_renderer.h"
+#include "app/log.h"
+
+#include <GLES3/gl3.h>
+#include <stddef.h>
+#include <vector>
+
+static const char* kSpriteVS =
+    "#version 300 es\n"
+    "layout(location = 0) in vec2 a_pos;\n"
+    "layout(location = 1) in vec2 a_uv;\n"
+    "layout(location = 2) in vec4 a_color;\n"
+    "uniform vec2 u_scale;\n"  // 2/viewport size
+    "out vec2 v_uv;\n"
+    "out vec4 v_color;\n"
+    "void main() {\n"
+    "    v_uv = a_uv;\n"
+    "    v_color = a_color;\n"
+    "    gl_Position = vec4(a_pos.x * u_scale.x - 1.0, 1.0 - a_pos.y * u_scale.y, 0.0, 1.0);\n"
+    "}\n";
+
+static const char* kSpriteFS =
+    "#version 300 es\n"
+    "precision mediump float;\n"
+    "in vec2 v_uv;\n"
+    "in vec4 v_color;\n"
+    "uniform sampler2D u_tex;\n"
+    "out vec4 o_color;\n"
+    "void main() {\n"
+    "    o_color = texture(u_tex, v_uv) * v_color;\n"
+    "}\n";
+
+static GLuint compile_shader(GLenum type, const char* src) {
+    GLuint sh = glCreateShader(type);
+    glShaderSource(sh, 1, &src, nullptr);
+    glCompileShader(sh);
+
+    GLint ok = 0;
+    glGetShaderiv(sh, GL_COMPILE_STATUS, &ok);
+    if (!ok) {
+        char log[512];
+        glGetShaderInfoLog(sh, sizeof(log), nullptr, log);
+        LOGE("sprite shader compile failed: %s", log);
+        glDeleteShader(sh);
+        return 0;
+    }
+    return sh;
+}
+
+static GLuint link_program(const char* vs_src, const char* fs_src) {
+    GLuint vs = compile_shader(GL_VERTEX_SHADER, vs_src);
+    GLuint fs = compile_shader(GL_FRAGMENT_SHADER, fs_src);
+    if (!vs || !fs) {
+        if (vs) glDeleteShader(vs);
+        if (fs) glDeleteShader(fs);
+        return 0;
+    }
+
+    GLuint prog = glCreateProgram();
+    glAttachShader(prog, vs);
+    glAttachShader(prog, fs);
+    glLinkProgram(prog);
+    glDeleteShader(vs);
+    glDeleteShader(fs);
+
+    GLint ok = 0;
+    glGetProgramiv(prog, GL_LINK_STATUS, &ok);
+    if (!ok) {
+        char log[512];
+        glGetProgramInfoLog(prog, sizeof(log), nullptr, log);
+        LOGE("sprite program link failed: %s", log);
+        glDeleteProgram(prog);
+        return 0;
+    }
+    return prog;
+}
+
+bool GlSpriteRenderer::init(GlStateCache* gl, uint32_t max_quads_per_frame) {
+    if (is_ready()) return true;
+    gl_ = gl;
+    quads_per_frame_ = max_quads_per_frame;
+
+    program_ = link_program(kSpriteVS, kSpriteFS);
+    if (!program_) return false;
+    u_scale_ = glGetUniformLocation(program_, "u_scale");
+    u_tex_ = glGetUniformLocation(program_, "u_tex");
+    gl_->use_program(program_);
+    glUniform1i(u_tex_, 0);
+
+    // 1x1 white texture, so untextured sprites are just colored quads.
+    const uint32_t white = 0xffffffffu;
+    glGenTextures(1, &white_tex_);
+    gl_->bind_texture(0, white_tex_);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, &white);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    glGenVertexArrays(1, &vao_);
+    glGenBuffers(1, &vbo_);
+    glGenBuffers(1, &ibo_);
+
+    gl_->bind_vertex_array(vao_);
+
+    gl_->bind_buffer(GL_ARRAY_BUFFER, vbo_);
+    glBufferData(GL_ARRAY_BUFFER,
+                 (GLsizeiptr)FRAMES_IN_FLIGHT * quads_per_frame_ * SPRITE_VERTICES_PER_QUAD * sizeof(SpriteVertex),
+                 nullptr, GL_DYNAMIC_DRAW);
+
+    // One static index pattern covers every draw (draws never exceed 16-bit range).
+    const uint32_t index_quads = quads_per_frame_ < SPRITE_MAX_QUADS_PER_DRAW ? quads_per_frame_ : SPRITE_MAX_QUADS_PER_DRAW;
+    std::vector<uint16_t> indices((size_t)index_quads * SPRITE_INDICES_PER_QUAD);
+    sprite_fill_indices(indices.data(), index_quads);
+    gl_->bind_buffer(GL_ELEMENT_ARRAY_BUFFER, ibo_);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)(indices.size() * sizeof(uint16_t)), indices.data(), GL_STATIC_DRAW);
+
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+    glEnableVertexAttribArray(2);
+
+    gl_->bind_vertex_array(0);
+
+    LOGI("sprite renderer ready: %u quads/frame x %u frames", quads_per_frame_, FRAMES_IN_FLIGHT);
+    return true;
+}
+
+void GlSpriteRenderer::shutdown() {
+    if (!is_ready()) return;
+    if (mapped_) {
+        gl_->bind_buffer(GL_ARRAY_BUFFER, vbo_);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        mapped_ = false;
+    }
+    for (void*& f : fences_) {
+        if (f) glDeleteSync((GLsync)f);
+        f = nullptr;
+    }
+    glDeleteBuffers(1, &ibo_);
+    glDeleteBuffers(1, &vbo_);
+    glDeleteVertexArrays(1, &vao_);
+    glDeleteTextures(1, &white_tex_);
+    glDeleteProgram(program_);
+    ibo_ = vbo_ = vao_ = white_tex_ = program_ = 0;
+    gl_->invalidate();
+}
+
+void GlSpriteRenderer::begin_frame() {
+    if (!is_ready()) return;
+    region_ = (region_ + 1) % FRAMES_IN_FLIGHT;
+    region_used_ = 0;
+    batcher_.begin_frame();
+
+    // The GPU may still be reading this region from FRAMES_IN_FLIGHT frames ago.
+    if (void* f = fences_[region_]) {
+        const GLenum r = glClientWaitSync((GLsync)f, GL_SYNC_FLUSH_COMMANDS_BIT, 100000000ull);
+        if (r == GL_TIMEOUT_EXPIRED || r == GL_WAIT_FAILED) LOGE("sprite ring: fence wait failed (0x%x)", r);
+        glDeleteSync((GLsync)f);
+        fences_[region_] = nullptr;
+    }
+}
+
+bool GlSpriteRenderer::map_block() {
+    const uint32_t left = quads_per_frame_ - region_used_;
+    if (left == 0) return false;
+    const uint32_t block = left < SPRITE_MAX_QUADS_PER_DRAW ? left : SPRITE_MAX_QUADS_PER_DRAW;
+
+    const size_t quad_bytes = SPRITE_VERTICES_PER_QUAD * sizeof(SpriteVertex);
+    const size_t offset = ((size_t)region_ * quads_per_frame_ + region_used_) * quad_bytes;
+
+    gl_->bind_buffer(GL_ARRAY_BUFFER, vbo_);
+    void* ptr = glMapBufferRange(GL_ARRAY_BUFFER, (GLintptr)offset, (GLsizeiptr)(block * quad_bytes),
+                                 GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+    if (!ptr) {
+        LOGE("sprite ring: glMapBufferRange failed (0x%x)", glGetError());
+        return false;
+    }
+
+    batcher_.begin(static_cast<SpriteVertex*>(ptr), block);
+    block_first_quad_ = region_used_;
+    mapped_ = true;
+    return true;
+}
+
+void GlSpriteRenderer::add(const Sprite* sprites, uint32_t count, const RectI& viewport) {
+    if (!is_ready()) return;
+
+    if (viewport.x != viewport_.x || viewport.y != viewport_.y ||
+        viewport.w != viewport_.w || viewport.h != viewport_.h) {
+        flush();
+        viewport_ = viewport;
+    }
+
+    while (count > 0) {
+        if (!mapped_ && !map_block()) {
+            batcher_.stats().dropped += count;
+            return;
+        }
+        const uint32_t n = batcher_.add(sprites, count);
+        sprites += n;
+        count -= n;
+        if (count > 0) flush(); // block full
+    }
+}
+
+void GlSpriteRenderer::flush() {
+    if (!mapped_) return;
+    mapped_ = false;
+
+    gl_->bind_buffer(GL_ARRAY_BUFFER, vbo_);
+    if (!glUnmapBuffer(GL_ARRAY_BUFFER)) {
+        // Contents were lost (rare, e.g. display mode change): skip this block.
+        LOGE("sprite ring: buffer contents lost");
+        return;
+    }
+
+    const uint32_t quads = batcher_.quad_count();
+    if (quads == 0) return;
+    region_used_ += quads;
+
+    // No base-vertex draws in ES 3.0: point the attributes at the block instead.
+    const size_t base = ((size_t)region_ * quads_per_frame_ + block_first_quad_)
+                      * SPRITE_VERTICES_PER_QUAD * sizeof(SpriteVertex);
+    const GLsizei stride = sizeof(SpriteVertex);
+    gl_->bind_vertex_array(vao_);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, (const void*)(base + offsetof(SpriteVertex, x)));
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, (const void*)(base + offsetof(SpriteVertex, u)));
+    glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, (const void*)(base + offsetof(SpriteVertex, color)));
+
+    gl_->enable(GL_BLEND);
+    gl_->blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    const float sx = viewport_.w > 0 ? 2.0f / (float)viewport_.w : 0.0f;
+    const float sy = viewport_.h > 0 ? 2.0f / (float)viewport_.h : 0.0f;
+    unsigned int scaled_program = 0;
+
+    for (uint32_t i = 0; i < batcher_.batch_count(); i++) {
+        const SpriteBatch& b = batcher_.batches()[i];
+        const unsigned int prog = b.shader ? b.shader : program_;
+        gl_->use_program(prog);
+        if (prog != scaled_program) {
+            const GLint loc = prog == program_ ? u_scale_ : glGetUniformLocation(prog, "u_scale");
+            glUniform2f(loc, sx, sy);
+            scaled_program = prog;
+        }
+        gl_->bind_texture(0, b.texture ? b.texture : white_tex_);
+        glDrawElements(GL_TRIANGLES, (GLsizei)(b.quad_count * SPRITE_INDICES_PER_QUAD), GL_UNSIGNED_SHORT,
+                       (const void*)((size_t)b.first_quad * SPRITE_INDICES_PER_QUAD * sizeof(uint16_t)));
+        batcher_.stats().draw_calls++;
+    }
+}
+
+void GlSpriteRenderer::end_frame() {
+    if (!is_ready()) return;
+    flush();
+    if (region_used_ > 0) {
+        fences_[region_] = (void*)glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+    last_stats_ = batcher_.stats();
+}
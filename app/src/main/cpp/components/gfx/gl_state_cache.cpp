@@ -0,0 +1,137 @@
+#include "gfx/gl_state_cache.h"
+
+void GlStateCache::invalidate() {
+    for (Tri& c : caps_) c = Unknown;
+    viewport_valid_ = false;
+    scissor_valid_ = false;
+    clear_color_valid_ = false;
+    program_valid_ = false;
+    array_buffer_valid_ = false;
+    element_buffer_valid_ = false;
+    active_unit_valid_ = false;
+    for (bool& t : texture_valid_) t = false;
+    vao_valid_ = false;
+    blend_valid_ = false;
+}
+
+int GlStateCache::cap_index(unsigned int cap) {
+    switch (cap) {
+        case SCISSOR_TEST: return CAP_SCISSOR;
+        case BLEND:        return CAP_BLEND;
+        case DEPTH_TEST:   return CAP_DEPTH;
+        case CULL_FACE:    return CAP_CULL;
+    }
+    return -1;
+}
+
+void GlStateCache::set_cap(unsigned int cap, bool on) {
+    const int i = cap_index(cap);
+    if (i >= 0) {
+        const Tri want = on ? On : Off;
+        if (caps_[i] == want) { skipped(); return; }
+        caps_[i] = want;
+    }
+    issued();
+    if (on) gl_.Enable(cap);
+    else    gl_.Disable(cap);
+}
+
+void GlStateCache::enable(unsigned int cap) { set_cap(cap, true); }
+void GlStateCache::disable(unsigned int cap) { set_cap(cap, false); }
+
+void GlStateCache::viewport(int x, int y, int w, int h) {
+    if (viewport_valid_ && viewport_[0] == x && viewport_[1] == y && viewport_[2] == w && viewport_[3] == h) {
+        skipped();
+        return;
+    }
+    viewport_valid_ = true;
+    viewport_[0] = x; viewport_[1] = y; viewport_[2] = w; viewport_[3] = h;
+    issued();
+    gl_.Viewport(x, y, w, h);
+}
+
+void GlStateCache::scissor(int x, int y, int w, int h) {
+    if (scissor_valid_ && scissor_[0] == x && scissor_[1] == y && scissor_[2] == w && scissor_[3] == h) {
+        skipped();
+        return;
+    }
+    scissor_valid_ = true;
+    scissor_[0] = x; scissor_[1] = y; scissor_[2] = w; scissor_[3] = h;
+    issued();
+    gl_.Scissor(x, y, w, h);
+}
+
+void GlStateCache::clear_color(float r, float g, float b, float a) {
+    // Exact compare on purpose: any change, however small, must reach GL.
+    if (clear_color_valid_ && clear_color_[0] == r && clear_color_[1] == g &&
+        clear_color_[2] == b && clear_color_[3] == a) {
+        skipped();
+        return;
+    }
+    clear_color_valid_ = true;
+    clear_color_[0] = r; clear_color_[1] = g; clear_color_[2] = b; clear_color_[3] = a;
+    issued();
+    gl_.ClearColor(r, g, b, a);
+}
+
+void GlStateCache::clear(unsigned int mask) {
+    issued();
+    gl_.Clear(mask);
+}
+
+void GlStateCache::use_program(unsigned int program) {
+    if (program_valid_ && program_ == program) { skipped(); return; }
+    program_valid_ = true;
+    program_ = program;
+    issued();
+    gl_.UseProgram(program);
+}
+
+void GlStateCache::bind_buffer(unsigned int target, unsigned int buffer) {
+    bool* valid = nullptr;
+    unsigned int* bound = nullptr;
+    if (target == ARRAY_BUFFER)              { valid = &array_buffer_valid_;   bound = &array_buffer_; }
+    else if (target == ELEMENT_ARRAY_BUFFER) { valid = &element_buffer_valid_; bound = &element_buffer_; }
+
+    if (valid) {
+        if (*valid && *bound == buffer) { skipped(); return; }
+        *valid = true;
+        *bound = buffer;
+    }
+    issued();
+    gl_.BindBuffer(target, buffer);
+}
+
+void GlStateCache::bind_texture(uint32_t unit, unsigned int texture) {
+    if (unit >= MAX_TEXTURE_UNITS) return;
+    if (texture_valid_[unit] && texture_[unit] == texture) { skipped(); return; }
+
+    if (!active_unit_valid_ || active_unit_ != unit) {
+        active_unit_valid_ = true;
+        active_unit_ = unit;
+        issued();
+        gl_.ActiveTexture(TEXTURE0 + unit);
+    }
+    texture_valid_[unit] = true;
+    texture_[unit] = texture;
+    issued();
+    gl_.BindTexture(TEXTURE_2D, texture);
+}
+
+void GlStateCache::blend_func(unsigned int sfactor, unsigned int dfactor) {
+    if (blend_valid_ && blend_src_ == sfactor && blend_dst_ == dfactor) { skipped(); return; }
+    blend_valid_ = true;
+    blend_src_ = sfactor;
+    blend_dst_ = dfactor;
+    issued();
+    gl_.BlendFunc(sfactor, dfactor);
+}
+
+void GlStateCache::bind_vertex_array(unsigned int array) {
+    if (vao_valid_ && vao_ == array) { skipped(); return; }
+    vao_valid_ = true;
+    vao_ = array;
+    element_buffer_valid_ = false;
+    issued();
+    gl_.BindVertexArray(array);
+}
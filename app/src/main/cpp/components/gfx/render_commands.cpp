@@ -0,0 +1,154 @@
+#include "gfx/render_commands.h"
+#include "gfx/sprite_batch.h"
+
+#include <string.h>
+#include <new>
+
+// ---------------- FrameArena ----------------
+
+void* FrameArena::alloc(size_t size, size_t align) {
+    if (size > chunk_bytes_) return nullptr; // commands are small; never happens in practice
+
+    for (;;) {
+        if (chunk_ < chunks_.size()) {
+            const size_t start = (offset_ + align - 1) & ~(align - 1);
+            if (start + size <= chunk_bytes_) {
+                offset_ = start + size;
+                used_ += size;
+                return chunks_[chunk_].get() + start;
+            }
+            chunk_++;
+            offset_ = 0;
+            continue;
+        }
+        // Warm-up only: reset() keeps every chunk for the next frame.
+        chunks_.emplace_back(new unsigned char[chunk_bytes_]);
+        chunk_ = chunks_.size() - 1;
+        offset_ = 0;
+    }
+}
+
+void FrameArena::reset() {
+    chunk_ = 0;
+    offset_ = 0;
+    used_ = 0;
+}
+
+// ---------------- RenderCommandBuffer ----------------
+
+void RenderCommandBuffer::reset() {
+    arena_.reset();
+    entries_.clear();
+    sorted_ = true;
+    stats_ = RenderCmdStats{};
+}
+
+template <typename T>
+void RenderCommandBuffer::push(uint64_t key, RenderCmdType type, const T& cmd) {
+    void* mem = arena_.alloc(sizeof(Slot<T>), alignof(Slot<T>));
+    if (!mem) return;
+    const Slot<T>* stored = new (mem) Slot<T>{ type, cmd };
+
+    if (!entries_.empty() && key < entries_.back().key) sorted_ = false;
+    entries_.push_back(Entry{ key, stored });
+
+    stats_.commands++;
+    if (type == RenderCmdType::Draw) stats_.draws++;
+    stats_.arena_bytes = arena_.used_bytes();
+}
+
+void RenderCommandBuffer::clear(uint64_t key, float r, float g, float b, float a) {
+    push(key, RenderCmdType::Clear, CmdClear{ r, g, b, a });
+}
+
+void RenderCommandBuffer::viewport(uint64_t key, const RectI& r) {
+    push(key, RenderCmdType::Viewport, r);
+}
+
+void RenderCommandBuffer::scissor(uint64_t key, const RectI& r) {
+    push(key, RenderCmdType::Scissor, CmdScissor{ true, r });
+}
+
+void RenderCommandBuffer::scissor_off(uint64_t key) {
+    push(key, RenderCmdType::Scissor, CmdScissor{ false, RectI{} });
+}
+
+void RenderCommandBuffer::draw(uint64_t key, const CmdDraw& d) {
+    push(key, RenderCmdType::Draw, d);
+}
+
+void RenderCommandBuffer::sprites(uint64_t key, const Sprite* sprites, uint32_t count) {
+    // Arena allocations can't span chunks: split into chunk-sized commands
+    // (same key, so they stay adjacent and in order).
+    const uint32_t per_cmd = (uint32_t)((arena_.chunk_bytes() - 64) / sizeof(Sprite));
+    while (count > 0) {
+        const uint32_t n = count < per_cmd ? count : per_cmd;
+        Sprite* copy = static_cast<Sprite*>(arena_.alloc(n * sizeof(Sprite), alignof(Sprite)));
+        if (!copy) return;
+        memcpy(copy, sprites, n * sizeof(Sprite));
+        push(key, RenderCmdType::Sprites, CmdSprites{ copy, n });
+        stats_.sprites += n;
+        sprites += n;
+        count -= n;
+    }
+}
+
+// LSD radix sort, 8 bits per pass. Passes where every key has the same digit
+// are skipped, so typical frames (few layers/passes, small depth range) only
+// pay for the bytes that actually vary.
+void RenderCommandBuffer::sort() {
+    if (sorted_) return;
+    sorted_ = true;
+    if (entries_.size() < 2) return;
+
+    const size_t n = entries_.size();
+    scratch_.resize(n);
+
+    Entry* src = entries_.data();
+    Entry* dst = scratch_.data();
+
+    // All eight histograms in one read over the keys.
+    uint32_t hist[8][256];
+    memset(hist, 0, sizeof(hist));
+    for (size_t i = 0; i < n; i++) {
+        const uint64_t k = src[i].key;
+        for (uint32_t p = 0; p < 8; p++) hist[p][(k >> (p * 8)) & 0xff]++;
+    }
+
+    for (uint32_t p = 0; p < 8; p++) {
+        uint32_t* h = hist[p];
+        const uint32_t digit0 = (uint32_t)(src[0].key >> (p * 8)) & 0xff;
+        if (h[digit0] == n) continue; // nothing to reorder on this byte
+
+        uint32_t sum = 0;
+        for (uint32_t d = 0; d < 256; d++) {
+            const uint32_t c = h[d];
+            h[d] = sum;
+            sum += c;
+        }
+        const uint32_t shift = p * 8;
+        for (size_t i = 0; i < n; i++) {
+            dst[h[(src[i].key >> shift) & 0xff]++] = src[i];
+        }
+        Entry* t = src; src = dst; dst = t;
+        stats_.sort_passes++;
+    }
+
+    if (src != entries_.data()) entries_.swap(scratch_);
+}
+
+void RenderCommandBuffer::submit(RenderBackend& backend) {
+    sort();
+
+    backend.begin_frame();
+    for (const Entry& e : entries_) {
+        switch (type_of(e)) {
+            case RenderCmdType::Clear:    backend.clear(payload<CmdClear>(e)); break;
+            case RenderCmdType::Viewport: backend.viewport(payload<RectI>(e)); break;
+            case RenderCmdType::Scissor:  backend.scissor(payload<CmdScissor>(e)); break;
+            case RenderCmdType::Draw:     backend.draw(payload<CmdDraw>(e)); break;
+            case RenderCmdType::Sprites:  backend.sprites(payload<CmdSprites>(e)); break;
+        }
+    }
+    backend.end_frame();
+}
@@ -0,0 +1,85 @@
+#include "gfx/render_scale.h"
+
+int scale_integer_factor(int src_w, int src_h, int dst_w, int dst_h) {
+    if (src_w <= 0 || src_h <= 0 || dst_w <= 0 || dst_h <= 0) return 0;
+    const int kx = dst_w / src_w;
+    const int ky = dst_h / src_h;
+    return kx < ky ? kx : ky;
+}
+
+// Aspect fit in integers: the limiting axis gets exactly dst, the other one is
+// rounded to nearest (never past dst).
+static void fit_size(int src_w, int src_h, int dst_w, int dst_h, int* w, int* h) {
+    if ((int64_t)dst_w * src_h <= (int64_t)dst_h * src_w) {
+        *w = dst_w;
+        *h = (int)(((int64_t)src_h * dst_w + src_w / 2) / src_w);
+        if (*h > dst_h) *h = dst_h;
+    } else {
+        *h = dst_h;
+        *w = (int)(((int64_t)src_w * dst_h + src_h / 2) / src_h);
+        if (*w > dst_w) *w = dst_w;
+    }
+    if (*w < 1) *w = 1;
+    if (*h < 1) *h = 1;
+}
+
+RectI scale_place(int src_w, int src_h, const RectI& output, ScalePolicy policy, float* scale_out) {
+    if (scale_out) *scale_out = 0.0f;
+    if (src_w <= 0 || src_h <= 0 || output.w <= 0 || output.h <= 0) return RectI{ output.x, output.y, 0, 0 };
+
+    int w = 0, h = 0;
+    float scale = 0.0f;
+    const int k = policy == ScalePolicy::Integer ? scale_integer_factor(src_w, src_h, output.w, output.h) : 0;
+    if (k > 0) {
+        w = src_w * k;
+        h = src_h * k;
+        scale = (float)k;
+    } else {
+        fit_size(src_w, src_h, output.w, output.h, &w, &h);
+        // Report the limiting axis' scale (the other one is rounded to it).
+        const float sx = (float)w / (float)src_w;
+        const float sy = (float)h / (float)src_h;
+        scale = sx < sy ? sx : sy;
+    }
+
+    if (scale_out) *scale_out = scale;
+    return RectI{ output.x + (output.w - w) / 2, output.y + (output.h - h) / 2, w, h };
+}
+
+void apply_render_target(PresentationResult& res, const RenderTargetConfig& cfg, float render_scale) {
+    if (!(render_scale > 0.0f) || render_scale > 1.0f) render_scale = 1.0f;
+
+    if (!cfg.enabled() && render_scale >= 1.0f) {
+        res.render_w = res.render_h = 0;
+        res.present_rect = res.output_rect;
+        res.present_scale = 1.0f;
+        res.present_linear = false;
+        return;
+    }
+
+    // Placement comes from the configured size (or the output rect itself), so
+    // it stays put while dynamic resolution moves the render size underneath.
+    int base_w = res.output_rect.w, base_h = res.output_rect.h;
+    if (cfg.enabled()) {
+        base_w = cfg.width;
+        base_h = cfg.height;
+        res.present_rect = scale_place(base_w, base_h, res.output_rect, cfg.policy);
+    } else {
+        res.present_rect = res.output_rect;
+    }
+
+    res.render_w = (int)((float)base_w * render_scale + 0.5f);
+    res.render_h = (int)((float)base_h * render_scale + 0.5f);
+    if (res.render_w < 1) res.render_w = 1;
+    if (res.render_h < 1) res.render_h = 1;
+
+    const RectI& d = res.present_rect;
+    const float sx = (float)d.w / (float)res.render_w;
+    const float sy = (float)d.h / (float)res.render_h;
+    res.present_scale = sx < sy ? sx : sy;
+
+    // Nearest is only exact for the same whole-number factor on both axes.
+    const bool whole = d.w >= res.render_w && d.w % res.render_w == 0 && d.h % res.render_h == 0 &&
+                       d.w / res.render_w == d.h / res.render_h;
+    res.present_linear = !whole;
+}
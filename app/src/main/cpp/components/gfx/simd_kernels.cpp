@@ -0,0 +1,427 @@
+#include "gfx/simd_kernels.h"
+#include "gfx/sprite_batch.h"
+
+#include <cmath>
+#include <string.h>
+
+#if !defined(RCE_SIMD_SCALAR) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#define RCE_SIMD_NEON 1
+#include <arm_neon.h>
+#elif !defined(RCE_SIMD_SCALAR) && (defined(__SSE2__) || defined(_M_X64))
+#define RCE_SIMD_SSE2 1
+#include <emmintrin.h>
+#endif
+
+const char* simd_backend_name() {
+#if defined(RCE_SIMD_NEON)
+    return "neon";
+#elif defined(RCE_SIMD_SSE2)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+// =================================
+// Scalar reference
+// =================================
+
+static inline float clamp01(float x) {
+    if (!(x > 0.0f)) x = 0.0f; // NaN -> 0, like the vector paths
+    if (x > 1.0f) x = 1.0f;
+    return x;
+}
+
+void simd_quad_corners_scalar(const QuadCornersSoA& in, uint32_t count, SpriteVertex* out) {
+    for (uint32_t i = 0; i < count; i++) {
+        const float ax0 = in.m00[i] * in.x0[i], ax1 = in.m00[i] * in.x1[i];
+        const float by0 = in.m01[i] * in.y0[i] + in.tx[i], by1 = in.m01[i] * in.y1[i] + in.tx[i];
+        const float cx0 = in.m10[i] * in.x0[i], cx1 = in.m10[i] * in.x1[i];
+        const float dy0 = in.m11[i] * in.y0[i] + in.ty[i], dy1 = in.m11[i] * in.y1[i] + in.ty[i];
+
+        SpriteVertex* v = out + i * SPRITE_VERTICES_PER_QUAD;
+        v[0].x = ax0 + by0; v[0].y = cx0 + dy0;
+        v[1].x = ax1 + by0; v[1].y = cx1 + dy0;
+        v[2].x = ax1 + by1; v[2].y = cx1 + dy1;
+        v[3].x = ax0 + by1; v[3].y = cx0 + dy1;
+    }
+}
+
+// Cephes sinf/cosf: reduce to |x| <= pi/4 around a multiple j of pi/4 (j even,
+// pi/4 split in three parts for precision), then one polynomial per function.
+static constexpr float kFourOverPi = 1.27323954473516f;
+static constexpr float kDP1 = 0.78515625f;
+static constexpr float kDP2 = 2.4187564849853515625e-4f;
+static constexpr float kDP3 = 3.77489497744594108e-8f;
+static constexpr float kSin0 = -1.9515295891e-4f, kSin1 = 8.3321608736e-3f, kSin2 = -1.6666654611e-1f;
+static constexpr float kCos0 = 2.443315711809948e-5f, kCos1 = -1.388731625493765e-3f, kCos2 = 4.166664568298827e-2f;
+
+static inline uint32_t float_bits(float x) { uint32_t u; memcpy(&u, &x, sizeof(u)); return u; }
+static inline float bits_float(uint32_t u) { float x; memcpy(&x, &u, sizeof(x)); return x; }
+
+void simd_sincos_scalar(const float* angle, uint32_t count, float* s, float* c) {
+    for (uint32_t i = 0; i < count; i++) {
+        const uint32_t sign = float_bits(angle[i]) & 0x80000000u;
+        float x = std::fabs(angle[i]);
+        int32_t j = (int32_t)(x * kFourOverPi);
+        j = (j + 1) & ~1;
+        const float y = (float)j;
+        x = ((x - y * kDP1) - y * kDP2) - y * kDP3;
+
+        const float z = x * x;
+        const float pc = ((kCos0 * z + kCos1) * z + kCos2) * z * z - 0.5f * z + 1.0f;
+        const float ps = ((kSin0 * z + kSin1) * z + kSin2) * z * x + x;
+
+        // Octants 2,3 (mod 4) swap the polynomials; the signs follow the quadrant.
+        const bool swap = (j & 2) != 0;
+        const uint32_t sin_sign = sign ^ ((uint32_t)(j & 4) << 29);
+        const uint32_t cos_sign = (uint32_t)(~(j - 2) & 4) << 29;
+        s[i] = bits_float(float_bits(swap ? pc : ps) ^ sin_sign);
+        c[i] = bits_float(float_bits(swap ? ps : pc) ^ cos_sign);
+    }
+}
+
+void simd_pack_rgba8_scalar(const float* r, const float* g, const float* b, const float* a,
+                            uint32_t count, uint32_t* out) {
+    for (uint32_t i = 0; i < count; i++) {
+        const uint32_t cr = (uint32_t)(clamp01(r[i]) * 255.0f + 0.5f);
+        const uint32_t cg = (uint32_t)(clamp01(g[i]) * 255.0f + 0.5f);
+        const uint32_t cb = (uint32_t)(clamp01(b[i]) * 255.0f + 0.5f);
+        const uint32_t ca = (uint32_t)(clamp01(a[i]) * 255.0f + 0.5f);
+        out[i] = cr | (cg << 8) | (cb << 16) | (ca << 24);
+    }
+}
+
+// Branch-free form: channel(n) = v - v*s*clamp(min(k, 4-k), 0, 1), k = (n + 6h) mod 6,
+// with n = 5, 3, 1 for r, g, b. Same steps as the vector version.
+static inline float hsv_channel(float n, float h6, float vs, float v) {
+    float k = n + h6;
+    if (k >= 6.0f) k -= 6.0f;
+    float f = 4.0f - k < k ? 4.0f - k : k;
+    if (f < 0.0f) f = 0.0f;
+    if (f > 1.0f) f = 1.0f;
+    return v - vs * f;
+}
+
+void simd_hsv_to_rgb_scalar(const float* h, const float* s, const float* v, uint32_t count,
+                            float* r, float* g, float* b) {
+    for (uint32_t i = 0; i < count; i++) {
+        float t = (float)(int32_t)h[i]; // floor, the way the vector paths do it
+        if (t > h[i]) t -= 1.0f;
+        const float h6 = (h[i] - t) * 6.0f;
+        const float vs = v[i] * s[i];
+        r[i] = hsv_channel(5.0f, h6, vs, v[i]);
+        g[i] = hsv_channel(3.0f, h6, vs, v[i]);
+        b[i] = hsv_channel(1.0f, h6, vs, v[i]);
+    }
+}
+
+void simd_rgb_to_hsv_scalar(const float* r, const float* g, const float* b, uint32_t count,
+                            float* h, float* s, float* v) {
+    for (uint32_t i = 0; i < count; i++) {
+        const float mx = std::fmax(std::fmax(r[i], g[i]), b[i]);
+        const float mn = std::fmin(std::fmin(r[i], g[i]), b[i]);
+        const float c = mx - mn;
+
+        float hue = 0.0f;
+        if (c > 0.0f) {
+            const float ic = 1.0f / c;
+            if (mx == r[i]) {
+                hue = (g[i] - b[i]) * ic;
+                if (hue < 0.0f) hue += 6.0f;
+            } else if (mx == g[i]) {
+                hue = (b[i] - r[i]) * ic + 2.0f;
+            } else {
+                hue = (r[i] - g[i]) * ic + 4.0f;
+            }
+        }
+        h[i] = hue * (1.0f / 6.0f);
+        s[i] = mx > 0.0f ? c / mx : 0.0f;
+        v[i] = mx;
+    }
+}
+
+// =================================
+// 4-wide vector paths
+// =================================
+// A thin layer over NEON / SSE2 so each kernel is written once below.
+
+#if defined(RCE_SIMD_NEON) || defined(RCE_SIMD_SSE2)
+
+#if defined(RCE_SIMD_NEON)
+
+typedef float32x4_t vf;
+typedef uint32x4_t vm; // lane masks
+
+static inline vf v_load(const float* p) { return vld1q_f32(p); }
+static inline void v_store(float* p, vf a) { vst1q_f32(p, a); }
+static inline vf v_set(float x) { return vdupq_n_f32(x); }
+static inline vf v_add(vf a, vf b) { return vaddq_f32(a, b); }
+static inline vf v_sub(vf a, vf b) { return vsubq_f32(a, b); }
+static inline vf v_mul(vf a, vf b) { return vmulq_f32(a, b); }
+static inline vf v_min(vf a, vf b) { return vminq_f32(a, b); }
+static inline vf v_max(vf a, vf b) { return vmaxq_f32(a, b); }
+static inline vf v_div(vf a, vf b) {
+#if defined(__aarch64__)
+    return vdivq_f32(a, b);
+#else
+    // ARMv7 has no vector divide: reciprocal estimate + two Newton steps.
+    vf r = vrecpeq_f32(b);
+    r = vmulq_f32(vrecpsq_f32(b, r), r);
+    r = vmulq_f32(vrecpsq_f32(b, r), r);
+    return vmulq_f32(a, r);
+#endif
+}
+static inline vm v_lt(vf a, vf b) { return vcltq_f32(a, b); }
+static inline vm v_ge(vf a, vf b) { return vcgeq_f32(a, b); }
+static inline vm v_gt(vf a, vf b) { return vcgtq_f32(a, b); }
+static inline vm v_eq(vf a, vf b) { return vceqq_f32(a, b); }
+static inline vm m_andnot(vm a, vm b) { return vbicq_u32(b, a); } // ~a & b
+static inline vf v_and(vm m, vf a) { return vreinterpretq_f32_u32(vandq_u32(m, vreinterpretq_u32_f32(a))); }
+static inline vf v_sel(vm m, vf a, vf b) { return vbslq_f32(m, a, b); }
+static inline vf v_trunc(vf a) { return vcvtq_f32_s32(vcvtq_s32_f32(a)); }
+static inline vf v_abs(vf a) { return vabsq_f32(a); }
+
+typedef int32x4_t vi;
+
+static inline vi vi_set(int32_t x) { return vdupq_n_s32(x); }
+static inline vi vi_add(vi a, vi b) { return vaddq_s32(a, b); }
+static inline vi vi_sub(vi a, vi b) { return vsubq_s32(a, b); }
+static inline vi vi_and(vi a, vi b) { return vandq_s32(a, b); }
+static inline vi vi_xor(vi a, vi b) { return veorq_s32(a, b); }
+static inline vi vi_shl29(vi a) { return vshlq_n_s32(a, 29); }
+static inline vm vi_eq(vi a, vi b) { return vceqq_s32(a, b); }
+static inline vi vi_cvtt(vf a) { return vcvtq_s32_f32(a); }
+static inline vf vi_tof(vi a) { return vcvtq_f32_s32(a); }
+static inline vi v_bits(vf a) { return vreinterpretq_s32_f32(a); }
+static inline vf v_from_bits(vi a) { return vreinterpretq_f32_s32(a); }
+
+// Lane i of x/y -> (x, y) of vertex i * SPRITE_VERTICES_PER_QUAD.
+static inline void v_store_xy(SpriteVertex* v, vf x, vf y) {
+    const float32x4x2_t z = vzipq_f32(x, y);
+    vst1_f32(&v[0 * SPRITE_VERTICES_PER_QUAD].x, vget_low_f32(z.val[0]));
+    vst1_f32(&v[1 * SPRITE_VERTICES_PER_QUAD].x, vget_high_f32(z.val[0]));
+    vst1_f32(&v[2 * SPRITE_VERTICES_PER_QUAD].x, vget_low_f32(z.val[1]));
+    vst1_f32(&v[3 * SPRITE_VERTICES_PER_QUAD].x, vget_high_f32(z.val[1]));
+}
+
+static inline void v_pack_rgba8(uint32_t* out, vf r, vf g, vf b, vf a) {
+    // vcvtq_u32_f32 truncates, like the scalar cast.
+    const uint32x4_t cr = vcvtq_u32_f32(r), cg = vcvtq_u32_f32(g);
+    const uint32x4_t cb = vcvtq_u32_f32(b), ca = vcvtq_u32_f32(a);
+    uint32x4_t c = vorrq_u32(cr, vshlq_n_u32(cg, 8));
+    c = vorrq_u32(c, vshlq_n_u32(cb, 16));
+    c = vorrq_u32(c, vshlq_n_u32(ca, 24));
+    vst1q_u32(out, c);
+}
+
+#else // SSE2
+
+typedef __m128 vf;
+typedef __m128 vm;
+
+static inline vf v_load(const float* p) { return _mm_loadu_ps(p); }
+static inline void v_store(float* p, vf a) { _mm_storeu_ps(p, a); }
+static inline vf v_set(float x) { return _mm_set1_ps(x); }
+static inline vf v_add(vf a, vf b) { return _mm_add_ps(a, b); }
+static inline vf v_sub(vf a, vf b) { return _mm_sub_ps(a, b); }
+static inline vf v_mul(vf a, vf b) { return _mm_mul_ps(a, b); }
+static inline vf v_min(vf a, vf b) { return _mm_min_ps(a, b); }
+static inline vf v_max(vf a, vf b) { return _mm_max_ps(a, b); }
+static inline vf v_div(vf a, vf b) { return _mm_div_ps(a, b); }
+static inline vm v_lt(vf a, vf b) { return _mm_cmplt_ps(a, b); }
+static inline vm v_ge(vf a, vf b) { return _mm_cmpge_ps(a, b); }
+static inline vm v_gt(vf a, vf b) { return _mm_cmpgt_ps(a, b); }
+static inline vm v_eq(vf a, vf b) { return _mm_cmpeq_ps(a, b); }
+static inline vm m_andnot(vm a, vm b) { return _mm_andnot_ps(a, b); } // ~a & b
+static inline vf v_and(vm m, vf a) { return _mm_and_ps(m, a); }
+static inline vf v_sel(vm m, vf a, vf b) { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+static inline vf v_trunc(vf a) { return _mm_cvtepi32_ps(_mm_cvttps_epi32(a)); }
+static inline vf v_abs(vf a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+
+typedef __m128i vi;
+
+static inline vi vi_set(int32_t x) { return _mm_set1_epi32(x); }
+static inline vi vi_add(vi a, vi b) { return _mm_add_epi32(a, b); }
+static inline vi vi_sub(vi a, vi b) { return _mm_sub_epi32(a, b); }
+static inline vi vi_and(vi a, vi b) { return _mm_and_si128(a, b); }
+static inline vi vi_xor(vi a, vi b) { return _mm_xor_si128(a, b); }
+static inline vi vi_shl29(vi a) { return _mm_slli_epi32(a, 29); }
+static inline vm vi_eq(vi a, vi b) { return _mm_castsi128_ps(_mm_cmpeq_epi32(a, b)); }
+static inline vi vi_cvtt(vf a) { return _mm_cvttps_epi32(a); }
+static inline vf vi_tof(vi a) { return _mm_cvtepi32_ps(a); }
+static inline vi v_bits(vf a) { return _mm_castps_si128(a); }
+static inline vf v_from_bits(vi a) { return _mm_castsi128_ps(a); }
+
+static inline void v_store_xy(SpriteVertex* v, vf x, vf y) {
+    const __m128 lo = _mm_unpacklo_ps(x, y); // x0 y0 x1 y1
+    const __m128 hi = _mm_unpackhi_ps(x, y); // x2 y2 x3 y3
+    _mm_storel_pi((__m64*)&v[0 * SPRITE_VERTICES_PER_QUAD].x, lo);
+    _mm_storeh_pi((__m64*)&v[1 * SPRITE_VERTICES_PER_QUAD].x, lo);
+    _mm_storel_pi((__m64*)&v[2 * SPRITE_VERTICES_PER_QUAD].x, hi);
+    _mm_storeh_pi((__m64*)&v[3 * SPRITE_VERTICES_PER_QUAD].x, hi);
+}
+
+static inline void v_pack_rgba8(uint32_t* out, vf r, vf g, vf b, vf a) {
+    // Values are in [0, 255.5): the signed convert is enough, and truncates.
+    __m128i c = _mm_cvttps_epi32(r);
+    c = _mm_or_si128(c, _mm_slli_epi32(_mm_cvttps_epi32(g), 8));
+    c = _mm_or_si128(c, _mm_slli_epi32(_mm_cvttps_epi32(b), 16));
+    c = _mm_or_si128(c, _mm_slli_epi32(_mm_cvttps_epi32(a), 24));
+    _mm_storeu_si128((__m128i*)out, c);
+}
+
+#endif
+
+static inline vf v_clamp01(vf x) {
+    // max(NaN, 0) picks 0 on SSE2; on NEON the NaN survives but converts to 0.
+    return v_min(v_max(x, v_set(0.0f)), v_set(1.0f));
+}
+
+static inline vf v_hsv_channel(vf n, vf h6, vf vs, vf v) {
+    vf k = v_add(n, h6);
+    k = v_sub(k, v_and(v_ge(k, v_set(6.0f)), v_set(6.0f)));
+    const vf f = v_min(v_max(v_min(k, v_sub(v_set(4.0f), k)), v_set(0.0f)), v_set(1.0f));
+    return v_sub(v, v_mul(vs, f));
+}
+
+static QuadCornersSoA advance(const QuadCornersSoA& in, uint32_t i) {
+    return QuadCornersSoA{ in.x0 + i, in.y0 + i, in.x1 + i, in.y1 + i,
+                           in.m00 + i, in.m01 + i, in.m10 + i, in.m11 + i,
+                           in.tx + i, in.ty + i };
+}
+
+void simd_quad_corners(const QuadCornersSoA& in, uint32_t count, SpriteVertex* out) {
+    uint32_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const vf x0 = v_load(in.x0 + i), x1 = v_load(in.x1 + i);
+        const vf y0 = v_load(in.y0 + i), y1 = v_load(in.y1 + i);
+        const vf m00 = v_load(in.m00 + i), m01 = v_load(in.m01 + i);
+        const vf m10 = v_load(in.m10 + i), m11 = v_load(in.m11 + i);
+        const vf tx = v_load(in.tx + i), ty = v_load(in.ty + i);
+
+        const vf ax0 = v_mul(m00, x0), ax1 = v_mul(m00, x1);
+        const vf by0 = v_add(v_mul(m01, y0), tx), by1 = v_add(v_mul(m01, y1), tx);
+        const vf cx0 = v_mul(m10, x0), cx1 = v_mul(m10, x1);
+        const vf dy0 = v_add(v_mul(m11, y0), ty), dy1 = v_add(v_mul(m11, y1), ty);
+
+        SpriteVertex* v = out + i * SPRITE_VERTICES_PER_QUAD;
+        v_store_xy(v + 0, v_add(ax0, by0), v_add(cx0, dy0));
+        v_store_xy(v + 1, v_add(ax1, by0), v_add(cx1, dy0));
+        v_store_xy(v + 2, v_add(ax1, by1), v_add(cx1, dy1));
+        v_store_xy(v + 3, v_add(ax0, by1), v_add(cx0, dy1));
+    }
+    if (i < count) simd_quad_corners_scalar(advance(in, i), count - i, out + i * SPRITE_VERTICES_PER_QUAD);
+}
+
+void simd_sincos(const float* angle, uint32_t count, float* s, float* c) {
+    uint32_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const vf a = v_load(angle + i);
+        const vi sign = vi_and(v_bits(a), vi_set(INT32_MIN));
+        vf x = v_abs(a);
+        vi j = vi_cvtt(v_mul(x, v_set(kFourOverPi)));
+        j = vi_and(vi_add(j, vi_set(1)), vi_set(~1));
+        const vf y = vi_tof(j);
+        x = v_sub(v_sub(v_sub(x, v_mul(y, v_set(kDP1))), v_mul(y, v_set(kDP2))), v_mul(y, v_set(kDP3)));
+
+        const vf z = v_mul(x, x);
+        vf pc = v_add(v_mul(v_add(v_mul(v_set(kCos0), z), v_set(kCos1)), z), v_set(kCos2));
+        pc = v_add(v_sub(v_mul(v_mul(pc, z), z), v_mul(v_set(0.5f), z)), v_set(1.0f));
+        vf ps = v_add(v_mul(v_add(v_mul(v_set(kSin0), z), v_set(kSin1)), z), v_set(kSin2));
+        ps = v_add(v_mul(v_mul(ps, z), x), x);
+
+        const vm keep = vi_eq(vi_and(j, vi_set(2)), vi_set(0));
+        const vi sin_sign = vi_xor(sign, vi_shl29(vi_and(j, vi_set(4))));
+        const vi cos_sign = vi_shl29(vi_and(vi_xor(vi_sub(j, vi_set(2)), vi_set(-1)), vi_set(4)));
+        v_store(s + i, v_from_bits(vi_xor(v_bits(v_sel(keep, ps, pc)), sin_sign)));
+        v_store(c + i, v_from_bits(vi_xor(v_bits(v_sel(keep, pc, ps)), cos_sign)));
+    }
+    if (i < count) simd_sincos_scalar(angle + i, count - i, s + i, c + i);
+}
+
+void simd_pack_rgba8(const float* r, const float* g, const float* b, const float* a,
+                     uint32_t count, uint32_t* out) {
+    const vf scale = v_set(255.0f), half = v_set(0.5f);
+    uint32_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        v_pack_rgba8(out + i,
+                     v_add(v_mul(v_clamp01(v_load(r + i)), scale), half),
+                     v_add(v_mul(v_clamp01(v_load(g + i)), scale), half),
+                     v_add(v_mul(v_clamp01(v_load(b + i)), scale), half),
+                     v_add(v_mul(v_clamp01(v_load(a + i)), scale), half));
+    }
+    if (i < count) simd_pack_rgba8_scalar(r + i, g + i, b + i, a + i, count - i, out + i);
+}
+
+void simd_hsv_to_rgb(const float* h, const float* s, const float* v, uint32_t count,
+                     float* r, float* g, float* b) {
+    uint32_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const vf hh = v_load(h + i), vv = v_load(v + i);
+        vf t = v_trunc(hh);
+        t = v_sub(t, v_and(v_gt(t, hh), v_set(1.0f)));
+        const vf h6 = v_mul(v_sub(hh, t), v_set(6.0f));
+        const vf vs = v_mul(vv, v_load(s + i));
+        v_store(r + i, v_hsv_channel(v_set(5.0f), h6, vs, vv));
+        v_store(g + i, v_hsv_channel(v_set(3.0f), h6, vs, vv));
+        v_store(b + i, v_hsv_channel(v_set(1.0f), h6, vs, vv));
+    }
+    if (i < count) simd_hsv_to_rgb_scalar(h + i, s + i, v + i, count - i, r + i, g + i, b + i);
+}
+
+void simd_rgb_to_hsv(const float* r, const float* g, const float* b, uint32_t count,
+                     float* h, float* s, float* v) {
+    const vf zero = v_set(0.0f);
+    uint32_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const vf rr = v_load(r + i), gg = v_load(g + i), bb = v_load(b + i);
+        const vf mx = v_max(v_max(rr, gg), bb);
+        const vf mn = v_min(v_min(rr, gg), bb);
+        const vf c = v_sub(mx, mn);
+
+        // All three candidates, then pick; lanes with c == 0 are masked to 0.
+        const vf ic = v_div(v_set(1.0f), c);
+        vf hr = v_mul(v_sub(gg, bb), ic);
+        hr = v_add(hr, v_and(v_lt(hr, zero), v_set(6.0f)));
+        const vf hg = v_add(v_mul(v_sub(bb, rr), ic), v_set(2.0f));
+        const vf hb = v_add(v_mul(v_sub(rr, gg), ic), v_set(4.0f));
+
+        const vm is_r = v_eq(mx, rr);
+        const vm is_g = m_andnot(is_r, v_eq(mx, gg));
+        vf hue = v_sel(is_r, hr, v_sel(is_g, hg, hb));
+        hue = v_and(v_gt(c, zero), hue);
+
+        v_store(h + i, v_mul(hue, v_set(1.0f / 6.0f)));
+        v_store(s + i, v_and(v_gt(mx, zero), v_div(c, mx)));
+        v_store(v + i, mx);
+    }
+    if (i < count) simd_rgb_to_hsv_scalar(r + i, g + i, b + i, count - i, h + i, s + i, v + i);
+}
+
+#else // scalar build
+
+void simd_quad_corners(const QuadCornersSoA& in, uint32_t count, SpriteVertex* out) {
+    simd_quad_corners_scalar(in, count, out);
+}
+
+void simd_sincos(const float* angle, uint32_t count, float* s, float* c) {
+    simd_sincos_scalar(angle, count, s, c);
+}
+
+void simd_pack_rgba8(const float* r, const float* g, const float* b, const float* a,
+                     uint32_t count, uint32_t* out) {
+    simd_pack_rgba8_scalar(r, g, b, a, count, out);
+}
+
+void simd_hsv_to_rgb(const float* h, const float* s, const float* v, uint32_t count,
+                     float* r, float* g, float* b) {
+    simd_hsv_to_rgb_scalar(h, s, v, count, r, g, b);
+}
+
+void simd_rgb_to_hsv(const float* r, const float* g, const float* b, uint32_t count,
+                     float* h, float* s, float* v) {
+    simd_rgb_to_hsv_scalar(r, g, b, count, h, s, v);
+}
+
+#endif
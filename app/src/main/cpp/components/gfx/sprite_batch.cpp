@@ -0,0 +1,104 @@
+#include "gfx/sprite_batch.h"
+#include "gfx/simd_kernels.h"
+
+void sprite_fill_indices(uint16_t* out, uint32_t quad_count) {
+    for (uint32_t q = 0; q < quad_count; q++) {
+        const uint16_t v = (uint16_t)(q * SPRITE_VERTICES_PER_QUAD);
+        out[0] = v;
+        out[1] = (uint16_t)(v + 1);
+        out[2] = (uint16_t)(v + 2);
+        out[3] = (uint16_t)(v + 2);
+        out[4] = (uint16_t)(v + 3);
+        out[5] = v;
+        out += SPRITE_INDICES_PER_QUAD;
+    }
+}
+
+void sprite_build_vertices(const Sprite* sprites, uint32_t count, SpriteVertex* out) {
+    // Gather a block of sprites into SoA, build the rotations with simd_sincos
+    // and run the corner transform with simd_quad_corners, then fill in uv/color.
+    static constexpr uint32_t BLOCK = 64;
+    float x0[BLOCK], y0[BLOCK], x1[BLOCK], y1[BLOCK];
+    float rot[BLOCK], c[BLOCK], sn[BLOCK], nsn[BLOCK], tx[BLOCK], ty[BLOCK];
+    const QuadCornersSoA soa{ x0, y0, x1, y1, c, nsn, sn, c, tx, ty };
+
+    for (uint32_t base = 0; base < count; base += BLOCK) {
+        const uint32_t n = count - base < BLOCK ? count - base : BLOCK;
+        const Sprite* src = sprites + base;
+
+        for (uint32_t i = 0; i < n; i++) {
+            const Sprite& s = src[i];
+            // Corners relative to the origin, then rotate + translate.
+            x0[i] = -s.ox * s.w; x1[i] = x0[i] + s.w;
+            y0[i] = -s.oy * s.h; y1[i] = y0[i] + s.h;
+            rot[i] = s.rotation;
+            tx[i] = s.x; ty[i] = s.y;
+        }
+        simd_sincos(rot, n, sn, c);
+        for (uint32_t i = 0; i < n; i++) nsn[i] = -sn[i];
+
+        SpriteVertex* dst = out + base * SPRITE_VERTICES_PER_QUAD;
+        simd_quad_corners(soa, n, dst);
+
+        for (uint32_t i = 0; i < n; i++) {
+            const Sprite& s = src[i];
+            SpriteVertex* v = dst + i * SPRITE_VERTICES_PER_QUAD;
+            v[0].u = s.u0; v[0].v = s.v0;
+            v[1].u = s.u1; v[1].v = s.v0;
+            v[2].u = s.u1; v[2].v = s.v1;
+            v[3].u = s.u0; v[3].v = s.v1;
+
+            v[0].color = v[1].color = v[2].color = v[3].color = s.color;
+        }
+    }
+}
+
+void SpriteBatcher::begin_frame() {
+    dst_ = nullptr;
+    max_quads_ = quads_ = 0;
+    batch_count_ = 0;
+    have_run_ = false;
+    stats_ = SpriteStats{};
+}
+
+void SpriteBatcher::begin(SpriteVertex* dst, uint32_t max_quads) {
+    dst_ = dst;
+    max_quads_ = max_quads;
+    quads_ = 0;
+    batch_count_ = 0;
+}
+
+uint32_t SpriteBatcher::add(const Sprite* sprites, uint32_t count) {
+    uint32_t done = 0;
+    while (done < count && quads_ < max_quads_) {
+        // Split off the run of sprites that share texture/shader with sprites[done].
+        const uint32_t tex = sprites[done].texture;
+        const uint32_t shader = sprites[done].shader;
+        uint32_t run = 1;
+        const uint32_t room = max_quads_ - quads_;
+        while (run < count - done && run < room &&
+               sprites[done + run].texture == tex && sprites[done + run].shader == shader) {
+            run++;
+        }
+
+        SpriteBatch* last = batch_count_ ? &batches_[batch_count_ - 1] : nullptr;
+        if (last && last->texture == tex && last->shader == shader) {
+            last->quad_count += run;
+        } else {
+            if (batch_count_ >= MAX_SPRITE_BATCHES) break; // caller flushes and continues
+            batches_[batch_count_++] = SpriteBatch{ tex, shader, quads_, run };
+        }
+        if (!have_run_ || run_texture_ != tex || run_shader_ != shader) {
+            have_run_ = true;
+            run_texture_ = tex;
+            run_shader_ = shader;
+            stats_.batches++;
+        }
+
+        sprite_build_vertices(sprites + done, run, dst_ + quads_ * SPRITE_VERTICES_PER_QUAD);
+        quads_ += run;
+        done += run;
+    }
+    stats_.sprites += done;
+    return done;
+}
@@ -0,0 +1,245 @@
+#include "input/gesture.h"
+
+#include <cmath>
+#include <cstring>
+
+#include "app/event_dispatcher.h"
+
+namespace input {
+
+int GestureRecognizer::slot_of(int32_t id) const {
+    for (uint32_t i = 0; i < MAX_POINTERS; i++) {
+        if (state_[i] != Idle && id_[i] == id) return (int)i;
+    }
+    return -1;
+}
+
+void GestureRecognizer::emit(GestureKind kind, GesturePhase phase, int32_t id, float x, float y, float value) {
+    if (out_count_ >= MAX_FRAME_GESTURES) {
+        dropped_++;
+        return;
+    }
+    out_[out_count_++] = Gesture{ kind, phase, id, x, y, value };
+}
+
+void GestureRecognizer::reset() {
+    for (uint32_t i = 0; i < MAX_POINTERS; i++) state_[i] = Idle;
+    pinch_a_ = pinch_b_ = -1;
+    pinch_started_ = false;
+    out_count_ = 0;
+}
+
+float GestureRecognizer::pinch_span() const {
+    const float dx = x_[pinch_b_] - x_[pinch_a_];
+    const float dy = y_[pinch_b_] - y_[pinch_a_];
+    return std::sqrt(dx * dx + dy * dy);
+}
+
+void GestureRecognizer::start_pinch(int a, int b) {
+    if (state_[a] == Dragging) {
+        emit(GestureKind::Drag, GesturePhase::Cancel, id_[a], x_[a], y_[a]);
+    }
+    state_[a] = state_[b] = Pinching;
+    pinch_a_ = a;
+    pinch_b_ = b;
+    pinch_started_ = false;
+    pinch_span0_ = pinch_span();
+}
+
+void GestureRecognizer::end_pinch(GesturePhase phase) {
+    if (pinch_started_) {
+        const float span = pinch_span();
+        emit(GestureKind::Pinch, phase, id_[pinch_a_],
+             0.5f * (x_[pinch_a_] + x_[pinch_b_]), 0.5f * (y_[pinch_a_] + y_[pinch_b_]),
+             pinch_span0_ > 0.0f ? span / pinch_span0_ : 1.0f);
+    }
+    // The other finger sits the rest of this touch out.
+    state_[pinch_a_] = state_[pinch_b_] = Ignored;
+    pinch_a_ = pinch_b_ = -1;
+    pinch_started_ = false;
+}
+
+void GestureRecognizer::on_down(const PointerEvent& e) {
+    if (slot_of(e.pointer_id) >= 0) on_up(e, true); // id reused without an up
+
+    int s = -1;
+    for (uint32_t i = 0; i < MAX_POINTERS; i++) {
+        if (state_[i] == Idle) { s = (int)i; break; }
+    }
+    if (s < 0) return; // more fingers than slots
+
+    state_[s] = Pending;
+    id_[s] = e.pointer_id;
+    x_[s] = down_x_[s] = e.x;
+    y_[s] = down_y_[s] = e.y;
+    vx_[s] = vy_[s] = 0.0f;
+    down_ns_[s] = last_ns_[s] = e.timestamp_ns;
+    moved_[s] = false;
+
+    if (pinch_a_ >= 0) {
+        state_[s] = Ignored;
+        return;
+    }
+
+    // Second finger on a live single-finger gesture: pinch.
+    for (uint32_t i = 0; i < MAX_POINTERS; i++) {
+        if ((int)i == s) continue;
+        if (state_[i] == Pending || state_[i] == LongPressed || state_[i] == Dragging) {
+            start_pinch((int)i, s);
+            return;
+        }
+    }
+}
+
+void GestureRecognizer::on_move(const PointerEvent& e) {
+    const int s = slot_of(e.pointer_id);
+    if (s < 0) return;
+
+    // Velocity: lightly smoothed finite difference over the raw samples.
+    if (e.timestamp_ns > last_ns_[s]) {
+        const float inv_dt = 1e9f / (float)(e.timestamp_ns - last_ns_[s]);
+        const float ivx = (e.x - x_[s]) * inv_dt;
+        const float ivy = (e.y - y_[s]) * inv_dt;
+        vx_[s] = 0.6f * ivx + 0.4f * vx_[s];
+        vy_[s] = 0.6f * ivy + 0.4f * vy_[s];
+        last_ns_[s] = e.timestamp_ns;
+    }
+    x_[s] = e.x;
+    y_[s] = e.y;
+    moved_[s] = true;
+
+    if (state_[s] == Pending || state_[s] == LongPressed) {
+        const float dx = e.x - down_x_[s];
+        const float dy = e.y - down_y_[s];
+        if (dx * dx + dy * dy > cfg_.touch_slop * cfg_.touch_slop) {
+            state_[s] = Dragging;
+            emit(GestureKind::Drag, GesturePhase::Begin, id_[s], e.x, e.y);
+            moved_[s] = false;
+        }
+    }
+}
+
+void GestureRecognizer::on_up(const PointerEvent& e, bool canceled) {
+    const int s = slot_of(e.pointer_id);
+    if (s < 0) return;
+
+    if (!canceled) {
+        x_[s] = e.x;
+        y_[s] = e.y;
+    }
+
+    switch (state_[s]) {
+        case Pending:
+            if (!canceled && e.timestamp_ns - down_ns_[s] <= cfg_.tap_max_ns) {
+                emit(GestureKind::Tap, GesturePhase::End, id_[s], x_[s], y_[s]);
+            }
+            break;
+        case Dragging:
+            if (canceled) {
+                emit(GestureKind::Drag, GesturePhase::Cancel, id_[s], x_[s], y_[s]);
+                break;
+            }
+            emit(GestureKind::Drag, GesturePhase::End, id_[s], x_[s], y_[s]);
+            if (e.timestamp_ns - last_ns_[s] <= cfg_.fling_max_idle_ns &&
+                vx_[s] * vx_[s] + vy_[s] * vy_[s] >= cfg_.fling_min_velocity * cfg_.fling_min_velocity) {
+                emit(GestureKind::Fling, GesturePhase::End, id_[s], vx_[s], vy_[s]);
+            }
+            break;
+        case Pinching:
+            end_pinch(canceled ? GesturePhase::Cancel : GesturePhase::End);
+            break;
+        default:
+            break;
+    }
+    state_[s] = Idle;
+}
+
+void GestureRecognizer::update(EventSpan events, uint64_t now_ns) {
+    out_count_ = 0;
+
+    for (const PointerEvent& e : events) {
+        // A press that outlived long_press_ns counts as one even if this frame
+        // only now delivers its move/up.
+        const int s = slot_of(e.pointer_id);
+        if (s >= 0 && state_[s] == Pending && e.timestamp_ns - down_ns_[s] >= cfg_.long_press_ns) {
+            state_[s] = LongPressed;
+            emit(GestureKind::LongPress, GesturePhase::End, id_[s], x_[s], y_[s],
+                 (float)(e.timestamp_ns - down_ns_[s]) * 1e-9f);
+        }
+
+        switch (e.type) {
+            case EventType::PointerDown:   on_down(e); break;
+            case EventType::PointerMove:   on_move(e); break;
+            case EventType::PointerUp:     on_up(e, false); break;
+            case EventType::PointerCancel: on_up(e, true); break;
+        }
+    }
+
+    for (uint32_t i = 0; i < MAX_POINTERS; i++) {
+        if (state_[i] == Pending && now_ns >= down_ns_[i] && now_ns - down_ns_[i] >= cfg_.long_press_ns) {
+            state_[i] = LongPressed;
+            emit(GestureKind::LongPress, GesturePhase::End, id_[i], x_[i], y_[i],
+                 (float)(now_ns - down_ns_[i]) * 1e-9f);
+        }
+        if (state_[i] == Dragging && moved_[i]) {
+            emit(GestureKind::Drag, GesturePhase::Update, id_[i], x_[i], y_[i]);
+        }
+    }
+
+    if (pinch_a_ >= 0 && (moved_[pinch_a_] || moved_[pinch_b_])) {
+        const float span = pinch_span();
+        if (!pinch_started_ && std::fabs(span - pinch_span0_) > cfg_.pinch_slop) {
+            pinch_started_ = true;
+            emit(GestureKind::Pinch, GesturePhase::Begin, id_[pinch_a_],
+                 0.5f * (x_[pinch_a_] + x_[pinch_b_]), 0.5f * (y_[pinch_a_] + y_[pinch_b_]),
+                 pinch_span0_ > 0.0f ? span / pinch_span0_ : 1.0f);
+        } else if (pinch_started_) {
+            emit(GestureKind::Pinch, GesturePhase::Update, id_[pinch_a_],
+                 0.5f * (x_[pinch_a_] + x_[pinch_b_]), 0.5f * (y_[pinch_a_] + y_[pinch_b_]),
+                 pinch_span0_ > 0.0f ? span / pinch_span0_ : 1.0f);
+        }
+    }
+
+    for (uint32_t i = 0; i < MAX_POINTERS; i++) moved_[i] = false;
+}
+
+static uint32_t float_bits(float f) {
+    uint32_t u;
+    std::memcpy(&u, &f, sizeof(u));
+    return u;
+}
+
+static float bits_float(uint32_t u) {
+    float f;
+    std::memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+rce::EPMsg gesture_to_msg(const Gesture& g) {
+    rce::EPMsg m;
+    m.type = rce::EPType::Gesture;
+    m.a = (uint32_t)g.kind | (uint32_t)g.phase << 8 | ((uint32_t)g.pointer_id & 0xffffu) << 16;
+    m.b = float_bits(g.x);
+    m.c = float_bits(g.y);
+    m.d = float_bits(g.value);
+    return m;
+}
+
+Gesture gesture_from_msg(const rce::EPMsg& msg) {
+    Gesture g;
+    g.kind = (GestureKind)(msg.a & 0xffu);
+    g.phase = (GesturePhase)((msg.a >> 8) & 0xffu);
+    g.pointer_id = (int32_t)(int16_t)(msg.a >> 16);
+    g.x = bits_float(msg.b);
+    g.y = bits_float(msg.c);
+    g.value = bits_float(msg.d);
+    return g;
+}
+
+void dispatch_gestures(const GestureRecognizer& rec) {
+    for (const Gesture& g : rec.gestures()) {
+        rce::ep_dispatch(gesture_to_msg(g));
+    }
+}
+
+} // namespace input
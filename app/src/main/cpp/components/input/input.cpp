@@ -2,38 +2,126 @@
 
 namespace input {
 
-InputState::InputState()
-: pointer_down_(false), pointer_x_(0.0f), pointer_y_(0.0f) {}
-
+InputState::InputState() = default;
 InputState::~InputState() = default;
 
 void InputState::begin_frame() {
-    events_.clear();
+    event_count_ = 0;
+
+    // Compact away released pointers (keeps press order), clear per-frame bits.
+    uint32_t w = 0;
+    for (uint32_t r = 0; r < table_.count; r++) {
+        if (!(table_.state[r] & POINTER_DOWN)) continue;
+        if (w != r) {
+            table_.id[w]       = table_.id[r];
+            table_.x[w]        = table_.x[r];
+            table_.y[w]        = table_.y[r];
+            table_.start_x[w]  = table_.start_x[r];
+            table_.start_y[w]  = table_.start_y[r];
+            table_.pressure[w] = table_.pressure[r];
+            table_.down_ns[w]  = table_.down_ns[r];
+            table_.last_ns[w]  = table_.last_ns[r];
+        }
+        table_.state[w] = POINTER_DOWN;
+        w++;
+    }
+    table_.count = w;
 }
 
 bool InputState::pointer_is_down() const { return pointer_down_; }
 float InputState::pointer_x() const { return pointer_x_; }
 float InputState::pointer_y() const { return pointer_y_; }
 
-const std::vector<PointerEvent>& InputState::events() const {
-    return events_;
+void InputState::update_primary() {
+    for (uint32_t i = 0; i < table_.count; i++) {
+        if (table_.state[i] & POINTER_DOWN) {
+            pointer_down_ = true;
+            pointer_x_ = table_.x[i];
+            pointer_y_ = table_.y[i];
+            return;
+        }
+    }
+    pointer_down_ = false;
 }
 
-void InputState::push_pointer_down(int32_t id, float x, float y) {
-    pointer_down_ = true;
-    pointer_x_ = x; pointer_y_ = y;
-    events_.push_back({EventType::PointerDown, id, x, y});
+void InputState::record(EventType type, int32_t id, float x, float y, float pressure, uint64_t t_ns) {
+    if (event_count_ >= MAX_FRAME_EVENTS) {
+        dropped_events_++;
+        return;
+    }
+    PointerEvent& e = events_[event_count_++];
+    e.type = type;
+    e.pointer_id = id;
+    e.x = x;
+    e.y = y;
+    e.pressure = pressure;
+    e.timestamp_ns = t_ns;
 }
 
-void InputState::push_pointer_up(int32_t id, float x, float y) {
-    pointer_down_ = false;
-    pointer_x_ = x; pointer_y_ = y;
-    events_.push_back({EventType::PointerUp, id, x, y});
+void InputState::push_pointer_down(int32_t id, float x, float y, uint64_t t_ns, float pressure) {
+    int i = table_.find(id);
+    if (i < 0) {
+        if (table_.count >= MAX_POINTERS) { // more fingers than we track: event only
+            record(EventType::PointerDown, id, x, y, pressure, t_ns);
+            return;
+        }
+        i = (int)table_.count++;
+        table_.state[i] = 0;
+    }
+    // A re-used id that went up earlier this frame simply starts over.
+    table_.id[i] = id;
+    table_.x[i] = table_.start_x[i] = x;
+    table_.y[i] = table_.start_y[i] = y;
+    table_.pressure[i] = pressure;
+    table_.down_ns[i] = table_.last_ns[i] = t_ns;
+    table_.state[i] = (uint8_t)((table_.state[i] & POINTER_RELEASED) | POINTER_DOWN | POINTER_PRESSED);
+
+    record(EventType::PointerDown, id, x, y, pressure, t_ns);
+    update_primary();
+}
+
+void InputState::push_pointer_up(int32_t id, float x, float y, uint64_t t_ns, float pressure) {
+    const int i = table_.find(id);
+    if (i >= 0) {
+        table_.x[i] = x;
+        table_.y[i] = y;
+        table_.pressure[i] = pressure;
+        table_.last_ns[i] = t_ns;
+        table_.state[i] = (uint8_t)((table_.state[i] & ~POINTER_DOWN) | POINTER_RELEASED);
+    }
+
+    record(EventType::PointerUp, id, x, y, pressure, t_ns);
+    const bool was_primary_down = pointer_down_;
+    update_primary();
+    if (was_primary_down && !pointer_down_) { pointer_x_ = x; pointer_y_ = y; }
+}
+
+void InputState::push_pointer_move(int32_t id, float x, float y, uint64_t t_ns, float pressure) {
+    const int i = table_.find(id);
+    if (i >= 0 && (table_.state[i] & POINTER_DOWN)) {
+        table_.x[i] = x;
+        table_.y[i] = y;
+        table_.pressure[i] = pressure;
+        table_.last_ns[i] = t_ns;
+        table_.state[i] |= POINTER_MOVED;
+    }
+
+    record(EventType::PointerMove, id, x, y, pressure, t_ns);
+    update_primary();
 }
 
-void InputState::push_pointer_move(int32_t id, float x, float y) {
-    pointer_x_ = x; pointer_y_ = y;
-    events_.push_back({EventType::PointerMove, id, x, y});
+void InputState::push_pointer_cancel(int32_t id, uint64_t t_ns) {
+    float x = pointer_x_, y = pointer_y_;
+    const int i = table_.find(id);
+    if (i >= 0) {
+        x = table_.x[i];
+        y = table_.y[i];
+        table_.last_ns[i] = t_ns;
+        table_.state[i] = (uint8_t)((table_.state[i] & ~POINTER_DOWN) | POINTER_RELEASED | POINTER_CANCELED);
+    }
+
+    record(EventType::PointerCancel, id, x, y, 0.0f, t_ns);
+    update_primary();
 }
 
 } // namespace input
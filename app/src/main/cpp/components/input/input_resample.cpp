@@ -0,0 +1,205 @@
+#include "input/input_resample.h"
+
+#include <cstring>
+
+#include "app/event_dispatcher.h"
+
+namespace input {
+
+InputResampler::Track* InputResampler::track_for(int32_t id, bool create) {
+    Track* free_slot = nullptr;
+    for (Track& tr : tracks_) {
+        if (tr.used && tr.id == id) return &tr;
+        if (!tr.used && !free_slot) free_slot = &tr;
+    }
+    if (!create || !free_slot) return nullptr;
+    free_slot->used = true;
+    free_slot->id = id;
+    free_slot->n = 0;
+    free_slot->head = 0;
+    return free_slot;
+}
+
+void InputResampler::add_sample(Track& tr, const PointerEvent& e) {
+    // Out-of-order or duplicate timestamps would break interpolation: replace.
+    if (tr.n > 0 && e.timestamp_ns <= tr.newest(0).t) {
+        Sample& last = tr.s[(tr.head + HISTORY - 1) % HISTORY];
+        last.x = e.x;
+        last.y = e.y;
+        return;
+    }
+    tr.s[tr.head] = Sample{ e.timestamp_ns, e.x, e.y };
+    tr.head = (tr.head + 1) % HISTORY;
+    if (tr.n < HISTORY) tr.n++;
+}
+
+void InputResampler::resample(const Track& tr, uint64_t target_ns, ResampledPointer& out) const {
+    const Sample& s1 = tr.newest(0);
+    out.x = s1.x;
+    out.y = s1.y;
+    out.vx = out.vy = 0.0f;
+    out.predicted = false;
+    if (tr.n < 2) return;
+
+    const Sample& s0 = tr.newest(1);
+    const uint64_t gap = s1.t - s0.t;
+    if (gap > 0) {
+        const float inv = 1e9f / (float)gap;
+        out.vx = (s1.x - s0.x) * inv;
+        out.vy = (s1.y - s0.y) * inv;
+    }
+
+    if (target_ns <= s1.t) {
+        // Interpolate between the two samples around the target.
+        for (uint32_t back = 0; back + 1 < tr.n; back++) {
+            const Sample& b = tr.newest(back);
+            const Sample& a = tr.newest(back + 1);
+            if (a.t <= target_ns && target_ns <= b.t) {
+                const float k = (b.t > a.t) ? (float)(target_ns - a.t) / (float)(b.t - a.t) : 1.0f;
+                out.x = a.x + (b.x - a.x) * k;
+                out.y = a.y + (b.y - a.y) * k;
+                return;
+            }
+        }
+        const Sample& oldest = tr.newest(tr.n - 1);
+        if (target_ns < oldest.t) { out.x = oldest.x; out.y = oldest.y; }
+        return;
+    }
+
+    uint64_t ahead = target_ns - s1.t;
+    if (!cfg_.predict || gap < cfg_.min_sample_gap_ns || ahead > cfg_.max_sample_age_ns) return;
+    if (tr.n >= 3) {
+        const Sample& sp = tr.newest(2);
+        if ((s0.x - sp.x) * (s1.x - s0.x) + (s0.y - sp.y) * (s1.y - s0.y) < 0.0f) return;
+    }
+
+    if (ahead > cfg_.max_predict_ns) ahead = cfg_.max_predict_ns;
+    const float dt = (float)ahead * 1e-9f;
+    out.x = s1.x + out.vx * dt;
+    out.y = s1.y + out.vy * dt;
+    out.predicted = ahead > 0;
+}
+
+void InputResampler::update(const InputState& in, uint64_t present_ns) {
+    // 1. Coalesce, walking backwards: a move is dropped when a later move of
+    //    the same pointer follows with no down/up/cancel of it in between.
+    //    Survivors are written back to front, then moved to the start.
+    struct Later { int32_t id; bool move; };
+    Later later[MAX_POINTERS];
+    uint32_t nlater = 0;
+
+    const EventSpan events = in.events();
+    uint32_t w = MAX_FRAME_EVENTS;
+    for (uint32_t i = events.size(); i-- > 0;) {
+        const PointerEvent& e = events[i];
+        uint32_t li = 0;
+        while (li < nlater && later[li].id != e.pointer_id) li++;
+        if (li == nlater && nlater < MAX_POINTERS) later[nlater++] = Later{ e.pointer_id, false };
+
+        const bool move = e.type == EventType::PointerMove;
+        if (move && li < nlater && later[li].move) continue;
+        if (li < nlater) later[li].move = move;
+        coalesced_[--w] = e;
+    }
+    coalesced_count_ = MAX_FRAME_EVENTS - w;
+    if (w > 0) std::memmove(coalesced_, coalesced_ + w, coalesced_count_ * sizeof(PointerEvent));
+
+    // 2. Feed the raw samples into each pointer's history.
+    for (const PointerEvent& e : events) {
+        if (e.type == EventType::PointerDown) {
+            Track* tr = track_for(e.pointer_id, true);
+            if (tr) { tr->n = 0; tr->head = 0; add_sample(*tr, e); }
+        } else if (Track* tr = track_for(e.pointer_id, false)) {
+            add_sample(*tr, e);
+        }
+    }
+
+    // 3. Resample every pointer the table knows about; forget the rest.
+    const PointerTable& pt = in.pointers();
+    const uint64_t target = present_ns > cfg_.latency_ns ? present_ns - cfg_.latency_ns : 0;
+
+    count_ = 0;
+    for (uint32_t i = 0; i < pt.count; i++) {
+        ResampledPointer& out = out_[count_++];
+        out.id = pt.id[i];
+        out.state = pt.state[i];
+
+        const Track* tr = track_for(pt.id[i], false);
+        if (!tr || tr->n == 0) {
+            out.x = pt.x[i];
+            out.y = pt.y[i];
+            out.vx = out.vy = 0.0f;
+            out.predicted = false;
+            continue;
+        }
+        if (!(pt.state[i] & POINTER_DOWN)) {
+            // Lifted: report where it went up, keep the release velocity for flings.
+            resample(*tr, tr->newest(0).t, out);
+            continue;
+        }
+        resample(*tr, target, out);
+    }
+
+    for (Track& tr : tracks_) {
+        if (tr.used && pt.find(tr.id) < 0) tr.used = false;
+    }
+}
+
+const ResampledPointer* InputResampler::find(int32_t id) const {
+    for (uint32_t i = 0; i < count_; i++) {
+        if (out_[i].id == id) return &out_[i];
+    }
+    return nullptr;
+}
+
+bool InputResampler::primary(float* x, float* y) const {
+    for (uint32_t i = 0; i < count_; i++) {
+        if (out_[i].state & POINTER_DOWN) {
+            *x = out_[i].x;
+            *y = out_[i].y;
+            return true;
+        }
+    }
+    return false;
+}
+
+static uint32_t float_bits(float f) {
+    uint32_t u;
+    std::memcpy(&u, &f, sizeof(u));
+    return u;
+}
+
+static float bits_float(uint32_t u) {
+    float f;
+    std::memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+rce::EPMsg pointer_to_msg(const PointerEvent& e) {
+    rce::EPMsg m;
+    m.type = rce::EPType::Pointer;
+    m.a = (uint32_t)e.type | ((uint32_t)e.pointer_id & 0xffffu) << 16;
+    m.b = float_bits(e.x);
+    m.c = float_bits(e.y);
+    m.d = float_bits(e.pressure);
+    return m;
+}
+
+PointerEvent pointer_from_msg(const rce::EPMsg& msg) {
+    PointerEvent e;
+    e.type = (EventType)(msg.a & 0xffu);
+    e.pointer_id = (int32_t)(int16_t)(msg.a >> 16);
+    e.x = bits_float(msg.b);
+    e.y = bits_float(msg.c);
+    e.pressure = bits_float(msg.d);
+    e.timestamp_ns = 0;
+    return e;
+}
+
+void dispatch_pointers(const InputResampler& rs) {
+    for (const PointerEvent& e : rs.coalesced()) {
+        rce::ep_dispatch(pointer_to_msg(e));
+    }
+}
+
+} // namespace input
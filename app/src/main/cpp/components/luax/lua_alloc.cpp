@@ -0,0 +1,119 @@
+#include "luax/lua_alloc.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+LuaPoolAllocator::~LuaPoolAllocator() {
+    release();
+}
+
+void LuaPoolAllocator::release() {
+    Chunk* c = chunks_;
+    while (c) {
+        Chunk* next = c->next;
+        ::free(c);
+        c = next;
+    }
+    chunks_ = nullptr;
+    bump_ = bump_end_ = nullptr;
+    for (auto& f : free_) f = nullptr;
+    stats_ = LuaAllocStats{};
+}
+
+bool LuaPoolAllocator::grow() {
+    Chunk* c = (Chunk*)::malloc(kChunkBytes);
+    if (!c) return false;
+    c->next = chunks_;
+    chunks_ = c;
+    // Keep the first granule for the chunk link so blocks stay 16-byte aligned.
+    bump_ = (char*)c + kGranule;
+    bump_end_ = (char*)c + kChunkBytes;
+    stats_.pool_reserved += kChunkBytes;
+    return true;
+}
+
+void* LuaPoolAllocator::alloc_small(size_t cls) {
+    if (FreeNode* n = free_[cls]) {
+        free_[cls] = n->next;
+        return n;
+    }
+    const size_t bytes = (cls + 1) * kGranule;
+    if ((size_t)(bump_end_ - bump_) < bytes) {
+        // The tail of the old chunk is abandoned; at most 240 bytes per 64 KB.
+        if (!grow()) return nullptr;
+    }
+    void* p = bump_;
+    bump_ += bytes;
+    return p;
+}
+
+void* LuaPoolAllocator::alloc(size_t size) {
+    void* p;
+    if (size <= kMaxSmall) {
+        p = alloc_small(class_of(size));
+    } else {
+        p = ::malloc(size);
+        if (p) stats_.large_allocs++;
+    }
+    if (!p) return nullptr;
+
+    stats_.allocs++;
+    stats_.bytes_in_use += size;
+    if (stats_.bytes_in_use > stats_.peak_bytes) stats_.peak_bytes = stats_.bytes_in_use;
+    return p;
+}
+
+void LuaPoolAllocator::free(void* p, size_t size) {
+    if (size <= kMaxSmall) {
+        FreeNode* n = (FreeNode*)p;
+        const size_t cls = class_of(size);
+        n->next = free_[cls];
+        free_[cls] = n;
+    } else {
+        ::free(p);
+    }
+    stats_.frees++;
+    stats_.bytes_in_use -= size;
+}
+
+void* LuaPoolAllocator::realloc(void* p, size_t osize, size_t nsize) {
+    const bool small_old = osize <= kMaxSmall;
+    const bool small_new = nsize <= kMaxSmall;
+
+    void* out;
+    if (small_old && small_new && class_of(osize) == class_of(nsize)) {
+        out = p; // same bucket: nothing moves
+    } else if (!small_old && !small_new) {
+        out = ::realloc(p, nsize);
+        if (!out) return nullptr; // Lua keeps the old block and raises a memory error
+    } else {
+        out = small_new ? alloc_small(class_of(nsize)) : ::malloc(nsize);
+        if (!out) return nullptr;
+        if (!small_new) stats_.large_allocs++;
+        memcpy(out, p, osize < nsize ? osize : nsize);
+        if (small_old) {
+            FreeNode* n = (FreeNode*)p;
+            const size_t cls = class_of(osize);
+            n->next = free_[cls];
+            free_[cls] = n;
+        } else {
+            ::free(p);
+        }
+    }
+
+    stats_.reallocs++;
+    stats_.bytes_in_use += nsize;
+    stats_.bytes_in_use -= osize;
+    if (stats_.bytes_in_use > stats_.peak_bytes) stats_.peak_bytes = stats_.bytes_in_use;
+    return out;
+}
+
+void* LuaPoolAllocator::lua_alloc(void* ud, void* ptr, size_t osize, size_t nsize) {
+    auto* self = (LuaPoolAllocator*)ud;
+    if (nsize == 0) {
+        if (ptr) self->free(ptr, osize);
+        return nullptr;
+    }
+    if (!ptr) return self->alloc(nsize);
+    return self->realloc(ptr, osize, nsize);
+}
@@ -0,0 +1,251 @@
+#include "luax/lua_bytecode_cache.h"
+
+#include "app/log.h"
+#include "app/paths.h"
+
+#include <string>
+#include <cstdio>
+#include <cstring>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+extern "C" {
+#include "lua.h"
+#include "lauxlib.h"
+}
+
+// On-disk entry: header, source path bytes, bytecode bytes.
+struct CacheHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t src_mtime;
+    uint64_t src_size;
+    uint64_t src_hash;
+    uint32_t path_len;
+    uint32_t code_len;
+};
+
+static constexpr char kMagic[4] = { 'R', 'C', 'E', 'B' };
+static constexpr uint32_t kVersion = 1;
+
+static LuaBytecodeCacheStats g_stats;
+
+static uint64_t fnv1a64(const void* data, size_t len) {
+    const unsigned char* p = (const unsigned char*)data;
+    uint64_t h = 1469598103934665603ull;
+    for (size_t i = 0; i < len; i++) {
+        h ^= p[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+static bool read_file(const std::string& path, std::string& out) {
+    FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) return false;
+
+    std::fseek(f, 0, SEEK_END);
+    long len = std::ftell(f);
+    std::fseek(f, 0, SEEK_SET);
+    if (len < 0) { std::fclose(f); return false; }
+
+    out.resize((size_t)len);
+    size_t got = len ? std::fread(&out[0], 1, (size_t)len, f) : 0;
+    std::fclose(f);
+    return got == (size_t)len;
+}
+
+static std::string cache_dir() {
+    const std::string& base = app::paths::get().cache;
+    if (base.empty()) return {};
+    return app::paths::join(base, "luac");
+}
+
+static std::string entry_path(const std::string& dir, const char* src_path) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.luac",
+                  (unsigned long long)fnv1a64(src_path, std::strlen(src_path)));
+    return app::paths::join(dir, name);
+}
+
+static int dump_writer(lua_State* L, const void* p, size_t sz, void* ud) {
+    (void)L;
+    ((std::string*)ud)->append((const char*)p, sz);
+    return 0;
+}
+
+static void write_entry(lua_State* L, const std::string& dir, const std::string& file,
+                        const char* src_path, const CacheHeader& key) {
+    std::string code;
+    if (lua_dump(L, dump_writer, &code) != 0 || code.empty()) {
+        g_stats.write_errors++;
+        return;
+    }
+    if (!app::paths::make_dirs(dir)) {
+        g_stats.write_errors++;
+        return;
+    }
+
+    CacheHeader h = key;
+    h.path_len = (uint32_t)std::strlen(src_path);
+    h.code_len = (uint32_t)code.size();
+
+    // Write to a temp name and rename, so a crash never leaves a torn entry.
+    const std::string tmp = file + ".tmp";
+    FILE* f = std::fopen(tmp.c_str(), "wb");
+    if (!f) {
+        g_stats.write_errors++;
+        return;
+    }
+    bool ok = std::fwrite(&h, sizeof(h), 1, f) == 1 &&
+              std::fwrite(src_path, 1, h.path_len, f) == h.path_len &&
+              std::fwrite(code.data(), 1, code.size(), f) == code.size();
+    ok = (std::fclose(f) == 0) && ok;
+
+    if (!ok || std::rename(tmp.c_str(), file.c_str()) != 0) {
+        std::remove(tmp.c_str());
+        g_stats.write_errors++;
+        return;
+    }
+    g_stats.writes++;
+}
+
+// Returns true and pushes the chunk if the entry matches key; pushes nothing otherwise.
+static bool try_load_entry(lua_State* L, const std::string& file, const char* src_path,
+                           const CacheHeader& key, const char* chunkname) {
+    std::string blob;
+    if (!read_file(file, blob) || blob.size() < sizeof(CacheHeader)) return false;
+
+    CacheHeader h;
+    std::memcpy(&h, blob.data(), sizeof(h));
+
+    const size_t path_len = std::strlen(src_path);
+    if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0 || h.version != kVersion) return false;
+    if (h.src_mtime != key.src_mtime || h.src_size != key.src_size || h.src_hash != key.src_hash) return false;
+    if (h.path_len != path_len || blob.size() != sizeof(h) + h.path_len + h.code_len) return false;
+    if (std::memcmp(blob.data() + sizeof(h), src_path, path_len) != 0) return false;
+
+    const char* code = blob.data() + sizeof(h) + h.path_len;
+    if (luaL_loadbuffer(L, code, h.code_len, chunkname) != 0) {
+        lua_pop(L, 1); // e.g. bytecode from a different Lua build: recompile
+        return false;
+    }
+    return true;
+}
+
+int luax_loadfile_cached(lua_State* L, const char* path) {
+    if (!path || !*path) return luaL_loadfile(L, path);
+
+    std::string src;
+    struct stat st;
+    if (::stat(path, &st) != 0 || !read_file(path, src)) {
+        return luaL_loadfile(L, path); // let Lua produce its usual "cannot open" error
+    }
+
+    CacheHeader key{};
+    std::memcpy(key.magic, kMagic, sizeof(kMagic));
+    key.version = kVersion;
+    key.src_mtime = (uint64_t)st.st_mtime;
+    key.src_size = (uint64_t)src.size();
+    key.src_hash = fnv1a64(src.data(), src.size());
+
+    lua_pushfstring(L, "@%s", path);
+    const char* chunkname = lua_tostring(L, -1);
+
+    const std::string dir = cache_dir();
+    const std::string file = dir.empty() ? std::string{} : entry_path(dir, path);
+
+    if (!file.empty() && try_load_entry(L, file, path, key, chunkname)) {
+        lua_remove(L, -2); // chunkname
+        g_stats.hits++;
+        return 0;
+    }
+    g_stats.misses++;
+
+    // Same as luaL_loadfile: a leading "#..." line is skipped but keeps its newline,
+    // so line numbers in errors still match the file.
+    size_t skip = 0;
+    if (!src.empty() && src[0] == '#') {
+        skip = src.find('\n');
+        if (skip == std::string::npos) skip = src.size();
+    }
+
+    int rc = luaL_loadbuffer(L, src.data() + skip, src.size() - skip, chunkname);
+    lua_remove(L, -2); // chunkname
+    if (rc != 0) return rc;
+
+    if (!file.empty()) write_entry(L, dir, file, path, key);
+    return 0;
+}
+
+// package.loaders[2] replacement: same search as loadlib.c's loader_Lua.
+// Walks package.path for name. Pushes the loaded chunk (returns 1), the
+// "no file" list for require's report (0), or a load error message (-1).
+static int search_path(lua_State* L, const char* name, const char* path, const char* modpath) {
+    std::string tried;
+    std::string tmpl;
+    std::string filename;
+    const char* p = path;
+    while (*p) {
+        while (*p == *LUA_PATHSEP) p++;
+        if (!*p) break;
+        const char* end = std::strchr(p, *LUA_PATHSEP);
+        if (!end) end = p + std::strlen(p);
+        tmpl.assign(p, end);
+        p = end;
+
+        filename.clear();
+        for (char c : tmpl) {
+            if (c == *LUA_PATH_MARK) filename += modpath;
+            else filename.push_back(c);
+        }
+
+        FILE* f = std::fopen(filename.c_str(), "r");
+        if (f) {
+            std::fclose(f);
+            if (luax_loadfile_cached(L, filename.c_str()) != 0) {
+                lua_pushfstring(L, "error loading module " LUA_QS " from file " LUA_QS ":\n\t%s",
+                                name, filename.c_str(), lua_tostring(L, -1));
+                return -1;
+            }
+            return 1;
+        }
+
+        tried += "\n\tno file '";
+        tried += filename;
+        tried += "'";
+    }
+
+    lua_pushlstring(L, tried.data(), tried.size());
+    return 0;
+}
+
+static int l_cached_loader(lua_State* L) {
+    const char* name = luaL_checkstring(L, 1);
+
+    lua_getglobal(L, "package");
+    lua_getfield(L, -1, "path");
+    const char* path = lua_tostring(L, -1);
+    if (!path) return luaL_error(L, LUA_QL("package.path") " must be a string");
+
+    const char* modpath = luaL_gsub(L, name, ".", LUA_DIRSEP);
+
+    // Raised out here: lua_error longjmps, and search_path's strings must be gone by then.
+    if (search_path(L, name, path, modpath) < 0) return lua_error(L);
+    return 1; // chunk, or the not-found message for require's error report
+}
+
+void luax_install_cached_loader(lua_State* L) {
+    lua_getglobal(L, "package");
+    if (!lua_istable(L, -1)) { lua_pop(L, 1); return; }
+    lua_getfield(L, -1, "loaders");
+    if (lua_istable(L, -1)) {
+        lua_pushcfunction(L, l_cached_loader);
+        lua_rawseti(L, -2, 2);
+    }
+    lua_pop(L, 2);
+}
+
+LuaBytecodeCacheStats luax_bytecode_cache_stats() {
+    return g_stats;
+}
@@ -0,0 +1,72 @@
+#include "luax/lua_events.h"
+#include "input/gesture.h"
+#include "input/input_resample.h"
+
+extern "C" {
+#include "lua.h"
+}
+
+int luax_push_event(lua_State* L, const rce::EPMsg& msg) {
+    lua_pushinteger(L, (lua_Integer)msg.type);
+
+    if (msg.type == rce::EPType::Gesture) {
+        const input::Gesture g = input::gesture_from_msg(msg);
+        lua_pushinteger(L, (lua_Integer)g.kind);
+        lua_pushinteger(L, (lua_Integer)g.phase);
+        lua_pushnumber(L, (lua_Number)g.x);
+        lua_pushnumber(L, (lua_Number)g.y);
+        lua_pushnumber(L, (lua_Number)g.value);
+        lua_pushinteger(L, (lua_Integer)g.pointer_id);
+        return 7;
+    }
+
+    if (msg.type == rce::EPType::Pointer) {
+        const input::PointerEvent e = input::pointer_from_msg(msg);
+        lua_pushinteger(L, (lua_Integer)e.type);
+        lua_pushnumber(L, (lua_Number)e.x);
+        lua_pushnumber(L, (lua_Number)e.y);
+        lua_pushinteger(L, (lua_Integer)e.pointer_id);
+        lua_pushnumber(L, (lua_Number)e.pressure);
+        return 6;
+    }
+
+    lua_pushnumber(L, (lua_Number)msg.a);
+    lua_pushnumber(L, (lua_Number)msg.b);
+    lua_pushnumber(L, (lua_Number)msg.c);
+    lua_pushnumber(L, (lua_Number)msg.d);
+    return 5;
+}
+
+static void set_int(lua_State* L, const char* name, int v) {
+    lua_pushinteger(L, v);
+    lua_setfield(L, -2, name);
+}
+
+void luax_open_events(lua_State* L) {
+    // events.<Name> = EPType value (for wait_event / on_event)
+    lua_newtable(L);
+    set_int(L, "InsetsChanged",  (int)rce::EPType::InsetsChanged);
+    set_int(L, "SurfaceResized", (int)rce::EPType::SurfaceResized);
+    set_int(L, "Gesture",        (int)rce::EPType::Gesture);
+    set_int(L, "Pointer",        (int)rce::EPType::Pointer);
+    lua_setfield(L, -2, "events");
+
+    lua_newtable(L);
+    set_int(L, "Tap",       (int)input::GestureKind::Tap);
+    set_int(L, "LongPress", (int)input::GestureKind::LongPress);
+    set_int(L, "Drag",      (int)input::GestureKind::Drag);
+    set_int(L, "Pinch",     (int)input::GestureKind::Pinch);
+    set_int(L, "Fling",     (int)input::GestureKind::Fling);
+    set_int(L, "Begin",     (int)input::GesturePhase::Begin);
+    set_int(L, "Update",    (int)input::GesturePhase::Update);
+    set_int(L, "End",       (int)input::GesturePhase::End);
+    set_int(L, "Cancel",    (int)input::GesturePhase::Cancel);
+    lua_setfield(L, -2, "gestures");
+
+    lua_newtable(L);
+    set_int(L, "Down",   (int)input::EventType::PointerDown);
+    set_int(L, "Up",     (int)input::EventType::PointerUp);
+    set_int(L, "Move",   (int)input::EventType::PointerMove);
+    set_int(L, "Cancel", (int)input::EventType::PointerCancel);
+    lua_setfield(L, -2, "pointers");
+}
@@ -0,0 +1,82 @@
+#include "luax/lua_gc.h"
+
+#include "app/time.h"
+
+extern "C" {
+#include "lua.h"
+}
+
+void LuaGcController::attach(lua_State* L) {
+    L_ = L;
+    stats_ = LuaGcStats{};
+    debt_kb_ = 0.0f;
+    if (!L_) return;
+
+    lua_gc(L_, LUA_GCSTOP, 0);
+    prev_heap_kb_ = (uint32_t)lua_gc(L_, LUA_GCCOUNT, 0);
+    stats_.heap_kb = prev_heap_kb_;
+    stats_.live_kb = prev_heap_kb_;
+}
+
+void LuaGcController::detach() {
+    if (L_) lua_gc(L_, LUA_GCRESTART, 0);
+    L_ = nullptr;
+}
+
+void LuaGcController::step_frame(uint64_t frame_start_ns) {
+    if (!L_) return;
+
+    const uint64_t t0 = rce::time_now_ns();
+
+    // Allocation since last frame (net of frees, which only happen via GC here).
+    const uint32_t heap_kb = (uint32_t)lua_gc(L_, LUA_GCCOUNT, 0);
+    const float alloc_kb = heap_kb > prev_heap_kb_ ? (float)(heap_kb - prev_heap_kb_) : 0.0f;
+    stats_.alloc_kb_per_frame += (alloc_kb - stats_.alloc_kb_per_frame) * 0.1f;
+    debt_kb_ += alloc_kb * cfg_.work_ratio;
+
+    // Time budget: what's left of the frame, clamped.
+    const uint64_t used_ns = t0 > frame_start_ns ? t0 - frame_start_ns : 0;
+    uint64_t budget_ns = cfg_.frame_budget_ns > used_ns ? cfg_.frame_budget_ns - used_ns : 0;
+    const uint64_t min_ns = (uint64_t)cfg_.min_pause_us * 1000ull;
+    const uint64_t max_ns = (uint64_t)cfg_.max_pause_us * 1000ull;
+
+    const bool emergency = stats_.live_kb > 0 &&
+        (float)heap_kb > (float)stats_.live_kb * cfg_.emergency_growth;
+    if (emergency) budget_ns = max_ns;
+    if (budget_ns < min_ns) budget_ns = min_ns;
+    if (budget_ns > max_ns) budget_ns = max_ns;
+
+    // Round a partial step of debt up to one whole step.
+    const float step_kb = (float)(cfg_.step_kb ? cfg_.step_kb : 1);
+    if (debt_kb_ < step_kb && !emergency) debt_kb_ = (debt_kb_ > 0.0f) ? step_kb : 0.0f;
+
+    uint32_t steps = 0;
+    uint64_t now = t0;
+    while ((debt_kb_ > 0.0f || emergency) && now - t0 < budget_ns) {
+        const int cycle_done = lua_gc(L_, LUA_GCSTEP, (int)step_kb);
+        steps++;
+        debt_kb_ -= step_kb;
+
+        if (cycle_done) {
+            stats_.cycles++;
+            stats_.live_kb = (uint32_t)lua_gc(L_, LUA_GCCOUNT, 0);
+            debt_kb_ = 0.0f;
+            break; // fresh cycle; the next frame picks up new debt
+        }
+        now = rce::time_now_ns();
+    }
+    if (debt_kb_ < 0.0f) debt_kb_ = 0.0f;
+
+    // LUA_GCSTEP re-arms the automatic threshold; keep the collector stopped.
+    lua_gc(L_, LUA_GCSTOP, 0);
+
+    const uint64_t spent = rce::time_now_ns() - t0;
+    prev_heap_kb_ = (uint32_t)lua_gc(L_, LUA_GCCOUNT, 0);
+
+    stats_.last_frame_ns = spent;
+    if (spent > stats_.max_frame_ns) stats_.max_frame_ns = spent;
+    stats_.total_ns += spent;
+    stats_.last_steps = steps;
+    stats_.total_steps += steps;
+    stats_.heap_kb = prev_heap_kb_;
+}
@@ -1,6 +1,11 @@
 #include "luax/lua_runtime.h"
+#include "luax/lua_bytecode_cache.h"
+#include "luax/lua_events.h"
+#include "luax/lua_serialize.h"
 
 #include "app/log.h"
+#include "app/paths.h"
+#include <cstdio>
 #include <string>
 
 extern "C" {
@@ -9,71 +14,302 @@ extern "C" {
 #include "lualib.h"
 }
 
-static int l_android_log(lua_State* L) {
-    int n = lua_gettop(L);
+// console_print output is batched: each call formats one line into this
+// per-thread buffer and the buffer goes to the log sink once per frame
+// (LuaRuntime::flush_console), or earlier when it grows past one log message.
+static thread_local std::string t_console;
+static constexpr size_t kConsoleFlushBytes = 3800; // under logcat's ~4KB message cap
 
-    std::string out;
-    out.reserve(256);
+static void console_flush() {
+    std::string& out = t_console;
+    if (out.empty()) return;
+    rce::log_write_raw(rce::LogLevel::Info, out.data(), out.size());
+    out.clear(); // keeps capacity
+}
 
-    // tostring is expected, but keep it robust.
-    lua_getglobal(L, "tostring");
-    bool have_tostring = lua_isfunction(L, -1);
+// console_print(...): tab-separated like print. Strings, numbers, booleans and
+// nil are formatted directly; anything else goes through the tostring captured
+// at registration (upvalue 1).
+static int l_console_print(lua_State* L) {
+    const int n = lua_gettop(L);
+    std::string& out = t_console;
 
+    out.append("[lua] ", 6);
     for (int i = 1; i <= n; i++) {
-        if (i > 1) out += "\t";
-
-        if (have_tostring) {
-            lua_pushvalue(L, -1); // tostring
-            lua_pushvalue(L, i);  // arg
-            lua_call(L, 1, 1);    // tostring(arg)
-
-            size_t len = 0;
-            const char* s = lua_tolstring(L, -1, &len);
-            if (s && len) out.append(s, len);
-            else out += "(value)";
-
-            lua_pop(L, 1); // pop tostring result
-        } else {
-            // Fallback: best-effort type name
-            out += luaL_typename(L, i);
+        if (i > 1) out.push_back('\t');
+
+        switch (lua_type(L, i)) {
+            case LUA_TSTRING: {
+                size_t len = 0;
+                const char* s = lua_tolstring(L, i, &len);
+                out.append(s, len);
+                break;
+            }
+            case LUA_TNUMBER: {
+                char tmp[LUAI_MAXNUMBER2STR];
+                const int len = std::snprintf(tmp, sizeof(tmp), LUA_NUMBER_FMT, lua_tonumber(L, i));
+                out.append(tmp, (size_t)len);
+                break;
+            }
+            case LUA_TBOOLEAN:
+                if (lua_toboolean(L, i)) out.append("true", 4);
+                else out.append("false", 5);
+                break;
+            case LUA_TNIL:
+                out.append("nil", 3);
+                break;
+            default: {
+                if (!lua_isfunction(L, lua_upvalueindex(1))) {
+                    out += luaL_typename(L, i);
+                    break;
+                }
+                lua_pushvalue(L, lua_upvalueindex(1)); // tostring
+                lua_pushvalue(L, i);
+                lua_call(L, 1, 1);
+                size_t len = 0;
+                const char* s = lua_tolstring(L, -1, &len);
+                if (s) out.append(s, len);
+                else out += "(value)";
+                lua_pop(L, 1);
+                break;
+            }
         }
     }
+    out.push_back('\n');
 
-    lua_pop(L, 1); // pop tostring / non-function
+    if (out.size() >= kConsoleFlushBytes) console_flush();
+    return 0;
+}
 
-    // Keep everything under your app tag so your existing filter catches it.
-    LOGI("[lua] %s", out.c_str());
+// Same role as lauxlib's panic handler (luaL_newstate installs that one).
+static int l_panic(lua_State* L) {
+    const char* err = lua_tostring(L, -1);
+    LOGE("PANIC: unprotected error in call to Lua API (%s)", err ? err : "(unknown)");
+    rce::log_flush(); // Lua exits the process right after this
     return 0;
 }
 
-bool luax_run_file(const char* path) {
-    if (!path || !*path) {
-        LOGE("luax_run_file: invalid path");
-        return false;
-    }
+LuaRuntime::~LuaRuntime() {
+    shutdown();
+}
+
+bool LuaRuntime::init() {
+    if (L_) return true;
 
-    lua_State* L = luaL_newstate();
+    lua_State* L = lua_newstate(LuaPoolAllocator::lua_alloc, &alloc_);
     if (!L) {
-        LOGE("Lua: luaL_newstate failed");
+        LOGE("Lua: lua_newstate failed");
+        alloc_.release();
         return false;
     }
+    lua_atpanic(L, l_panic);
 
     luaL_openlibs(L);
 
+    L_ = L;
+
+    // require() goes through the bytecode cache as well.
+    luax_install_cached_loader(L);
+
+    // pcall message handler, cached so hook calls never look anything up by name.
+    lua_getglobal(L, "debug");
+    lua_getfield(L, -1, "traceback");
+    lua_remove(L, -2);
+    set_hook(ref_traceback_, -1);
+    lua_pop(L, 1);
+
     // You chose console_print() instead of overriding print().
-    lua_pushcfunction(L, l_android_log);
+    lua_getglobal(L, "tostring");
+    lua_pushcclosure(L, l_console_print, 1);
     lua_setglobal(L, "console_print");
 
-    int rc = luaL_dofile(L, path);
+    // rce.* engine bindings; `this` rides along as an upvalue.
+    lua_newtable(L);
+    lua_pushlightuserdata(L, this);
+    lua_pushcclosure(L, l_set_on_tick, 1);
+    lua_setfield(L, -2, "on_tick");
+    lua_pushlightuserdata(L, this);
+    lua_pushcclosure(L, l_set_on_event, 1);
+    lua_setfield(L, -2, "on_event");
+    lua_pushlightuserdata(L, this);
+    lua_pushcclosure(L, l_mem_stats, 1);
+    lua_setfield(L, -2, "mem_stats");
+    lua_pushlightuserdata(L, this);
+    lua_pushcclosure(L, l_gc_stats, 1);
+    lua_setfield(L, -2, "gc_stats");
+
+    luax_open_events(L);    // rce.events / rce.gestures
+    luax_open_serialize(L); // rce.serialize / rce.deserialize
+    lua_setglobal(L, "rce");
+
+    sched_.attach(L);
+
+    gc_.attach(L);
+    return true;
+}
+
+void LuaRuntime::shutdown() {
+    if (!L_) return;
+    console_flush();
+    sched_.detach();
+    gc_.detach();
+    lua_close(L_);
+    L_ = nullptr;
+    alloc_.release();
+    ref_on_tick_ = kNoRef;
+    ref_on_event_ = kNoRef;
+    ref_traceback_ = kNoRef;
+}
+
+void LuaRuntime::flush_console() {
+    console_flush();
+}
+
+void LuaRuntime::set_hook(int& ref, int idx) {
+    luaL_unref(L_, LUA_REGISTRYINDEX, ref);
+    ref = kNoRef;
+    if (lua_isfunction(L_, idx)) {
+        lua_pushvalue(L_, idx);
+        ref = luaL_ref(L_, LUA_REGISTRYINDEX);
+    }
+}
+
+int LuaRuntime::l_set_on_tick(lua_State* L) {
+    auto* self = (LuaRuntime*)lua_touserdata(L, lua_upvalueindex(1));
+    if (!lua_isnoneornil(L, 1)) luaL_checktype(L, 1, LUA_TFUNCTION);
+    self->set_hook(self->ref_on_tick_, 1);
+    return 0;
+}
+
+int LuaRuntime::l_set_on_event(lua_State* L) {
+    auto* self = (LuaRuntime*)lua_touserdata(L, lua_upvalueindex(1));
+    if (!lua_isnoneornil(L, 1)) luaL_checktype(L, 1, LUA_TFUNCTION);
+    self->set_hook(self->ref_on_event_, 1);
+    return 0;
+}
+
+// rce.mem_stats() -> { bytes, peak, allocs, frees, reallocs, large_allocs, reserved }
+int LuaRuntime::l_mem_stats(lua_State* L) {
+    auto* self = (LuaRuntime*)lua_touserdata(L, lua_upvalueindex(1));
+    const LuaAllocStats& s = self->alloc_.stats();
+
+    lua_createtable(L, 0, 7);
+    lua_pushnumber(L, (lua_Number)s.bytes_in_use);  lua_setfield(L, -2, "bytes");
+    lua_pushnumber(L, (lua_Number)s.peak_bytes);    lua_setfield(L, -2, "peak");
+    lua_pushnumber(L, (lua_Number)s.allocs);        lua_setfield(L, -2, "allocs");
+    lua_pushnumber(L, (lua_Number)s.frees);         lua_setfield(L, -2, "frees");
+    lua_pushnumber(L, (lua_Number)s.reallocs);      lua_setfield(L, -2, "reallocs");
+    lua_pushnumber(L, (lua_Number)s.large_allocs);  lua_setfield(L, -2, "large_allocs");
+    lua_pushnumber(L, (lua_Number)s.pool_reserved); lua_setfield(L, -2, "reserved");
+    return 1;
+}
+
+// rce.gc_stats() -> { last_us, max_us, total_us, steps, cycles, heap_kb, live_kb, alloc_kb_per_frame }
+int LuaRuntime::l_gc_stats(lua_State* L) {
+    auto* self = (LuaRuntime*)lua_touserdata(L, lua_upvalueindex(1));
+    const LuaGcStats& s = self->gc_.stats();
+
+    lua_createtable(L, 0, 8);
+    lua_pushnumber(L, (lua_Number)s.last_frame_ns / 1000.0); lua_setfield(L, -2, "last_us");
+    lua_pushnumber(L, (lua_Number)s.max_frame_ns / 1000.0);  lua_setfield(L, -2, "max_us");
+    lua_pushnumber(L, (lua_Number)s.total_ns / 1000.0);      lua_setfield(L, -2, "total_us");
+    lua_pushnumber(L, (lua_Number)s.total_steps);            lua_setfield(L, -2, "steps");
+    lua_pushnumber(L, (lua_Number)s.cycles);                 lua_setfield(L, -2, "cycles");
+    lua_pushnumber(L, (lua_Number)s.heap_kb);                lua_setfield(L, -2, "heap_kb");
+    lua_pushnumber(L, (lua_Number)s.live_kb);                lua_setfield(L, -2, "live_kb");
+    lua_pushnumber(L, (lua_Number)s.alloc_kb_per_frame);     lua_setfield(L, -2, "alloc_kb_per_frame");
+    return 1;
+}
+
+// Expects function + nargs on top of the stack.
+bool LuaRuntime::pcall(int nargs, const char* what) {
+    int errfunc = 0;
+    if (ref_traceback_ != kNoRef) {
+        // Slide the handler in below the function.
+        errfunc = lua_gettop(L_) - nargs;
+        lua_rawgeti(L_, LUA_REGISTRYINDEX, ref_traceback_);
+        lua_insert(L_, errfunc);
+    }
+
+    const int rc = lua_pcall(L_, nargs, 0, errfunc);
     if (rc != 0) {
-        const char* err = lua_tostring(L, -1);
+        console_flush(); // keep script output ahead of the error in the log
+        const char* err = lua_tostring(L_, -1);
+        LOGE("Lua error in %s: %s", what, err ? err : "(unknown)");
+        lua_pop(L_, 1);
+    }
+    if (errfunc) lua_remove(L_, errfunc);
+    return rc == 0;
+}
+
+bool LuaRuntime::load_entry(const char* path) {
+    if (!path || !*path) {
+        LOGE("LuaRuntime::load_entry: invalid path");
+        return false;
+    }
+    if (!L_ && !init()) return false;
+
+    // Modules next to the entry script resolve first: "<dir>/?.lua;" + package.path
+    const std::string dir = app::paths::dirname(path);
+    if (!dir.empty()) {
+        lua_getglobal(L_, "package");
+        if (lua_istable(L_, -1)) {
+            lua_getfield(L_, -1, "path");
+            const char* old = lua_tostring(L_, -1);
+            std::string np = app::paths::join(dir, "?.lua");
+            if (old) { np += ";"; np += old; }
+            lua_pop(L_, 1);
+            lua_pushlstring(L_, np.data(), np.size());
+            lua_setfield(L_, -2, "path");
+        }
+        lua_pop(L_, 1);
+    }
+
+    if (luax_loadfile_cached(L_, path) != 0) {
+        const char* err = lua_tostring(L_, -1);
         LOGE("Lua error: %s", err ? err : "(unknown)");
-        lua_pop(L, 1);
-        lua_close(L);
+        lua_pop(L_, 1);
         return false;
     }
+    if (!pcall(0, path)) return false;
 
+    // Fall back to global hooks if the script didn't register any.
+    if (ref_on_tick_ == kNoRef) {
+        lua_getglobal(L_, "on_tick");
+        set_hook(ref_on_tick_, -1);
+        lua_pop(L_, 1);
+    }
+    if (ref_on_event_ == kNoRef) {
+        lua_getglobal(L_, "on_event");
+        set_hook(ref_on_event_, -1);
+        lua_pop(L_, 1);
+    }
+
+    console_flush();
     LOGI("Lua executed OK: %s", path);
-    lua_close(L);
     return true;
 }
+
+void LuaRuntime::tick(float dt_s) {
+    if (!L_ || ref_on_tick_ == kNoRef) return;
+
+    lua_rawgeti(L_, LUA_REGISTRYINDEX, ref_on_tick_);
+    lua_pushnumber(L_, (lua_Number)dt_s);
+    if (!pcall(1, "on_tick")) {
+        LOGE("on_tick disabled after error");
+        luaL_unref(L_, LUA_REGISTRYINDEX, ref_on_tick_);
+        ref_on_tick_ = kNoRef;
+    }
+}
+
+void LuaRuntime::dispatch_event(const rce::EPMsg& msg) {
+    if (!L_ || ref_on_event_ == kNoRef) return;
+
+    lua_rawgeti(L_, LUA_REGISTRYINDEX, ref_on_event_);
+    const int nargs = luax_push_event(L_, msg);
+    if (!pcall(nargs, "on_event")) {
+        LOGE("on_event disabled after error");
+        luaL_unref(L_, LUA_REGISTRYINDEX, ref_on_event_);
+        ref_on_event_ = kNoRef;
+    }
+}
@@ -0,0 +1,165 @@
+#include "luax/lua_scheduler.h"
+#include "luax/lua_events.h"
+
+#include "app/log.h"
+
+extern "C" {
+#include "lua.h"
+#include "lauxlib.h"
+}
+
+static LuaScheduler* self_of(lua_State* L) {
+    return (LuaScheduler*)lua_touserdata(L, lua_upvalueindex(1));
+}
+
+void LuaScheduler::attach(lua_State* L) {
+    L_ = L;
+    errors_ = 0;
+
+    lua_pushlightuserdata(L, this);
+    lua_pushcclosure(L, l_spawn, 1);
+    lua_setglobal(L, "spawn");
+
+    lua_pushlightuserdata(L, this);
+    lua_pushcclosure(L, l_wait, 1);
+    lua_setglobal(L, "wait");
+
+    lua_pushlightuserdata(L, this);
+    lua_pushcclosure(L, l_wait_event, 1);
+    lua_setglobal(L, "wait_event");
+}
+
+void LuaScheduler::detach() {
+    for (auto& kv : tasks_) {
+        if (kv.second.timer) rce::timers_cancel(kv.second.timer);
+    }
+    tasks_.clear();
+
+    for (uint32_t i = 0; i < rce::EP_TYPE_COUNT; i++) {
+        rce::ep_unsubscribe(subs_[i]);
+        subs_[i] = 0;
+        event_waiters_[i].clear();
+        woken_[i].clear();
+    }
+    L_ = nullptr;
+}
+
+void LuaScheduler::resume(lua_State* co, int nargs) {
+    auto it = tasks_.find(co);
+    if (it == tasks_.end()) return;
+    it->second.parked = false;
+
+    const int rc = lua_resume(co, nargs);
+
+    // The task table may have been rehashed by spawns inside the coroutine.
+    it = tasks_.find(co);
+    if (it == tasks_.end()) return;
+
+    if (rc == LUA_YIELD) {
+        if (!it->second.parked) park_timer(co, it->second, 0.0f); // plain coroutine.yield()
+        return;
+    }
+
+    if (rc != 0) {
+        const char* err = lua_tostring(co, -1);
+        LOGE("Lua error in spawned coroutine: %s", err ? err : "(unknown)");
+        errors_++;
+    }
+    release(co);
+}
+
+void LuaScheduler::release(lua_State* co) {
+    auto it = tasks_.find(co);
+    if (it == tasks_.end()) return;
+    if (it->second.timer) rce::timers_cancel(it->second.timer);
+    if (L_) luaL_unref(L_, LUA_REGISTRYINDEX, it->second.ref);
+    tasks_.erase(it);
+}
+
+void LuaScheduler::park_timer(lua_State* co, Task& t, float seconds) {
+    t.timer = rce::timers_after(seconds, [this, co](rce::TimerId) { on_timer(co); });
+    t.parked = true;
+}
+
+void LuaScheduler::on_timer(lua_State* co) {
+    auto it = tasks_.find(co);
+    if (it == tasks_.end()) return;
+    it->second.timer = 0;
+    resume(co, 0);
+}
+
+void LuaScheduler::on_event(uint32_t ti, const rce::EPMsg& msg) {
+    std::vector<lua_State*>& list = event_waiters_[ti];
+    if (list.empty()) return;
+
+    // Take the current waiters; anything that waits again lands in the list
+    // swapped in from the scratch. Both buffers keep their capacity, so
+    // steady-state waiting doesn't allocate.
+    std::vector<lua_State*>& woken = woken_[ti];
+    woken.swap(list);
+
+    for (lua_State* co : woken) {
+        auto it = tasks_.find(co);
+        if (it == tasks_.end() || it->second.waiting != ti) continue;
+        it->second.waiting = kNotWaiting;
+
+        resume(co, luax_push_event(co, msg));
+    }
+    woken.clear();
+}
+
+int LuaScheduler::l_spawn(lua_State* L) {
+    LuaScheduler* self = self_of(L);
+    luaL_checktype(L, 1, LUA_TFUNCTION);
+    const int nargs = lua_gettop(L) - 1;
+
+    lua_State* co = lua_newthread(L);
+    const int ref = luaL_ref(L, LUA_REGISTRYINDEX); // pops the thread, keeps it alive
+
+    lua_checkstack(co, nargs + 1);
+    for (int i = 1; i <= nargs + 1; i++) lua_pushvalue(L, i);
+    lua_xmove(L, co, nargs + 1);
+
+    Task t;
+    t.ref = ref;
+    self->tasks_[co] = t;
+    self->resume(co, nargs);
+    return 0;
+}
+
+int LuaScheduler::l_wait(lua_State* L) {
+    LuaScheduler* self = self_of(L);
+    auto it = self->tasks_.find(L);
+    if (it == self->tasks_.end()) {
+        return luaL_error(L, "wait() must be called from a coroutine started with spawn()");
+    }
+
+    const lua_Number s = luaL_optnumber(L, 1, 0);
+    self->park_timer(L, it->second, s > 0 ? (float)s : 0.0f);
+    return lua_yield(L, 0);
+}
+
+int LuaScheduler::l_wait_event(lua_State* L) {
+    LuaScheduler* self = self_of(L);
+    auto it = self->tasks_.find(L);
+    if (it == self->tasks_.end()) {
+        return luaL_error(L, "wait_event() must be called from a coroutine started with spawn()");
+    }
+
+    const rce::EPType type = (rce::EPType)luaL_checkinteger(L, 1);
+    const uint32_t ti = rce::ep_type_index(type);
+    if (ti >= rce::EP_TYPE_COUNT) return luaL_argerror(L, 1, "unknown event type");
+
+    // One dispatcher listener per type, shared by every waiter.
+    if (!self->subs_[ti]) {
+        self->subs_[ti] = rce::ep_subscribe(type, [self, ti](const rce::EPMsg& msg) {
+            self->on_event(ti, msg);
+        });
+        if (!self->subs_[ti]) return luaL_error(L, "wait_event(): no free listener slot");
+    }
+
+    self->event_waiters_[ti].push_back(L);
+    it->second.waiting = ti;
+    it->second.parked = true;
+    return lua_yield(L, 0);
+}
@@ -0,0 +1,477 @@
+#include "luax/lua_serialize.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+extern "C" {
+#include "lua.h"
+#include "lauxlib.h"
+}
+
+// ---- Binary layout
+// "RCS" version, then one value:
+//   NIL | FALSE | TRUE
+//   INT    zigzag varint (integral numbers that fit a double exactly)
+//   NUM    8 raw bytes (IEEE double, little-endian hosts only)
+//   STR    varint length, bytes
+//   TABLE  (key value)* END     -- gets the next table id (0, 1, 2...)
+//   REF    varint id            -- a table written earlier
+enum : uint8_t { T_NIL, T_FALSE, T_TRUE, T_INT, T_NUM, T_STR, T_TABLE, T_REF, T_END };
+
+static constexpr char kMagic[3] = { 'R', 'C', 'S' };
+static constexpr uint8_t kVersion = 1;
+
+// Sort record for one key. Strings point into the table's own key, which
+// stays alive (and unmoved) for as long as the table isn't modified.
+struct KeyEntry {
+    int kind;                // 0 number, 1 string, 2 boolean
+    lua_Number num;
+    const char* str;
+    size_t len;
+};
+
+static bool key_less(const KeyEntry& a, const KeyEntry& b) {
+    if (a.kind != b.kind) return a.kind < b.kind;
+    if (a.kind == 1) {
+        const size_t n = a.len < b.len ? a.len : b.len;
+        const int c = std::memcmp(a.str, b.str, n);
+        return c != 0 ? c < 0 : a.len < b.len;
+    }
+    return a.num < b.num;
+}
+
+namespace {
+
+struct Writer {
+    lua_State* L;
+    const LuaSerializeOptions& opts;
+    std::string& out;
+    std::vector<KeyEntry>& keys;                      // shared by every nesting level
+    std::unordered_map<const void*, uint32_t>& seen;  // table -> id
+    const char* error = nullptr;
+
+    void put(uint8_t b) { out.push_back((char)b); }
+    void put(const char* s, size_t n) { out.append(s, n); }
+    void put(const char* s) { out.append(s); }
+
+    void varint(uint64_t v) {
+        while (v >= 0x80) { put((uint8_t)(v | 0x80)); v >>= 7; }
+        put((uint8_t)v);
+    }
+
+    void indent(uint32_t depth) { out.append(depth, '\t'); }
+
+    void text_number(lua_Number n) {
+        char tmp[32];
+        const int len = std::snprintf(tmp, sizeof(tmp), LUA_NUMBER_FMT, n);
+        put(tmp, (size_t)len);
+    }
+
+    void text_string(const char* s, size_t len) {
+        put('"');
+        const char* run = s;
+        for (size_t i = 0; i < len; i++) {
+            const char c = s[i];
+            const char* esc = nullptr;
+            switch (c) {
+                case '"':  esc = "\\\""; break;
+                case '\\': esc = "\\\\"; break;
+                case '\n': esc = "\\n"; break;
+                case '\r': esc = "\\r"; break;
+                case '\0': esc = "\\0"; break;
+                default: continue;
+            }
+            put(run, (size_t)(s + i - run));
+            put(esc);
+            run = s + i + 1;
+        }
+        put(run, (size_t)(s + len - run));
+        put('"');
+    }
+
+    static bool is_identifier(const char* s, size_t len) {
+        if (len == 0) return false;
+        const unsigned char c0 = (unsigned char)s[0];
+        if (!(c0 == '_' || (unsigned)((c0 | 0x20) - 'a') < 26u)) return false;
+        for (size_t i = 1; i < len; i++) {
+            const unsigned char c = (unsigned char)s[i];
+            if (!(c == '_' || (unsigned)((c | 0x20) - 'a') < 26u || (unsigned)(c - '0') < 10u)) return false;
+        }
+        return true;
+    }
+
+    static bool is_data(int t) {
+        return t == LUA_TNIL || t == LUA_TBOOLEAN || t == LUA_TNUMBER ||
+               t == LUA_TSTRING || t == LUA_TTABLE;
+    }
+
+    // ---- binary
+
+    void bin_value(int idx, uint32_t depth) {
+        switch (lua_type(L, idx)) {
+            case LUA_TBOOLEAN: put(lua_toboolean(L, idx) ? T_TRUE : T_FALSE); break;
+            case LUA_TNUMBER: {
+                const lua_Number n = lua_tonumber(L, idx);
+                const double lim = 9007199254740992.0; // 2^53
+                // Range first: converting NaN, inf or |n| >= 2^63 to int64_t is UB.
+                if (n > -lim && n < lim && n == (lua_Number)(int64_t)n && !(n == 0 && std::signbit(n))) {
+                    const int64_t v = (int64_t)n;
+                    put(T_INT);
+                    varint(((uint64_t)v << 1) ^ (uint64_t)(v >> 63));
+                } else {
+                    put(T_NUM);
+                    put((const char*)&n, sizeof(double));
+                }
+                break;
+            }
+            case LUA_TSTRING: {
+                size_t len;
+                const char* s = lua_tolstring(L, idx, &len);
+                put(T_STR);
+                varint(len);
+                put(s, len);
+                break;
+            }
+            case LUA_TTABLE: bin_table(idx, depth); break;
+            default: put(T_NIL); break;
+        }
+    }
+
+    void bin_pair(int kidx, int vidx, uint32_t depth) {
+        if (!is_data(lua_type(L, vidx)) || lua_isnil(L, vidx)) return;
+        bin_value(kidx, depth + 1);
+        bin_value(vidx, depth + 1);
+    }
+
+    void bin_table(int idx, uint32_t depth) {
+        const void* p = lua_topointer(L, idx);
+        auto it = seen.find(p);
+        if (it != seen.end()) {
+            put(T_REF);
+            varint(it->second);
+            return;
+        }
+        if (depth >= opts.max_depth) {
+            if (!error) error = "nesting too deep";
+            put(T_NIL);
+            return;
+        }
+        seen.emplace(p, (uint32_t)seen.size());
+        lua_checkstack(L, 4);
+
+        put(T_TABLE);
+        for_each_sorted(idx, depth, [this](int k, int v, uint32_t d) { bin_pair(k, v, d); },
+                        [this](int k) { return is_data(lua_type(L, k)); });
+        put(T_END);
+    }
+
+    // ---- text (spickle layout)
+
+    void text_key(int kidx) {
+        if (lua_type(L, kidx) == LUA_TSTRING) {
+            size_t len;
+            const char* s = lua_tolstring(L, kidx, &len);
+            if (is_identifier(s, len)) { put(s, len); return; }
+            put('[');
+            text_string(s, len);
+            put(']');
+            return;
+        }
+        put('[');
+        switch (lua_type(L, kidx)) {
+            case LUA_TNUMBER: text_number(lua_tonumber(L, kidx)); break;
+            case LUA_TBOOLEAN: put(lua_toboolean(L, kidx) ? "true" : "false"); break;
+            default: put('<'); put(lua_typename(L, lua_type(L, kidx))); put('>'); break;
+        }
+        put(']');
+    }
+
+    void text_pair(int kidx, int vidx, uint32_t depth) {
+        const int t = lua_type(L, vidx);
+        if (t == LUA_TTABLE) {
+            indent(depth + 1);
+            text_key(kidx);
+            put(" = \n");
+            text_table(vidx, depth + 1);
+            indent(depth + 1);
+            put(",\n");
+            return;
+        }
+        if (!is_data(t) && opts.hide_non_text) return;
+
+        indent(depth + 1);
+        text_key(kidx);
+        put(" = ");
+        text_scalar(vidx);
+        put(",\n");
+    }
+
+    void text_scalar(int vidx) {
+        const int t = lua_type(L, vidx);
+        switch (t) {
+            case LUA_TSTRING: {
+                size_t len;
+                const char* s = lua_tolstring(L, vidx, &len);
+                text_string(s, len);
+                break;
+            }
+            case LUA_TNUMBER: text_number(lua_tonumber(L, vidx)); break;
+            case LUA_TBOOLEAN: put(lua_toboolean(L, vidx) ? "true" : "false"); break;
+            case LUA_TNIL: put("nil"); break;
+            default: put('<'); put(lua_typename(L, t)); put('>'); break;
+        }
+    }
+
+    void text_table(int idx, uint32_t depth) {
+        const void* p = lua_topointer(L, idx);
+        if (seen.count(p) || depth >= opts.max_depth) {
+            indent(depth);
+            put(seen.count(p) ? "<circular reference>\n" : "<max depth>\n");
+            return;
+        }
+        seen.emplace(p, (uint32_t)seen.size());
+        lua_checkstack(L, 4);
+
+        indent(depth);
+        put("{\n");
+        for_each_sorted(idx, depth, [this](int k, int v, uint32_t d) { text_pair(k, v, d); },
+                        [this](int k) { return !opts.hide_non_text || is_data(lua_type(L, k)); });
+        indent(depth);
+        put("}\n");
+    }
+
+    // Calls fn(key_idx, value_idx, depth) for every pair in key order.
+    // Number/string/boolean keys are sorted; other keys (tables, functions...)
+    // have no stable order and follow in traversal order, if keep_other(k) allows.
+    template <typename Fn, typename Keep>
+    void for_each_sorted(int idx, uint32_t depth, Fn fn, Keep keep_other) {
+        if (idx < 0) idx = lua_gettop(L) + idx + 1;
+        const size_t base = keys.size();
+
+        lua_pushnil(L);
+        while (lua_next(L, idx)) {
+            KeyEntry e{};
+            switch (lua_type(L, -2)) {
+                case LUA_TNUMBER:  e.kind = 0; e.num = lua_tonumber(L, -2); break;
+                case LUA_TSTRING:  e.kind = 1; e.str = lua_tolstring(L, -2, &e.len); break;
+                case LUA_TBOOLEAN: e.kind = 2; e.num = lua_toboolean(L, -2); break;
+                default: e.kind = -1; break;
+            }
+            if (e.kind >= 0) keys.push_back(e);
+            lua_pop(L, 1);
+        }
+        std::sort(keys.begin() + (ptrdiff_t)base, keys.end(), key_less);
+
+        // keys may grow (nested tables), so index rather than iterate
+        const size_t end = keys.size();
+        for (size_t i = base; i < end; i++) {
+            const KeyEntry e = keys[i];
+            switch (e.kind) {
+                case 0: lua_pushnumber(L, e.num); break;
+                case 1: lua_pushlstring(L, e.str, e.len); break; // interned: already exists
+                default: lua_pushboolean(L, e.num != 0); break;
+            }
+            lua_pushvalue(L, -1);
+            lua_rawget(L, idx);
+            fn(lua_gettop(L) - 1, lua_gettop(L), depth);
+            lua_pop(L, 2);
+        }
+        keys.resize(base);
+
+        lua_pushnil(L);
+        while (lua_next(L, idx)) {
+            const int kt = lua_type(L, -2);
+            if (kt != LUA_TNUMBER && kt != LUA_TSTRING && kt != LUA_TBOOLEAN && keep_other(-2)) {
+                fn(lua_gettop(L) - 1, lua_gettop(L), depth);
+            }
+            lua_pop(L, 1);
+        }
+    }
+};
+
+struct Reader {
+    lua_State* L;
+    const uint8_t* p;
+    const uint8_t* end;
+    int refs;              // stack index of the id -> table array
+    int nrefs = 0;
+    const char* error = nullptr;
+
+    bool fail(const char* msg) { if (!error) error = msg; return false; }
+
+    bool varint(uint64_t* out) {
+        uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (p >= end) return fail("truncated varint");
+            const uint8_t b = *p++;
+            v |= (uint64_t)(b & 0x7F) << shift;
+            if (!(b & 0x80)) { *out = v; return true; }
+        }
+        return fail("bad varint");
+    }
+
+    // Pushes one value (or returns false with nothing pushed).
+    bool value(uint32_t depth) {
+        if (p >= end) return fail("truncated data");
+        if (!lua_checkstack(L, 3)) return fail("stack overflow");
+        switch (*p++) {
+            case T_NIL:   lua_pushnil(L); return true;
+            case T_FALSE: lua_pushboolean(L, 0); return true;
+            case T_TRUE:  lua_pushboolean(L, 1); return true;
+            case T_INT: {
+                uint64_t z;
+                if (!varint(&z)) return false;
+                const int64_t v = (int64_t)(z >> 1) ^ -(int64_t)(z & 1);
+                lua_pushnumber(L, (lua_Number)v);
+                return true;
+            }
+            case T_NUM: {
+                double n;
+                if ((size_t)(end - p) < sizeof(n)) return fail("truncated number");
+                std::memcpy(&n, p, sizeof(n));
+                p += sizeof(n);
+                lua_pushnumber(L, (lua_Number)n);
+                return true;
+            }
+            case T_STR: {
+                uint64_t len;
+                if (!varint(&len)) return false;
+                if ((uint64_t)(end - p) < len) return fail("truncated string");
+                lua_pushlstring(L, (const char*)p, (size_t)len);
+                p += len;
+                return true;
+            }
+            case T_REF: {
+                uint64_t id;
+                if (!varint(&id)) return false;
+                if (id >= (uint64_t)nrefs) return fail("bad table reference");
+                lua_rawgeti(L, refs, (int)id + 1);
+                return true;
+            }
+            case T_TABLE: {
+                if (depth >= 200) return fail("nesting too deep");
+                lua_newtable(L);
+                lua_pushvalue(L, -1);
+                lua_rawseti(L, refs, ++nrefs);
+                for (;;) {
+                    if (p >= end) { lua_pop(L, 1); return fail("unterminated table"); }
+                    if (*p == T_END) { p++; return true; }
+                    if (!value(depth + 1)) { lua_pop(L, 1); return false; }
+                    if (lua_isnil(L, -1)) { lua_pop(L, 2); return fail("nil table key"); }
+                    // lua_rawset raises on a NaN key, and the longjmp would skip our destructors.
+                    if (lua_type(L, -1) == LUA_TNUMBER && std::isnan(lua_tonumber(L, -1))) {
+                        lua_pop(L, 2);
+                        return fail("NaN table key");
+                    }
+                    if (!value(depth + 1)) { lua_pop(L, 2); return false; }
+                    lua_rawset(L, -3);
+                }
+            }
+            default: return fail("unknown tag");
+        }
+    }
+};
+
+} // namespace
+
+bool luax_serialize(lua_State* L, int idx, const LuaSerializeOptions& opts,
+                    std::string& out, std::string* err) {
+    if (idx < 0) idx = lua_gettop(L) + idx + 1;
+
+    // Scratch survives between calls so a steady stream of dumps doesn't allocate.
+    static std::vector<KeyEntry> s_keys;
+    static std::unordered_map<const void*, uint32_t> s_seen;
+    s_seen.clear();
+
+    Writer w{ L, opts, out, s_keys, s_seen };
+    if (opts.format == LuaSerializeFormat::Binary) {
+        w.put(kMagic, sizeof(kMagic));
+        w.put(kVersion);
+        w.bin_value(idx, 0);
+    } else if (lua_istable(L, idx)) {
+        w.text_table(idx, 0);
+    } else {
+        w.text_scalar(idx);
+        w.put('\n');
+    }
+    s_keys.clear();
+
+    if (w.error) {
+        if (err) *err = w.error;
+        return false;
+    }
+    return true;
+}
+
+bool luax_deserialize(lua_State* L, const char* data, size_t len, std::string* err) {
+    if (len < sizeof(kMagic) + 1 || std::memcmp(data, kMagic, sizeof(kMagic)) != 0) {
+        if (err) *err = "not a serialized buffer";
+        return false;
+    }
+    if ((uint8_t)data[sizeof(kMagic)] != kVersion) {
+        if (err) *err = "unsupported version";
+        return false;
+    }
+
+    lua_newtable(L); // id -> table
+    Reader r{ L, (const uint8_t*)data + sizeof(kMagic) + 1, (const uint8_t*)data + len, lua_gettop(L) };
+    const bool ok = r.value(0) && (r.p == r.end || r.fail("trailing bytes"));
+    if (!ok) {
+        lua_settop(L, r.refs - 1);
+        if (err) *err = r.error ? r.error : "decode failed";
+        return false;
+    }
+    lua_remove(L, r.refs);
+    return true;
+}
+
+// ---- Lua bindings
+
+static int l_serialize(lua_State* L) {
+    luaL_checkany(L, 1);
+    LuaSerializeOptions opts;
+    if (lua_istable(L, 2)) {
+        lua_getfield(L, 2, "format");
+        const char* fmt = lua_tostring(L, -1);
+        if (fmt && std::strcmp(fmt, "text") == 0) opts.format = LuaSerializeFormat::Text;
+        else if (fmt && std::strcmp(fmt, "binary") != 0) return luaL_argerror(L, 2, "format must be \"binary\" or \"text\"");
+        lua_getfield(L, 2, "hide_non_text");
+        opts.hide_non_text = lua_toboolean(L, -1) != 0;
+        lua_pop(L, 2);
+    }
+
+    static std::string s_buf; // one growable buffer, reused
+    s_buf.clear();
+    char msg[128] = "";
+    {
+        std::string err;
+        if (!luax_serialize(L, 1, opts, s_buf, &err)) std::snprintf(msg, sizeof(msg), "%s", err.c_str());
+    }
+    // luaL_error longjmps, so nothing with a destructor may be alive here.
+    if (msg[0]) return luaL_error(L, "serialize: %s", msg);
+    lua_pushlstring(L, s_buf.data(), s_buf.size());
+    return 1;
+}
+
+static int l_deserialize(lua_State* L) {
+    size_t len;
+    const char* data = luaL_checklstring(L, 1, &len);
+    std::string err;
+    if (!luax_deserialize(L, data, len, &err)) {
+        lua_pushnil(L);
+        lua_pushstring(L, err.c_str());
+        return 2;
+    }
+    return 1;
+}
+
+void luax_open_serialize(lua_State* L) {
+    lua_pushcfunction(L, l_serialize);
+    lua_setfield(L, -2, "serialize");
+    lua_pushcfunction(L, l_deserialize);
+    lua_setfield(L, -2, "deserialize");
+}
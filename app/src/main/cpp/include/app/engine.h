@@ -1,8 +1,35 @@
 #pragma once
+#include <stdint.h>
+#include "app/time.h"
+
+class LuaRuntime;
+class RenderCommandBuffer;
 
 namespace rce {
 
 void engine_init();
-void engine_tick(float dt);
+void engine_shutdown();
+
+// Loads the entry script into the engine's persistent Lua VM (once).
+bool engine_load_script(const char* path);
+LuaRuntime& engine_lua();
+
+// This frame's render commands. Recycled at the start of engine_tick; systems
+// record into it during the tick, the platform adds its present pass after
+// engine_tick and submits it to the renderer.
+RenderCommandBuffer& engine_render_commands();
+
+// Runs once per rendered frame: dispatches events, then 0..max_steps fixed
+// simulation steps (game logic + timers) for the elapsed dt.
+void engine_tick(uint64_t dt_ns);
+
+// Simulation step configuration (default 60 Hz, 5 catch-up steps).
+void engine_set_fixed_step(const FixedStepConfig& cfg);
+
+// Leftover fraction of a step after the last engine_tick, for render interpolation.
+float engine_interp_alpha();
+
+// Total simulated time (advances in whole fixed steps).
+uint64_t engine_sim_time_ns();
 
 }
@@ -1,14 +1,79 @@
 #pragma once
-#include <functional>
-#include <vector>
-#include <unordered_map>
+#include <stddef.h>
+#include <new>
+#include <type_traits>
+#include <utility>
 #include "app/event_pipe.h"
 
 namespace rce {
 
-using EPCallback = std::function<void(const EPMsg&)>;
+// Listener callables are stored inline (no heap). Anything up to this size
+// (e.g. a lambda capturing a few pointers) fits; larger captures fail to compile.
+static constexpr size_t EP_LISTENER_INLINE_BYTES = 32;
 
-void ep_subscribe(EPType type, EPCallback cb);
-void ep_dispatch_all_p2e();  // drain pipe + notify subscribers
+// Fixed listener capacity per EPType (the table is static, no allocation).
+static constexpr uint32_t EP_MAX_LISTENERS_PER_TYPE = 64;
+
+// Opaque handle returned by ep_subscribe. 0 is reserved as "invalid".
+using EPSubscription = uint32_t;
+
+struct EPListener {
+    using InvokeFn   = void (*)(void* self, const EPMsg& msg);
+    using RelocateFn = void (*)(void* dst, void* src); // move-construct dst, destroy src
+    using DestroyFn  = void (*)(void* self);
+
+    alignas(alignof(max_align_t)) unsigned char storage[EP_LISTENER_INLINE_BYTES];
+    InvokeFn invoke = nullptr;
+    RelocateFn relocate = nullptr;
+    DestroyFn destroy = nullptr;
+    EPSubscription id = 0;
+    bool alive = false;
+};
+
+namespace detail {
+
+// Claims a slot for type and wires up its ops; returns nullptr when the type is full/unknown.
+EPListener* ep_alloc_listener(EPType type);
+
+template <typename F>
+void ep_invoke(void* self, const EPMsg& msg) { (*static_cast<F*>(self))(msg); }
+
+template <typename F>
+void ep_relocate(void* dst, void* src) {
+    F* s = static_cast<F*>(src);
+    new (dst) F(std::move(*s));
+    s->~F();
+}
+
+template <typename F>
+void ep_destroy(void* self) { static_cast<F*>(self)->~F(); }
+
+} // namespace detail
+
+// Subscribe a callable void(const EPMsg&). Returns 0 when the type has no free slot.
+// Safe to call from inside a callback; the new listener sees the next message.
+template <typename F>
+EPSubscription ep_subscribe(EPType type, F&& fn) {
+    using Fn = std::decay_t<F>;
+    static_assert(sizeof(Fn) <= EP_LISTENER_INLINE_BYTES, "listener capture too large for inline storage");
+    static_assert(alignof(Fn) <= alignof(max_align_t), "listener over-aligned");
+    static_assert(std::is_nothrow_move_constructible<Fn>::value, "listener must be nothrow-movable");
+
+    EPListener* l = detail::ep_alloc_listener(type);
+    if (!l) return 0;
+
+    new (l->storage) Fn(std::forward<F>(fn));
+    l->invoke = &detail::ep_invoke<Fn>;
+    l->relocate = &detail::ep_relocate<Fn>;
+    l->destroy = &detail::ep_destroy<Fn>;
+    return l->id;
+}
+
+// Remove a listener (safe to call multiple times, and from inside any callback,
+// including the listener's own). It stops receiving messages immediately.
+void ep_unsubscribe(EPSubscription sub);
+
+void ep_dispatch(const EPMsg& msg);  // notify subscribers of one message
+void ep_dispatch_all_p2e();          // drain pipe + notify subscribers
 
 }
@@ -1,6 +1,7 @@
 #pragma once
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 namespace rce {
 
@@ -10,11 +11,30 @@ enum class EPType : uint16_t {
     InsetsChanged = 1,
     SurfaceResized = 2,
 
+    // Engine-internal (dispatched directly on the engine thread, never piped)
+    Gesture = 3,            // see input::gesture_to_msg
+    Pointer = 4,            // see input::pointer_to_msg
+
     // Engine -> Platform
     SetAllowedRotations = 100,
     SetUiMode = 101,
 };
 
+// Dense index for per-type tables. Keep in sync with EPType.
+static constexpr uint32_t EP_TYPE_COUNT = 6;
+
+inline uint32_t ep_type_index(EPType t) {
+    switch (t) {
+        case EPType::InsetsChanged:       return 0;
+        case EPType::SurfaceResized:      return 1;
+        case EPType::SetAllowedRotations: return 2;
+        case EPType::SetUiMode:           return 3;
+        case EPType::Gesture:             return 4;
+        case EPType::Pointer:             return 5;
+    }
+    return EP_TYPE_COUNT; // unknown
+}
+
 struct EPMsg {
     EPType type;
     uint16_t flags = 0; // reserved
@@ -24,6 +44,11 @@ struct EPMsg {
     uint32_t d = 0;
 };
 
+// Each direction is a lock-free single-producer/single-consumer ring:
+// - p2e: posted from one platform thread (e.g. the JNI/UI thread), polled by the engine thread.
+// - e2p: posted by the engine thread, polled by one platform thread.
+// Posting to the same direction from two threads at once is not supported.
+
 // Init once at startup (safe to call multiple times; no-op after first).
 void ep_init();
 
@@ -35,10 +60,24 @@ bool ep_poll_p2e(EPMsg* out); // engine drains
 bool ep_post_e2p(const EPMsg& msg);
 bool ep_poll_e2p(EPMsg* out); // platform drains
 
+// Bulk drain: copies up to max messages into out, returns how many were written.
+// Ring contents come out in one or two contiguous copies; coalesced messages follow.
+size_t ep_drain_p2e(EPMsg* out, size_t max);
+size_t ep_drain_e2p(EPMsg* out, size_t max);
+
+// Coalescing: for "latest state wins" types only the newest pending message is kept.
+// A coalesced type bypasses the ring (it never fills it or drops), and is delivered
+// after the ring contents of the same drain, at most once. InsetsChanged and
+// SurfaceResized coalesce by default. Configure at startup, before traffic starts.
+void ep_set_coalesce(EPType type, bool enabled);
+bool ep_get_coalesce(EPType type);
+
 // Optional debug counters (handy early)
+// Lock-free snapshot; values are individually consistent but may be mid-update relative to each other.
+// *_coalesced counts messages replaced before delivery, tallied when their replacement is delivered.
 struct EPCounters {
-    uint64_t p2e_pushed, p2e_popped, p2e_dropped, p2e_highwater;
-    uint64_t e2p_pushed, e2p_popped, e2p_dropped, e2p_highwater;
+    uint64_t p2e_pushed, p2e_popped, p2e_dropped, p2e_highwater, p2e_coalesced;
+    uint64_t e2p_pushed, e2p_popped, e2p_dropped, e2p_highwater, e2p_coalesced;
 };
 EPCounters ep_get_counters();
 
@@ -1,12 +1,119 @@
 #pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <type_traits>
 
-#if defined(__ANDROID__)
-  #include <android/log.h>
-  #define LOG_TAG "MyLuaApp"
-  #define LOGI(...) __android_log_print(ANDROID_LOG_INFO,  LOG_TAG, __VA_ARGS__)
-  #define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
-#else
-  #include <cstdio>
-  #define LOGI(...) do { std::printf(__VA_ARGS__); std::printf("\n"); } while (0)
-  #define LOGE(...) do { std::fprintf(stderr, __VA_ARGS__); std::fprintf(stderr, "\n"); } while (0)
-#endif
+// LOGI / LOGE are asynchronous.
+//
+// A call site copies its arguments (timestamp, level, format pointer, packed
+// argument blob; strings are copied) into a lock-free ring owned by the calling
+// thread. A background writer formats the records and sends them to the
+// platform sink (logcat, or stdout/stderr on the host) and, after
+// log_open_file(), to a rotating file. The format must be a string literal:
+// it is read later, by the writer.
+//
+// Every call site is rate limited (LOG_SITE_MAX_PER_SEC); extra lines are
+// counted and summarized when the one-second window rolls over. A full ring
+// drops the record and counts it (log_stats).
+
+namespace rce {
+
+enum class LogLevel : uint8_t { Info, Error };
+
+static constexpr uint32_t LOG_SITE_MAX_PER_SEC = 200;
+
+// Per call site state (one static per LOGx expansion, constant-initialized).
+struct LogSite {
+    std::atomic<uint64_t> window_ns{0};
+    std::atomic<uint32_t> count{0};
+    std::atomic<uint32_t> suppressed{0};
+};
+
+struct LogStats {
+    uint64_t written = 0;       // records handed to the sinks
+    uint64_t dropped = 0;       // producer ring full / record too large
+    uint64_t rate_limited = 0;  // suppressed by the per-site limit
+};
+
+// Starts the writer thread (also happens lazily on the first log call).
+void log_init();
+// Adds a rotating file sink: <dir>/rce.log, rce.log.1 ... (dir is created).
+void log_open_file(const char* dir);
+// Blocks until everything logged before the call has reached the sinks.
+void log_flush();
+// Flushes, stops the writer and closes the file. Later calls log synchronously.
+void log_shutdown();
+// Preformatted text (may contain newlines), e.g. batched Lua console output.
+void log_write_raw(LogLevel level, const char* text, size_t len);
+
+LogStats log_stats();
+
+namespace detail {
+
+enum LogArgTag : uint8_t { LOG_I32, LOG_U32, LOG_I64, LOG_U64, LOG_F64, LOG_PTR, LOG_STR };
+
+struct LogArg {
+    uint8_t tag;
+    union {
+        int32_t i32;
+        uint32_t u32;
+        int64_t i64;
+        uint64_t u64;
+        double f64;
+        const void* p;
+        const char* s;
+    };
+};
+
+template <typename> inline constexpr bool log_unsupported = false;
+
+// Arguments are stored by size/signedness, so the writer can pass them back to
+// snprintf with the same varargs ABI the call site would have used.
+template <typename T>
+inline LogArg log_arg(const T& v) {
+    LogArg a{};
+    if constexpr (std::is_enum_v<T>) {
+        return log_arg((std::underlying_type_t<T>)v);
+    } else if constexpr (std::is_integral_v<T>) {
+        if constexpr (sizeof(T) <= 4) {
+            if constexpr (std::is_signed_v<T> || sizeof(T) < 4) { a.tag = LOG_I32; a.i32 = (int32_t)v; }
+            else { a.tag = LOG_U32; a.u32 = (uint32_t)v; }
+        } else {
+            if constexpr (std::is_signed_v<T>) { a.tag = LOG_I64; a.i64 = (int64_t)v; }
+            else { a.tag = LOG_U64; a.u64 = (uint64_t)v; }
+        }
+    } else if constexpr (std::is_floating_point_v<T>) {
+        a.tag = LOG_F64; a.f64 = (double)v;
+    } else if constexpr (std::is_convertible_v<const T&, const char*>) {
+        a.tag = LOG_STR; a.s = v;
+    } else if constexpr (std::is_pointer_v<T> || std::is_null_pointer_v<T>) {
+        a.tag = LOG_PTR; a.p = (const void*)v;
+    } else {
+        static_assert(log_unsupported<T>, "LOGx: unsupported argument type");
+    }
+    return a;
+}
+
+void log_submit(LogSite& site, LogLevel level, const char* fmt, const LogArg* args, uint32_t nargs);
+
+template <typename... Args>
+inline void log_emit(LogSite& site, LogLevel level, const char* fmt, const Args&... args) {
+    const LogArg packed[sizeof...(Args) + 1] = { log_arg(args)..., LogArg{} };
+    log_submit(site, level, fmt, packed, (uint32_t)sizeof...(Args));
+}
+
+// Never called; lets the compiler check the format against the arguments.
+[[gnu::format(printf, 1, 2)]] inline void log_check_format(const char*, ...) {}
+
+} // namespace detail
+} // namespace rce
+
+#define RCE_LOG(level, ...) do { \
+    if (false) ::rce::detail::log_check_format(__VA_ARGS__); \
+    static ::rce::LogSite rce_log_site_; \
+    ::rce::detail::log_emit(rce_log_site_, level, __VA_ARGS__); \
+} while (0)
+
+#define LOGI(...) RCE_LOG(::rce::LogLevel::Info,  __VA_ARGS__)
+#define LOGE(...) RCE_LOG(::rce::LogLevel::Error, __VA_ARGS__)
@@ -31,4 +31,7 @@ std::string extname(std::string_view p);               // "c.txt" -> ".txt" , "c
 std::string strip_extension(std::string_view p);       // "c.txt" -> "c"
 std::string replace_extension(std::string_view p, std::string_view new_ext); // new_ext may include '.' or not
 
+// ---- filesystem ----
+bool make_dirs(std::string_view dir);                  // mkdir -p; true if dir exists afterwards
+
 } // namespace app::paths
@@ -3,7 +3,43 @@
 
 namespace rce {
 
-void time_init(uint64_t start_ms);
-float time_update(uint64_t now_ms); // returns dt in seconds
+// Monotonic clock in integer nanoseconds (never goes backwards).
+uint64_t time_now_ns();
+
+// Frame time base. Integer nanoseconds end to end, so long sessions don't drift.
+void time_init(uint64_t start_ns);
+uint64_t time_update(uint64_t now_ns); // returns dt in nanoseconds
+
+inline float time_ns_to_s(uint64_t ns) { return (float)((double)ns * 1e-9); }
+inline uint64_t time_s_to_ns(double s) { return s > 0.0 ? (uint64_t)(s * 1e9 + 0.5) : 0; }
+
+// ---- fixed-timestep simulation accumulator ----
+
+struct FixedStepConfig {
+    uint64_t step_ns = 16666667; // 60 Hz simulation
+    uint32_t max_steps = 5;      // catch-up cap per frame; time beyond it is dropped (no spiral of death)
+};
+
+struct FixedStepFrame {
+    uint32_t steps = 0;          // fixed steps to run this frame
+    float alpha = 0.0f;          // leftover / step_ns in [0,1), for render interpolation
+    uint64_t dropped_ns = 0;     // time discarded because of max_steps
+};
+
+class FixedStep {
+public:
+    void configure(const FixedStepConfig& cfg);
+    const FixedStepConfig& config() const { return cfg_; }
+
+    // Feed one frame's dt; returns how many fixed steps to run.
+    FixedStepFrame advance(uint64_t dt_ns);
+
+    void reset() { acc_ns_ = 0; }
+    uint64_t step_ns() const { return cfg_.step_ns; }
+
+private:
+    FixedStepConfig cfg_;
+    uint64_t acc_ns_ = 0;
+};
 
 }
@@ -4,7 +4,10 @@
 
 namespace rce {
 
-using TimerId = uint32_t;
+// Generation-tagged handle: [63..20] generation, [19..0] slot index.
+// A stale id (timer fired/canceled, slot reused) never matches a live timer:
+// the 44-bit generation would need 2^44 reuses of one slot to wrap.
+using TimerId = uint64_t;
 
 struct TimerSpec {
     // Delay until first fire.
@@ -32,10 +35,11 @@ TimerId timers_after(float delay_s, TimerCallback cb);
 // Convenience: repeating interval (first fire after interval by default).
 TimerId timers_every(float interval_s, TimerCallback cb);
 
-// Cancel a timer by id (safe to call multiple times).
+// Cancel a timer by id (safe to call multiple times). O(1).
 void timers_cancel(TimerId id);
 
-// Called once per frame from engine_tick(dt).
-void timers_update(float dt_s);
+// Called once per fixed simulation step from engine_tick. Cost is O(expired log n), not O(live).
+// Each timer fires at most once per update; callbacks may add/cancel timers freely.
+void timers_update(uint64_t dt_ns);
 
 } // namespace rce
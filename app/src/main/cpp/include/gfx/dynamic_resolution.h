@@ -0,0 +1,60 @@
+#pragma once
+#include <stdint.h>
+
+// Dynamic resolution: picks the internal render scale from frame timing.
+//
+// Platform-free: the platform feeds one CPU and (if it has one) GPU time per
+// frame, and passes scale() on to compute_result / apply_render_target. The
+// cost of a frame goes roughly with the pixel count, i.e. scale^2, so a slow
+// frame drops the scale by sqrt(budget / time) in one go; recovery is one
+// step at a time. Between the two thresholds nothing changes (hysteresis),
+// and after every change the controller holds for a while so the new size
+// (and its render target reallocation) settles before it is judged.
+
+struct DynamicResolutionConfig {
+    uint64_t budget_ns = 16666667;  // frame time to stay under
+    float min_scale = 0.5f;
+    float max_scale = 1.0f;
+    float step = 0.05f;             // scales are multiples of this, so sizes don't creep
+    float over = 1.0f;              // filtered time > over * budget: scale down
+    float under = 0.8f;             // filtered time < under * budget: may scale up
+    uint32_t down_frames = 4;       // consecutive frames over before dropping
+    uint32_t up_frames = 90;        // consecutive frames under before raising
+    uint32_t hold_frames = 15;      // frames ignored after a change
+    float smoothing = 0.2f;         // EMA weight of the newest frame
+};
+
+struct DynamicResolutionStats {
+    uint32_t frames = 0;
+    uint32_t downs = 0;
+    uint32_t ups = 0;
+};
+
+class DynamicResolution {
+public:
+    void configure(const DynamicResolutionConfig& cfg);
+    const DynamicResolutionConfig& config() const { return cfg_; }
+
+    // Back to max_scale with no history (e.g. new surface, mode change).
+    void reset();
+
+    // One frame's timing; gpu_ns = 0 when unknown. The frame counts as the
+    // slower of the two. Returns true when scale() changed.
+    bool update(uint64_t cpu_ns, uint64_t gpu_ns = 0);
+
+    float scale() const { return scale_; }
+    float filtered_ms() const { return filtered_ms_; }
+    const DynamicResolutionStats& stats() const { return stats_; }
+
+private:
+    float quantize(float s) const;  // down to a step multiple, clamped
+
+    DynamicResolutionConfig cfg_;
+    float scale_ = 1.0f;
+    float filtered_ms_ = 0.0f;
+    bool have_sample_ = false;
+    uint32_t over_count_ = 0;
+    uint32_t under_count_ = 0;
+    uint32_t hold_ = 0;
+    DynamicResolutionStats stats_;
+};
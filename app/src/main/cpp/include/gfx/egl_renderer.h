@@ -1,8 +1,12 @@
 #pragma once
 
+#include "gfx/gl_sprite_renderer.h"
+#include "gfx/gl_state_cache.h"
 #include "gfx/presentation_types.h"
+#include "gfx/render_commands.h"
 
-class EglRenderer {
+// GLES3 backend: replays a sorted RenderCommandBuffer and presents.
+class EglRenderer : public RenderBackend {
 public:
     EglRenderer() = default;
     ~EglRenderer();
@@ -13,8 +17,13 @@ public:
 	
 	void set_viewport(int x, int y, int w, int h);
     void reset_viewport();
-    void render_frame(float r, float g, float b, float a = 1.0f);
 	bool recalc_surface_size();
+
+    // Records the present pass on render_key::LAYER_PRESENT: full-surface
+    // border clear, then the (clamped) viewport/scissor and the content clear.
+    void record_frame(RenderCommandBuffer& cmds, float r, float g, float b, float a = 1.0f) const;
+    // Replays cmds (sorting them if needed) and swaps buffers.
+    void submit(RenderCommandBuffer& cmds);
 	
 	// 
     void set_output_rect(const RectI& r);
@@ -23,6 +32,22 @@ public:
     void set_scissor_rect(const RectI& r);
     void clear_scissor();
 
+    // Offscreen mode: the frame is drawn into a w x h texture, then blitted
+    // into present_rect (surface pixels, GL bottom-left origin) in one
+    // glBlitFramebuffer at end of frame; linear filters the blit. Sizes come
+    // from PresentationResult (render_w/h, present_rect, present_linear).
+    // The target is (re)allocated on the next frame. w/h <= 0 = direct mode.
+    void set_render_target(int w, int h, const RectI& present_rect, bool linear);
+    void clear_render_target();
+    bool has_render_target() const { return rt_w_ > 0 && rt_h_ > 0; }
+
+    // All of the above from one PresentationResult: output rect, scissor
+    // (clip_to_output) and render target. generation comes from
+    // PresentationState; the one already applied is a no-op. Returns true
+    // when something was applied.
+    bool apply_presentation(const PresentationResult& pr, uint32_t generation);
+    uint32_t presentation_generation() const { return applied_generation_; }
+
     RectI surface_rect() const { return {0, 0, width_, height_}; }
 
     // Platform passes a native window handle as an opaque pointer.
@@ -34,9 +59,31 @@ public:
 	
 	int width() const { return width_; }
 	int height() const { return height_; }
+
+    // GL calls that reached the driver / were filtered by the last submit().
+    const GlCallStats& gl_stats() const { return gl_.frame_stats(); }
+    GlStateCache& gl() { return gl_; }
+    // Sprite batches / draw calls of the last submitted frame.
+    const SpriteStats& sprite_stats() const { return sprites_.stats(); }
+    // GPU time of the most recent frame whose timer query has landed (a few
+    // frames behind), 0 if unknown (no GL_EXT_disjoint_timer_query).
+    uint64_t gpu_frame_ns() const { return gpu_ns_; }
+
+    // RenderBackend
+    void begin_frame() override;
+    void clear(const CmdClear& c) override;
+    void viewport(const RectI& r) override;
+    void scissor(const CmdScissor& s) override;
+    void draw(const CmdDraw& d) override;
+    void sprites(const CmdSprites& s) override;
+    void end_frame() override;
 	
 private:
     bool ready_ = false;
+
+    GlStateCache gl_;
+    GlSpriteRenderer sprites_;
+    RectI cur_viewport_;  // as replayed, for sprite projection
 	
     bool use_custom_viewport_ = false;
 	
@@ -46,6 +93,34 @@ private:
     bool has_scissor_ = false;
     RectI scissor_rect_;
 
+    uint32_t applied_generation_ = 0;  // 0 = none (forced again after init)
+
+    // Offscreen render target, as requested / as allocated.
+    int rt_w_ = 0;
+    int rt_h_ = 0;
+    RectI present_rect_;
+    bool present_linear_ = false;
+    unsigned int rt_fbo_ = 0;
+    unsigned int rt_tex_ = 0;
+    int rt_alloc_w_ = 0;
+    int rt_alloc_h_ = 0;
+
+    // GPU frame timing: a small ring of TIME_ELAPSED queries, read back
+    // without stalling once their results are available.
+    static constexpr uint32_t GPU_QUERIES = 4;
+    bool gpu_timer_ = false;
+    unsigned int gpu_queries_[GPU_QUERIES] = {};
+    bool gpu_pending_[GPU_QUERIES] = {};
+    uint32_t gpu_next_ = 0;
+    uint64_t gpu_ns_ = 0;
+
+    void init_gpu_timer();
+    void collect_gpu_timer();
+
+    bool ensure_render_target();
+    void destroy_render_target();
+    void present_render_target();
+
     void* display_ = nullptr; // EGLDisplay
     void* surface_ = nullptr; // EGLSurface
     void* context_ = nullptr; // EGLContext
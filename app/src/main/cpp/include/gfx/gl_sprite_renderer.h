@@ -0,0 +1,61 @@
+#pragma once
+#include <stdint.h>
+
+#include "gfx/gl_state_cache.h"
+#include "gfx/presentation_types.h"
+#include "gfx/sprite_batch.h"
+
+// GLES3 sprite drawing on top of SpriteBatcher.
+//
+// Vertices go into one VBO split into FRAMES_IN_FLIGHT regions, one per frame.
+// ES 3.0 has no persistent mapping (no glBufferStorage), so each frame maps
+// its region with GL_MAP_UNSYNCHRONIZED_BIT and the batcher writes straight
+// into it; a fence per region, waited on before reuse, keeps the CPU from
+// overwriting vertices the GPU is still reading. Batches are drawn with one
+// glDrawElements each from a static 16-bit quad index buffer.
+//
+// Sprites are queued with add() and drawn at flush(); the owner flushes
+// before any other state change so draw order is preserved.
+class GlSpriteRenderer {
+public:
+    static constexpr uint32_t FRAMES_IN_FLIGHT = 3;
+    static constexpr uint32_t DEFAULT_QUADS_PER_FRAME = 32768;
+
+    bool init(GlStateCache* gl, uint32_t max_quads_per_frame = DEFAULT_QUADS_PER_FRAME);
+    void shutdown();
+    bool is_ready() const { return vbo_ != 0; }
+
+    void begin_frame();
+    // viewport is the one the quads will be drawn in (pixel -> clip mapping).
+    void add(const Sprite* sprites, uint32_t count, const RectI& viewport);
+    void flush();
+    void end_frame();
+
+    // Counts for the last finished frame.
+    const SpriteStats& stats() const { return last_stats_; }
+
+private:
+    bool map_block();
+
+    GlStateCache* gl_ = nullptr;
+    SpriteBatcher batcher_;
+
+    unsigned int program_ = 0;
+    int u_scale_ = -1;
+    int u_tex_ = -1;
+    unsigned int white_tex_ = 0;
+    unsigned int vao_ = 0;
+    unsigned int vbo_ = 0;
+    unsigned int ibo_ = 0;
+
+    uint32_t quads_per_frame_ = 0;
+    uint32_t region_ = 0;          // current frame's region
+    uint32_t region_used_ = 0;     // quads already drawn from it this frame
+    void* fences_[FRAMES_IN_FLIGHT] = {};  // GLsync
+
+    bool mapped_ = false;
+    uint32_t block_first_quad_ = 0;  // region-relative start of the mapped block
+    RectI viewport_;
+
+    SpriteStats last_stats_;
+};
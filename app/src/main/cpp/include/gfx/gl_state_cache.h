@@ -0,0 +1,108 @@
+#pragma once
+#include <stdint.h>
+
+// Shadow copy of the GL state the renderer touches, so redundant state calls
+// never reach the driver.
+//
+// GL entry points come in through a plain function table; EglRenderer fills
+// it with the real GLES3 functions, host code can fill it with fakes. The
+// table uses the underlying C types of GLenum/GLint/GLsizei/GLfloat/GLuint/
+// GLbitfield, so this header needs no GL headers and builds everywhere.
+//
+// After anything else may have changed GL state (context creation, a third
+// party renderer), call invalidate(): the next call of each kind is issued.
+
+struct GlFunctions {
+    void (*Enable)(unsigned int cap) = nullptr;
+    void (*Disable)(unsigned int cap) = nullptr;
+    void (*Viewport)(int x, int y, int w, int h) = nullptr;
+    void (*Scissor)(int x, int y, int w, int h) = nullptr;
+    void (*ClearColor)(float r, float g, float b, float a) = nullptr;
+    void (*Clear)(unsigned int mask) = nullptr;
+    void (*UseProgram)(unsigned int program) = nullptr;
+    void (*BindBuffer)(unsigned int target, unsigned int buffer) = nullptr;
+    void (*ActiveTexture)(unsigned int unit) = nullptr;
+    void (*BindTexture)(unsigned int target, unsigned int texture) = nullptr;
+    void (*BlendFunc)(unsigned int sfactor, unsigned int dfactor) = nullptr;
+    void (*BindVertexArray)(unsigned int array) = nullptr;
+};
+
+struct GlCallStats {
+    uint32_t issued = 0;   // reached the driver
+    uint32_t skipped = 0;  // filtered as redundant
+};
+
+class GlStateCache {
+public:
+    // GL enum values the cache tracks (same numbers as the GLES headers).
+    static constexpr unsigned int SCISSOR_TEST = 0x0C11;
+    static constexpr unsigned int BLEND = 0x0BE2;
+    static constexpr unsigned int DEPTH_TEST = 0x0B71;
+    static constexpr unsigned int CULL_FACE = 0x0B44;
+    static constexpr unsigned int ARRAY_BUFFER = 0x8892;
+    static constexpr unsigned int ELEMENT_ARRAY_BUFFER = 0x8893;
+    static constexpr unsigned int TEXTURE0 = 0x84C0;
+    static constexpr unsigned int TEXTURE_2D = 0x0DE1;
+    static constexpr uint32_t MAX_TEXTURE_UNITS = 8;
+
+    void set_functions(const GlFunctions& fns) { gl_ = fns; invalidate(); }
+    const GlFunctions& functions() const { return gl_; }
+
+    // Forget everything we think we know about the GL state.
+    void invalidate();
+
+    void enable(unsigned int cap);
+    void disable(unsigned int cap);
+    void viewport(int x, int y, int w, int h);
+    void scissor(int x, int y, int w, int h);
+    void clear_color(float r, float g, float b, float a);
+    void clear(unsigned int mask);  // never filtered
+    void use_program(unsigned int program);
+    void bind_buffer(unsigned int target, unsigned int buffer);
+    void bind_texture(uint32_t unit, unsigned int texture);  // TEXTURE_2D on unit
+    void blend_func(unsigned int sfactor, unsigned int dfactor);
+    // The element buffer binding belongs to the VAO, so switching VAOs forgets it.
+    void bind_vertex_array(unsigned int array);
+
+    // Counters since the last begin_frame(); last_frame() is the previous frame.
+    void begin_frame() { last_ = cur_; cur_ = GlCallStats{}; }
+    const GlCallStats& frame_stats() const { return cur_; }
+    const GlCallStats& last_frame() const { return last_; }
+
+private:
+    enum CapIndex { CAP_SCISSOR, CAP_BLEND, CAP_DEPTH, CAP_CULL, CAP_COUNT };
+    enum Tri : uint8_t { Unknown, Off, On };
+
+    static int cap_index(unsigned int cap);
+    void skipped() { cur_.skipped++; }
+    void issued() { cur_.issued++; }
+    void set_cap(unsigned int cap, bool on);
+
+    GlFunctions gl_;
+
+    Tri caps_[CAP_COUNT] = {};
+    bool viewport_valid_ = false;
+    int viewport_[4] = {};
+    bool scissor_valid_ = false;
+    int scissor_[4] = {};
+    bool clear_color_valid_ = false;
+    float clear_color_[4] = {};
+    bool program_valid_ = false;
+    unsigned int program_ = 0;
+    bool array_buffer_valid_ = false;
+    unsigned int array_buffer_ = 0;
+    bool element_buffer_valid_ = false;
+    unsigned int element_buffer_ = 0;
+    bool active_unit_valid_ = false;
+    uint32_t active_unit_ = 0;
+    bool texture_valid_[MAX_TEXTURE_UNITS] = {};
+    unsigned int texture_[MAX_TEXTURE_UNITS] = {};
+    bool vao_valid_ = false;
+    unsigned int vao_ = 0;
+    bool blend_valid_ = false;
+    unsigned int blend_src_ = 0;
+    unsigned int blend_dst_ = 0;
+
+    GlCallStats cur_;
+    GlCallStats last_;
+};
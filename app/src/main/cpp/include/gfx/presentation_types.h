@@ -1,4 +1,5 @@
 #pragma once
+#include <stdint.h>
 
 struct RectI {
     int x = 0;
@@ -7,6 +8,11 @@ struct RectI {
     int h = 0;
 };
 
+inline bool operator==(const RectI& a, const RectI& b) {
+    return a.x == b.x && a.y == b.y && a.w == b.w && a.h == b.h;
+}
+inline bool operator!=(const RectI& a, const RectI& b) { return !(a == b); }
+
 struct SurfaceMetrics {
     int surface_w = 0;
     int surface_h = 0;
@@ -23,4 +29,50 @@ struct PresentationResult {
     RectI output_rect;         // GL viewport region inside surface (bottom-left origin for GL)
     RectI safe_rect;           // UI/layout safe region (same coords as output_rect or smaller)
     bool request_immersive = false; // platform may attempt OS UI changes (Android only)
+    bool clip_to_output = false;    // hard-clip content to output_rect (scissor)
+
+    // Offscreen render target (gfx/render_scale.h). 0x0 = none: the engine
+    // draws straight into output_rect and present_rect == output_rect.
+    int render_w = 0;
+    int render_h = 0;
+    RectI present_rect;          // where the target is blitted, inside output_rect
+    float present_scale = 1.0f;  // present_rect size / render size
+    bool present_linear = false; // fractional scale: filter the blit
+};
+
+inline bool operator==(const PresentationResult& a, const PresentationResult& b) {
+    return a.output_rect == b.output_rect && a.safe_rect == b.safe_rect &&
+           a.request_immersive == b.request_immersive && a.clip_to_output == b.clip_to_output &&
+           a.render_w == b.render_w && a.render_h == b.render_h &&
+           a.present_rect == b.present_rect && a.present_scale == b.present_scale &&
+           a.present_linear == b.present_linear;
+}
+inline bool operator!=(const PresentationResult& a, const PresentationResult& b) { return !(a == b); }
+
+// The current PresentationResult, recomputed only when something it depends
+// on changed. Owners invalidate() on those events (insets, surface size, mode,
+// render scale) and call update() while dirty(). generation() moves only when
+// the result actually differs, so the renderer can skip re-applying a
+// generation it has already applied. 0 = nothing computed yet.
+class PresentationState {
+public:
+    void invalidate() { dirty_ = true; }
+    bool dirty() const { return dirty_; }
+
+    // Stores r and clears dirty; returns true (and bumps the generation) if r is new.
+    bool update(const PresentationResult& r) {
+        dirty_ = false;
+        if (generation_ != 0 && r == result_) return false;
+        result_ = r;
+        generation_++;
+        return true;
+    }
+
+    const PresentationResult& result() const { return result_; }
+    uint32_t generation() const { return generation_; }
+
+private:
+    PresentationResult result_;
+    uint32_t generation_ = 0;
+    bool dirty_ = true;
 };
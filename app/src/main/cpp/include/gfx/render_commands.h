@@ -0,0 +1,199 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <memory>
+#include <vector>
+
+#include "gfx/presentation_types.h"
+
+// Backend-agnostic render command buffer.
+//
+// Everything that wants to draw records commands with a 64-bit sort key into
+// the frame's buffer (in any order, from anywhere on the render thread). At
+// submit the entries are radix sorted by key and replayed into a RenderBackend
+// (EglRenderer on device, a null/recording backend on the host).
+//
+// Key layout (most significant first):
+//   layer:8 | pass:8 | draw:1 | material:23 | depth:24
+// State commands (clear/viewport/scissor) have draw=0, so within a pass they
+// run before its draws. The sort is stable: equal keys keep recording order.
+
+namespace render_key {
+
+// Layers used so far. The platform's present pass (border + content clear,
+// viewport/scissor) is layer 0; scene and UI draws go on top of it.
+static constexpr uint8_t LAYER_PRESENT = 0;
+static constexpr uint8_t LAYER_WORLD = 16;
+static constexpr uint8_t LAYER_UI = 32;
+
+static constexpr uint32_t MATERIAL_BITS = 23;
+static constexpr uint32_t DEPTH_BITS = 24;
+static constexpr uint32_t MATERIAL_MAX = (1u << MATERIAL_BITS) - 1;
+static constexpr uint32_t DEPTH_MAX = (1u << DEPTH_BITS) - 1;
+
+inline uint64_t state(uint8_t layer, uint8_t pass) {
+    return (uint64_t)layer << 56 | (uint64_t)pass << 48;
+}
+
+inline uint64_t draw(uint8_t layer, uint8_t pass, uint32_t material, uint32_t depth) {
+    return state(layer, pass) | 1ull << 47
+        | (uint64_t)(material & MATERIAL_MAX) << DEPTH_BITS
+        | (uint64_t)(depth & DEPTH_MAX);
+}
+
+inline uint8_t layer_of(uint64_t key) { return (uint8_t)(key >> 56); }
+inline uint8_t pass_of(uint64_t key) { return (uint8_t)(key >> 48); }
+inline bool is_draw(uint64_t key) { return (key >> 47) & 1u; }
+inline uint32_t material_of(uint64_t key) { return (uint32_t)(key >> DEPTH_BITS) & MATERIAL_MAX; }
+inline uint32_t depth_of(uint64_t key) { return (uint32_t)key & DEPTH_MAX; }
+
+} // namespace render_key
+
+struct Sprite; // gfx/sprite_batch.h
+
+enum class RenderCmdType : uint8_t { Clear, Viewport, Scissor, Draw, Sprites };
+
+struct CmdClear {
+    float r, g, b, a;
+};
+
+struct CmdScissor {
+    bool enabled;
+    RectI rect;
+};
+
+// Draws are opaque handles for now; the backend decides what they mean.
+struct CmdDraw {
+    uint32_t material;  // pipeline/texture combination
+    uint32_t mesh;      // vertex source
+    uint32_t first;
+    uint32_t count;
+};
+
+// A run of sprites (copied into the frame arena). Consecutive sprite commands
+// reach the backend back to back, so it can batch across them.
+struct CmdSprites {
+    const Sprite* sprites;
+    uint32_t count;
+};
+
+class RenderBackend {
+public:
+    virtual ~RenderBackend() = default;
+
+    virtual void begin_frame() {}
+    virtual void clear(const CmdClear& c) = 0;
+    virtual void viewport(const RectI& r) = 0;
+    virtual void scissor(const CmdScissor& s) = 0;
+    virtual void draw(const CmdDraw& d) = 0;
+    virtual void sprites(const CmdSprites& s) = 0;
+    virtual void end_frame() {}
+};
+
+// Per-frame bump allocator. Memory comes in fixed chunks that are kept across
+// reset(), so a steady frame allocates nothing.
+class FrameArena {
+public:
+    explicit FrameArena(size_t chunk_bytes = 64 * 1024) : chunk_bytes_(chunk_bytes) {}
+
+    void* alloc(size_t size, size_t align);
+    void reset();
+
+    size_t used_bytes() const { return used_; }
+    size_t capacity_bytes() const { return chunks_.size() * chunk_bytes_; }
+    size_t chunk_bytes() const { return chunk_bytes_; }
+
+private:
+    size_t chunk_bytes_;
+    std::vector<std::unique_ptr<unsigned char[]>> chunks_;
+    size_t chunk_ = 0;   // current chunk index
+    size_t offset_ = 0;  // in current chunk
+    size_t used_ = 0;
+};
+
+struct RenderCmdStats {
+    uint32_t commands = 0;
+    uint32_t draws = 0;
+    uint32_t sprites = 0;
+    uint32_t sort_passes = 0;  // radix passes that actually moved data (0..8)
+    size_t arena_bytes = 0;
+};
+
+class RenderCommandBuffer {
+public:
+    // 16 bytes, so the sort moves as little as possible; the command type
+    // lives in front of the payload in the arena.
+    struct Entry {
+        uint64_t key;
+        const void* cmd;
+    };
+
+    static RenderCmdType type_of(const Entry& e) { return *static_cast<const RenderCmdType*>(e.cmd); }
+    template <typename T>
+    static const T& payload(const Entry& e) { return static_cast<const Slot<T>*>(e.cmd)->cmd; }
+
+    // Drops all commands (start of frame). Keeps capacity.
+    void reset();
+
+    void clear(uint64_t key, float r, float g, float b, float a = 1.0f);
+    void viewport(uint64_t key, const RectI& r);
+    void scissor(uint64_t key, const RectI& r);
+    void scissor_off(uint64_t key);
+    void draw(uint64_t key, const CmdDraw& d);
+    // Copies the sprites; use the texture as the key's material so equal
+    // textures sort next to each other and batch.
+    void sprites(uint64_t key, const Sprite* sprites, uint32_t count);
+
+    // Orders entries by key (stable). submit() does this when needed.
+    void sort();
+    // Sorts if needed and replays everything into the backend, between its
+    // begin_frame/end_frame. The buffer stays intact until reset().
+    void submit(RenderBackend& backend);
+
+    uint32_t size() const { return (uint32_t)entries_.size(); }
+    const Entry* entries() const { return entries_.data(); }
+    const RenderCmdStats& stats() const { return stats_; }
+
+private:
+    template <typename T>
+    struct Slot {
+        RenderCmdType type;
+        T cmd;
+    };
+
+    template <typename T>
+    void push(uint64_t key, RenderCmdType type, const T& cmd);
+
+    FrameArena arena_;
+    std::vector<Entry> entries_;
+    std::vector<Entry> scratch_;
+    bool sorted_ = true;
+    RenderCmdStats stats_;
+};
+
+// Keeps a copy of everything it is asked to do (host tests, debugging).
+class RecordingBackend : public RenderBackend {
+public:
+    struct Op {
+        RenderCmdType type;
+        CmdClear clear;
+        RectI rect;
+        bool enabled;
+        CmdDraw draw;
+        CmdSprites sprites;  // points into the submitted buffer's arena
+    };
+
+    void begin_frame() override { ops.clear(); frames++; }
+    void clear(const CmdClear& c) override { Op o{}; o.type = RenderCmdType::Clear; o.clear = c; ops.push_back(o); }
+    void viewport(const RectI& r) override { Op o{}; o.type = RenderCmdType::Viewport; o.rect = r; ops.push_back(o); }
+    void scissor(const CmdScissor& s) override {
+        Op o{}; o.type = RenderCmdType::Scissor; o.rect = s.rect; o.enabled = s.enabled; ops.push_back(o);
+    }
+    void draw(const CmdDraw& d) override { Op o{}; o.type = RenderCmdType::Draw; o.draw = d; ops.push_back(o); }
+    void sprites(const CmdSprites& s) override {
+        Op o{}; o.type = RenderCmdType::Sprites; o.sprites = s; ops.push_back(o);
+    }
+
+    std::vector<Op> ops;  // last frame
+    uint64_t frames = 0;
+};
@@ -0,0 +1,42 @@
+#pragma once
+#include <stdint.h>
+
+#include "gfx/presentation_types.h"
+
+// Rect / scale math for presenting a fixed-size render target inside the
+// output rect. Pure integer math, no GL: the renderer only gets the results.
+//
+// The target is always centered in the output rect with its aspect kept;
+// the policy decides the scale.
+
+enum class ScalePolicy : uint8_t {
+    Integer,     // largest whole multiple that fits: pixel-exact, may leave a border.
+                 // Falls back to Fractional when even 1x doesn't fit.
+    Fractional,  // largest scale that fits: fills one axis, filtered.
+};
+
+struct RenderTargetConfig {
+    int width = 0;   // internal resolution; 0x0 = no render target,
+    int height = 0;  // the engine draws straight into output_rect
+    ScalePolicy policy = ScalePolicy::Integer;
+
+    bool enabled() const { return width > 0 && height > 0; }
+};
+
+// Largest k >= 1 with k*src fitting in dst; 0 if src doesn't fit at 1x (or is empty).
+int scale_integer_factor(int src_w, int src_h, int dst_w, int dst_h);
+
+// Where a src_w x src_h image lands inside `output` under `policy`, centered.
+// *scale_out (optional) gets the on-screen scale (dst size / src size).
+// Empty inputs give an empty rect and scale 0.
+RectI scale_place(int src_w, int src_h, const RectI& output, ScalePolicy policy, float* scale_out = nullptr);
+
+// Fills the render target fields of res from cfg and res.output_rect:
+// render_w/h, present_rect, present_scale and present_linear (set when the
+// blit isn't a whole-number upscale).
+//
+// render_scale (0, 1] shrinks the render size for dynamic resolution while
+// present_rect stays where cfg puts it. With cfg disabled, a scale below 1
+// still makes a target: the output rect's size times the scale, stretched
+// back over it. Disabled cfg at scale 1 clears the fields.
+void apply_render_target(PresentationResult& res, const RenderTargetConfig& cfg, float render_scale = 1.0f);
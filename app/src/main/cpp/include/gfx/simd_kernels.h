@@ -0,0 +1,51 @@
+#pragma once
+#include <stdint.h>
+
+struct SpriteVertex; // gfx/sprite_batch.h
+
+// Small batched math kernels for the 2D path, on structure-of-arrays input.
+//
+// Each kernel has a NEON (ARM), SSE2 (x86) and scalar build, picked at compile
+// time; define RCE_SIMD_SCALAR (CMake: RCE_SIMD=OFF) to force the scalar one.
+// The *_scalar variants are always compiled, as the reference to compare the
+// vector paths against. Vector and scalar paths use the same formulas, so
+// results agree to float rounding (RGBA8 packing agrees exactly).
+// Pointers need no particular alignment.
+
+const char* simd_backend_name(); // "neon", "sse2" or "scalar"
+
+// Quad corners under a 2D affine transform, written into the position fields
+// of 4 consecutive SpriteVertex per quad (TL, TR, BR, BL of the local rect):
+//   x' = m00 * x + m01 * y + tx
+//   y' = m10 * x + m11 * y + ty
+struct QuadCornersSoA {
+    const float* x0; const float* y0;  // local rect
+    const float* x1; const float* y1;
+    const float* m00; const float* m01;
+    const float* m10; const float* m11;
+    const float* tx; const float* ty;
+};
+void simd_quad_corners(const QuadCornersSoA& in, uint32_t count, SpriteVertex* out);
+void simd_quad_corners_scalar(const QuadCornersSoA& in, uint32_t count, SpriteVertex* out);
+
+// sin/cos of each angle (radians): Cephes-style range reduction + polynomials,
+// within ~2e-7 of libm for |angle| < 8192. Feeds rotation matrices above.
+void simd_sincos(const float* angle, uint32_t count, float* s, float* c);
+void simd_sincos_scalar(const float* angle, uint32_t count, float* s, float* c);
+
+// [0,1] floats -> RGBA8 (r in the low byte), clamped, rounded to nearest.
+void simd_pack_rgba8(const float* r, const float* g, const float* b, const float* a,
+                     uint32_t count, uint32_t* out);
+void simd_pack_rgba8_scalar(const float* r, const float* g, const float* b, const float* a,
+                            uint32_t count, uint32_t* out);
+
+// HSV <-> RGB, all channels in [0,1] (hue wraps: 1.0 == 0.0).
+void simd_hsv_to_rgb(const float* h, const float* s, const float* v, uint32_t count,
+                     float* r, float* g, float* b);
+void simd_hsv_to_rgb_scalar(const float* h, const float* s, const float* v, uint32_t count,
+                            float* r, float* g, float* b);
+
+void simd_rgb_to_hsv(const float* r, const float* g, const float* b, uint32_t count,
+                     float* h, float* s, float* v);
+void simd_rgb_to_hsv_scalar(const float* r, const float* g, const float* b, uint32_t count,
+                            float* h, float* s, float* v);
@@ -0,0 +1,91 @@
+#pragma once
+#include <stdint.h>
+
+// 2D sprites -> quads -> batches, on the CPU. No GL in here: the GLES
+// backend (GlSpriteRenderer) points the batcher at mapped vertex memory, the
+// host points it at a plain array.
+//
+// Consecutive sprites with the same texture and shader land in one batch,
+// which the backend draws with a single indexed draw.
+
+struct Sprite {
+    float x, y;            // where the origin lands (px, top-left origin, y down)
+    float w, h;            // size (px)
+    float ox, oy;          // origin as a fraction of the size (0.5, 0.5 = center)
+    float rotation;        // radians, clockwise on screen
+    float u0, v0, u1, v1;  // texture rect
+    uint32_t color;        // RGBA8, r in the low byte
+    uint32_t texture;      // GL texture name, 0 = white
+    uint32_t shader;       // GL program name, 0 = the backend's default
+};
+
+struct SpriteVertex {
+    float x, y;
+    float u, v;
+    uint32_t color;
+};
+
+// One texture/shader run of quads. first_quad is relative to the memory passed
+// to SpriteBatcher::begin.
+struct SpriteBatch {
+    uint32_t texture;
+    uint32_t shader;
+    uint32_t first_quad;
+    uint32_t quad_count;
+};
+
+struct SpriteStats {
+    uint32_t sprites = 0;     // accepted this frame
+    uint32_t dropped = 0;     // no vertex space left
+    uint32_t batches = 0;     // texture/shader runs
+    uint32_t draw_calls = 0;  // indexed draws issued (a run split by a flush counts twice)
+};
+
+// Quads are 4 vertices / 6 indices: (0,1,2) (2,3,0), corners TL, TR, BR, BL.
+static constexpr uint32_t SPRITE_VERTICES_PER_QUAD = 4;
+static constexpr uint32_t SPRITE_INDICES_PER_QUAD = 6;
+// 16-bit indices address 65536 vertices.
+static constexpr uint32_t SPRITE_MAX_QUADS_PER_DRAW = 65536 / SPRITE_VERTICES_PER_QUAD;
+static constexpr uint32_t MAX_SPRITE_BATCHES = 1024;
+
+// Writes the shared index pattern for quad_count quads (quad i uses vertices 4i..4i+3).
+void sprite_fill_indices(uint16_t* out, uint32_t quad_count);
+
+// Writes the 4 corners of each sprite.
+void sprite_build_vertices(const Sprite* sprites, uint32_t count, SpriteVertex* out);
+
+class SpriteBatcher {
+public:
+    // Start of frame: forgets the previous run, zeroes the stats.
+    void begin_frame();
+
+    // Start a new vertex block (e.g. freshly mapped buffer range).
+    void begin(SpriteVertex* dst, uint32_t max_quads);
+    // Appends up to count sprites; returns how many fit.
+    uint32_t add(const Sprite* sprites, uint32_t count);
+
+    uint32_t quad_count() const { return quads_; }
+    bool full() const { return quads_ >= max_quads_ || batch_count_ >= MAX_SPRITE_BATCHES; }
+
+    const SpriteBatch* batches() const { return batches_; }
+    uint32_t batch_count() const { return batch_count_; }
+
+    SpriteStats& stats() { return stats_; }
+    const SpriteStats& stats() const { return stats_; }
+
+private:
+    SpriteVertex* dst_ = nullptr;
+    uint32_t max_quads_ = 0;
+    uint32_t quads_ = 0;
+
+    SpriteBatch batches_[MAX_SPRITE_BATCHES];
+    uint32_t batch_count_ = 0;
+
+    // Last texture/shader of the frame, so a run continuing into the next
+    // block isn't counted as a new batch.
+    bool have_run_ = false;
+    uint32_t run_texture_ = 0;
+    uint32_t run_shader_ = 0;
+
+    SpriteStats stats_;
+};
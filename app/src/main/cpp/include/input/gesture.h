@@ -0,0 +1,128 @@
+#pragma once
+#include <cstdint>
+#include "app/event_pipe.h"
+#include "input/input.h"
+
+namespace input {
+
+enum class GestureKind : uint8_t {
+    Tap = 1,
+    LongPress = 2,
+    Drag = 3,
+    Pinch = 4,
+    Fling = 5,
+};
+
+// Drag and Pinch are continuous (Begin, Update..., End or Cancel).
+// Tap, LongPress and Fling are one-shot and only ever report End.
+enum class GesturePhase : uint8_t {
+    Begin = 1,
+    Update = 2,
+    End = 3,
+    Cancel = 4,
+};
+
+struct Gesture {
+    GestureKind kind;
+    GesturePhase phase;
+    int32_t pointer_id;  // first pointer of the gesture
+    float x, y;          // position (Pinch: centroid, Fling: velocity in px/s)
+    float value;         // Pinch: scale since Begin, LongPress: seconds held, else 0
+};
+
+// All distances in px, times in ns.
+struct GestureConfig {
+    float touch_slop = 16.0f;              // movement before a press becomes a drag
+    uint64_t tap_max_ns = 300000000;       // longer presses are not taps
+    uint64_t long_press_ns = 500000000;
+    float fling_min_velocity = 1000.0f;    // px/s at release
+    uint64_t fling_max_idle_ns = 80000000; // no fling if the finger rested before lifting
+    float pinch_slop = 8.0f;               // span change before a pinch begins
+};
+
+static constexpr uint32_t MAX_FRAME_GESTURES = 64;
+
+class GestureSpan {
+public:
+    GestureSpan(const Gesture* data, uint32_t size) : data_(data), size_(size) {}
+    const Gesture* begin() const { return data_; }
+    const Gesture* end() const { return data_ + size_; }
+    uint32_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    const Gesture& operator[](uint32_t i) const { return data_[i]; }
+private:
+    const Gesture* data_;
+    uint32_t size_;
+};
+
+// Turns the raw, timestamped pointer stream (InputState::events()) into
+// gestures. Each tracked pointer runs a small state machine in flat arrays:
+//
+//   Pending --slop--> Dragging --up--> Drag End (+ Fling if fast)
+//      |  \--up, short--> Tap
+//      \--held--> LongPressed --slop--> Dragging
+//
+// A second finger turns the first two into a pinch (any drag is canceled);
+// fingers beyond two, and the survivor of a pinch, are ignored until they lift.
+// Continuous Update gestures are emitted at most once per frame.
+class GestureRecognizer {
+public:
+    void configure(const GestureConfig& cfg) { cfg_ = cfg; }
+    const GestureConfig& config() const { return cfg_; }
+
+    // Feed one frame of events. now_ns (same clock as the events) drives long-press.
+    void update(EventSpan events, uint64_t now_ns);
+
+    GestureSpan gestures() const { return GestureSpan(out_, out_count_); }
+    uint64_t dropped() const { return dropped_; }
+
+    // Drops all in-flight gestures without emitting anything.
+    void reset();
+
+private:
+    enum State : uint8_t { Idle, Pending, LongPressed, Dragging, Pinching, Ignored };
+
+    int slot_of(int32_t id) const;
+    void on_down(const PointerEvent& e);
+    void on_move(const PointerEvent& e);
+    void on_up(const PointerEvent& e, bool canceled);
+    void start_pinch(int a, int b);
+    void end_pinch(GesturePhase phase);
+    float pinch_span() const;
+    void emit(GestureKind kind, GesturePhase phase, int32_t id, float x, float y, float value = 0.0f);
+
+    GestureConfig cfg_;
+
+    // Per pointer slot, structure-of-arrays.
+    State    state_[MAX_POINTERS] = {};
+    int32_t  id_[MAX_POINTERS] = {};
+    float    x_[MAX_POINTERS] = {};
+    float    y_[MAX_POINTERS] = {};
+    float    down_x_[MAX_POINTERS] = {};
+    float    down_y_[MAX_POINTERS] = {};
+    float    vx_[MAX_POINTERS] = {};
+    float    vy_[MAX_POINTERS] = {};
+    uint64_t down_ns_[MAX_POINTERS] = {};
+    uint64_t last_ns_[MAX_POINTERS] = {};
+    bool     moved_[MAX_POINTERS] = {};  // dirty this frame
+
+    // Pinch between two slots (-1 when none).
+    int pinch_a_ = -1;
+    int pinch_b_ = -1;
+    bool pinch_started_ = false;  // Begin sent (span moved past pinch_slop)
+    float pinch_span0_ = 0.0f;
+
+    Gesture out_[MAX_FRAME_GESTURES];
+    uint32_t out_count_ = 0;
+    uint64_t dropped_ = 0;
+};
+
+// Gestures travel as EPType::Gesture messages:
+//   a = kind | phase << 8 | (pointer_id & 0xffff) << 16, b/c/d = x/y/value float bits.
+rce::EPMsg gesture_to_msg(const Gesture& g);
+Gesture gesture_from_msg(const rce::EPMsg& msg);
+
+// Hands this frame's gestures to the dispatcher subscribers (engine thread).
+void dispatch_gestures(const GestureRecognizer& rec);
+
+} // namespace input
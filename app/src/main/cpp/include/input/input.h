@@ -1,13 +1,17 @@
 #pragma once
 #include <cstdint>
-#include <vector>
 
 namespace input {
 
+// Fixed capacities: nothing in here allocates after construction.
+static constexpr uint32_t MAX_POINTERS = 10;
+static constexpr uint32_t MAX_FRAME_EVENTS = 512;
+
 enum class EventType : uint8_t {
     PointerDown,
     PointerUp,
     PointerMove,
+    PointerCancel,  // gesture aborted by the system (treat like up, but don't act on it)
 };
 
 struct PointerEvent {
@@ -15,6 +19,54 @@ struct PointerEvent {
     int32_t pointer_id;
     float x;
     float y;
+    float pressure;
+    uint64_t timestamp_ns;  // same clock as rce::time_now_ns() (CLOCK_MONOTONIC)
+};
+
+// Pointer state bits (PointerTable::state)
+enum : uint8_t {
+    POINTER_DOWN     = 1u << 0,  // currently touching
+    POINTER_PRESSED  = 1u << 1,  // went down this frame
+    POINTER_RELEASED = 1u << 2,  // went up / was canceled this frame
+    POINTER_MOVED    = 1u << 3,  // moved this frame
+    POINTER_CANCELED = 1u << 4,
+};
+
+// All active pointers, structure-of-arrays, slots [0, count) in press order.
+// A released pointer keeps its slot (with POINTER_RELEASED) until the next
+// begin_frame(), so "went up this frame" is observable.
+struct PointerTable {
+    uint32_t count = 0;
+    int32_t  id[MAX_POINTERS];
+    float    x[MAX_POINTERS];
+    float    y[MAX_POINTERS];
+    float    start_x[MAX_POINTERS];
+    float    start_y[MAX_POINTERS];
+    float    pressure[MAX_POINTERS];
+    uint64_t down_ns[MAX_POINTERS];
+    uint64_t last_ns[MAX_POINTERS];
+    uint8_t  state[MAX_POINTERS];
+
+    int find(int32_t pointer_id) const {
+        for (uint32_t i = 0; i < count; i++) {
+            if (id[i] == pointer_id) return (int)i;
+        }
+        return -1;
+    }
+};
+
+// Read-only view over this frame's events.
+class EventSpan {
+public:
+    EventSpan(const PointerEvent* data, uint32_t size) : data_(data), size_(size) {}
+    const PointerEvent* begin() const { return data_; }
+    const PointerEvent* end() const { return data_ + size_; }
+    uint32_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    const PointerEvent& operator[](uint32_t i) const { return data_[i]; }
+private:
+    const PointerEvent* data_;
+    uint32_t size_;
 };
 
 class InputState {
@@ -22,24 +74,40 @@ public:
     InputState();
     ~InputState();
 
+    // Drops last frame's events and released pointers, clears per-frame bits.
     void begin_frame();
 
+    // Primary pointer (the oldest one still down; last known position otherwise).
     bool pointer_is_down() const;
     float pointer_x() const;
     float pointer_y() const;
 
-    const std::vector<PointerEvent>& events() const;
+    const PointerTable& pointers() const { return table_; }
 
-    // These are what platform layers call.
-    void push_pointer_down(int32_t id, float x, float y);
-    void push_pointer_up(int32_t id, float x, float y);
-    void push_pointer_move(int32_t id, float x, float y);
+    // Everything pushed since begin_frame(), in arrival order (historical
+    // samples included). When the buffer is full further events are dropped
+    // (counted), but the pointer table still tracks them.
+    EventSpan events() const { return EventSpan(events_, event_count_); }
+    uint64_t dropped_events() const { return dropped_events_; }
+
+    // These are what platform layers call. Timestamps are on the rce::time_now_ns() clock.
+    void push_pointer_down(int32_t id, float x, float y, uint64_t t_ns = 0, float pressure = 1.0f);
+    void push_pointer_up(int32_t id, float x, float y, uint64_t t_ns = 0, float pressure = 0.0f);
+    void push_pointer_move(int32_t id, float x, float y, uint64_t t_ns = 0, float pressure = 1.0f);
+    void push_pointer_cancel(int32_t id, uint64_t t_ns = 0);
 
 private:
-    bool pointer_down_;
-    float pointer_x_;
-    float pointer_y_;
-    std::vector<PointerEvent> events_;
+    void record(EventType type, int32_t id, float x, float y, float pressure, uint64_t t_ns);
+    void update_primary();
+
+    PointerTable table_;
+    PointerEvent events_[MAX_FRAME_EVENTS];
+    uint32_t event_count_ = 0;
+    uint64_t dropped_events_ = 0;
+
+    bool pointer_down_ = false;
+    float pointer_x_ = 0.0f;
+    float pointer_y_ = 0.0f;
 };
 
 } // namespace input
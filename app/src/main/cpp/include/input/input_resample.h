@@ -0,0 +1,99 @@
+#pragma once
+#include <cstdint>
+#include "app/event_pipe.h"
+#include "input/input.h"
+
+namespace input {
+
+struct ResampleConfig {
+    // Pointers are sampled at (present time - latency). 0 aims at the present
+    // time itself: the newest sample is normally older than that, so most
+    // frames predict along the pointer's velocity. A positive value gives up
+    // part of that latency win to interpolate between real samples instead.
+    uint64_t latency_ns = 0;
+    // Prediction horizon past the newest sample, about one 60 Hz frame. A
+    // target further out is only reached up to here.
+    uint64_t max_predict_ns = 16666667;
+    // Velocity confidence; no prediction when any of these fail:
+    // - the newest sample is at most max_sample_age_ns older than the target
+    //   (an older one means the pointer stopped reporting: it is holding still),
+    // - the two newest samples are at least min_sample_gap_ns apart (closer
+    //   ones give noisy velocities),
+    // - the last three samples don't reverse direction.
+    uint64_t max_sample_age_ns = 50000000;
+    uint64_t min_sample_gap_ns = 2000000;
+    bool predict = true;
+};
+
+// One pointer after resampling.
+struct ResampledPointer {
+    int32_t id;
+    float x, y;      // position at the sample time
+    float vx, vy;    // px/s from the two newest samples
+    uint8_t state;   // PointerTable state bits
+    bool predicted;  // extrapolated past the newest sample
+};
+
+// Pipeline stage that runs after a frame's platform input has been ingested
+// (InputState::begin_frame + push_*):
+//   - coalesced(): the frame's events with each run of moves per pointer
+//     collapsed to its newest move, which keeps that move's place in the
+//     stream (downs/ups/cancels always kept, everything stays in time order)
+//   - pointers(): every pointer resampled to the frame's present time
+// The raw stream stays available on InputState::events() for gesture code.
+class InputResampler {
+public:
+    void configure(const ResampleConfig& cfg) { cfg_ = cfg; }
+    const ResampleConfig& config() const { return cfg_; }
+
+    void update(const InputState& in, uint64_t present_ns);
+
+    uint32_t count() const { return count_; }
+    const ResampledPointer& pointer(uint32_t i) const { return out_[i]; }
+    const ResampledPointer* find(int32_t id) const;
+
+    // Primary pointer (first pointer in press order), falls back to InputState.
+    bool primary(float* x, float* y) const;
+
+    EventSpan coalesced() const { return EventSpan(coalesced_, coalesced_count_); }
+
+private:
+    static constexpr uint32_t HISTORY = 4;
+
+    struct Sample { uint64_t t; float x, y; };
+
+    // Per-pointer sample history, kept across frames.
+    struct Track {
+        int32_t id;
+        bool used;
+        uint32_t n;               // valid samples (<= HISTORY)
+        uint32_t head;            // next write
+        Sample s[HISTORY];
+
+        const Sample& newest(uint32_t back) const { return s[(head + HISTORY - 1 - back) % HISTORY]; }
+    };
+
+    Track* track_for(int32_t id, bool create);
+    void add_sample(Track& tr, const PointerEvent& e);
+    void resample(const Track& tr, uint64_t target_ns, ResampledPointer& out) const;
+
+    ResampleConfig cfg_;
+    Track tracks_[MAX_POINTERS] = {};
+
+    ResampledPointer out_[MAX_POINTERS];
+    uint32_t count_ = 0;
+
+    PointerEvent coalesced_[MAX_FRAME_EVENTS];
+    uint32_t coalesced_count_ = 0;
+};
+
+// Coalesced pointer events travel as EPType::Pointer messages:
+//   a = type | (pointer_id & 0xffff) << 16, b/c/d = x/y/pressure float bits.
+// The timestamp is not carried.
+rce::EPMsg pointer_to_msg(const PointerEvent& e);
+PointerEvent pointer_from_msg(const rce::EPMsg& msg);
+
+// Hands this frame's coalesced events to the dispatcher subscribers (engine thread).
+void dispatch_pointers(const InputResampler& rs);
+
+} // namespace input
@@ -0,0 +1,66 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// Per-lua_State allocator (lua_Alloc) for LuaRuntime.
+//
+// Small blocks (<= 256 bytes: TString, Table, Node arrays, closures, upvalues...)
+// come from size-class free lists carved out of 64 KB chunks; freeing pushes the
+// block back on its list, so steady-state churn never touches malloc. Larger
+// blocks fall through to malloc/realloc. Relies on Lua 5.1 passing the real old
+// size on every free/realloc, so blocks carry no header.
+//
+// Not thread-safe: one allocator per lua_State.
+
+struct LuaAllocStats {
+    uint64_t bytes_in_use = 0;   // as requested by Lua
+    uint64_t peak_bytes = 0;
+    uint64_t allocs = 0;         // new blocks
+    uint64_t frees = 0;
+    uint64_t reallocs = 0;       // resizes of live blocks
+    uint64_t large_allocs = 0;   // blocks that went to malloc
+    uint64_t pool_reserved = 0;  // bytes held in small-block chunks
+};
+
+class LuaPoolAllocator {
+public:
+    LuaPoolAllocator() = default;
+    ~LuaPoolAllocator();
+
+    // Non-copyable
+    LuaPoolAllocator(const LuaPoolAllocator&) = delete;
+    LuaPoolAllocator& operator=(const LuaPoolAllocator&) = delete;
+
+    // lua_Alloc entry point; ud is the LuaPoolAllocator*.
+    static void* lua_alloc(void* ud, void* ptr, size_t osize, size_t nsize);
+
+    // Returns all chunks to the system. Only valid once the lua_State is closed.
+    void release();
+
+    const LuaAllocStats& stats() const { return stats_; }
+
+private:
+    static constexpr size_t kGranule = 16;
+    static constexpr size_t kMaxSmall = 256;
+    static constexpr size_t kClasses = kMaxSmall / kGranule;
+    static constexpr size_t kChunkBytes = 64 * 1024;
+
+    struct FreeNode { FreeNode* next; };
+    struct Chunk { Chunk* next; };
+
+    static size_t class_of(size_t size) { return (size + kGranule - 1) / kGranule - 1; }
+
+    void* alloc(size_t size);
+    void free(void* p, size_t size);
+    void* realloc(void* p, size_t osize, size_t nsize);
+
+    void* alloc_small(size_t cls);
+    bool grow();
+
+    FreeNode* free_[kClasses] = {};
+    Chunk* chunks_ = nullptr;
+    char* bump_ = nullptr;
+    char* bump_end_ = nullptr;
+
+    LuaAllocStats stats_;
+};
@@ -0,0 +1,26 @@
+#pragma once
+#include <stdint.h>
+
+struct lua_State;
+
+// Precompiled bytecode cache under app::paths::get().cache + "/luac".
+//
+// Entries are keyed by source path and validated against the source's mtime,
+// size and content hash (FNV-1a 64), so edited scripts recompile automatically.
+// A hit skips the lexer/parser and goes straight through lundump.
+// With no cache dir set, loads behave exactly like luaL_loadfile.
+
+// Drop-in for luaL_loadfile: pushes the compiled chunk (or an error message)
+// and returns 0 / a LUA_ERR* code.
+int luax_loadfile_cached(lua_State* L, const char* path);
+
+// Replaces the Lua-file searcher in package.loaders so require() uses the cache too.
+void luax_install_cached_loader(lua_State* L);
+
+struct LuaBytecodeCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;      // compiled from source (new, stale or unreadable entry)
+    uint64_t writes = 0;
+    uint64_t write_errors = 0;
+};
+LuaBytecodeCacheStats luax_bytecode_cache_stats();
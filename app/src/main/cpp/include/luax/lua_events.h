@@ -0,0 +1,21 @@
+#pragma once
+#include "app/event_pipe.h"
+
+struct lua_State;
+
+// How EPMsgs look from Lua (on_event and wait_event results).
+//
+// Plain messages arrive as (type, a, b, c, d). Gestures are unpacked:
+//   (rce.events.Gesture, kind, phase, x, y, value, pointer_id)
+// with kind/phase from rce.gestures (Tap, LongPress, Drag, Pinch, Fling /
+// Begin, Update, End, Cancel); see input::Gesture for what x/y/value hold.
+// Pointer events are the frame's coalesced stream (at most one Move per
+// pointer between its other events):
+//   (rce.events.Pointer, kind, x, y, pointer_id, pressure)
+// with kind from rce.pointers (Down, Up, Move, Cancel).
+
+// Pushes the values for msg; returns how many.
+int luax_push_event(lua_State* L, const rce::EPMsg& msg);
+
+// Sets events = {...}, gestures = {...} and pointers = {...} on the table at the top of the stack.
+void luax_open_events(lua_State* L);
@@ -0,0 +1,59 @@
+#pragma once
+#include <stdint.h>
+
+struct lua_State;
+
+// Frame-budgeted incremental GC for LuaRuntime.
+//
+// Automatic collection is stopped; instead the engine calls step_frame() at the
+// end of each engine_tick and the collector gets whatever is left of the frame
+// budget, clamped to [min_pause_us, max_pause_us]. The amount of work asked for
+// follows the measured allocation rate, so the collector keeps up with the
+// script without landing a whole cycle mid-frame.
+//
+// Note: Lua 5.1's atomic phase is not incremental, so one step can overshoot the
+// bound on very large heaps; max_pause_us bounds how many steps we start.
+
+struct LuaGcConfig {
+    uint64_t frame_budget_ns = 16666667; // target frame time (60 Hz)
+    uint32_t max_pause_us = 1000;        // hard cap on GC time per frame
+    uint32_t min_pause_us = 100;         // spent even when the frame is over budget, if there is debt
+    uint32_t step_kb = 8;                // work per LUA_GCSTEP call
+    float work_ratio = 2.0f;             // collect this many KB per KB allocated (> 1 to catch up)
+    float emergency_growth = 2.0f;       // heap > this * live-after-last-cycle => spend max_pause_us
+};
+
+struct LuaGcStats {
+    uint64_t last_frame_ns = 0;          // GC time spent at the end of the last frame
+    uint64_t max_frame_ns = 0;
+    uint64_t total_ns = 0;
+    uint32_t last_steps = 0;
+    uint64_t total_steps = 0;
+    uint64_t cycles = 0;                 // completed collection cycles
+    uint32_t heap_kb = 0;                // after the last step_frame
+    uint32_t live_kb = 0;                // heap right after the last completed cycle
+    float alloc_kb_per_frame = 0.0f;     // smoothed allocation rate
+};
+
+class LuaGcController {
+public:
+    // Takes over collection for L (stops the automatic collector).
+    void attach(lua_State* L);
+    // Hands collection back to Lua's automatic mode.
+    void detach();
+
+    void configure(const LuaGcConfig& cfg) { cfg_ = cfg; }
+    const LuaGcConfig& config() const { return cfg_; }
+
+    // End-of-frame work; frame_start_ns is time_now_ns() at the top of the frame.
+    void step_frame(uint64_t frame_start_ns);
+
+    const LuaGcStats& stats() const { return stats_; }
+
+private:
+    lua_State* L_ = nullptr;
+    LuaGcConfig cfg_;
+    LuaGcStats stats_;
+    uint32_t prev_heap_kb_ = 0;
+    float debt_kb_ = 0.0f;               // collection work owed
+};
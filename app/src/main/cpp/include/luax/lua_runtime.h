@@ -1,4 +1,76 @@
 #pragma once
+#include "app/event_pipe.h"
+#include "luax/lua_alloc.h"
+#include "luax/lua_gc.h"
+#include "luax/lua_scheduler.h"
 
-// Returns true if the script ran successfully, false if Lua error (or invalid args).
-bool luax_run_file(const char* path);
+struct lua_State;
+
+// Long-lived Lua VM, owned by the engine (see rce::engine_lua()).
+//
+// The entry script is loaded once; after that scripts take part in the frame
+// through two optional hooks, resolved once and kept as registry refs:
+//   on_tick(dt)                 -- once per fixed simulation step
+//   on_event(type, a, b, c, d)  -- once per dispatched platform -> engine message
+//                                  (gestures and pointers unpack differently, see lua_events.h)
+// Define them as globals in the entry script, or register them explicitly with
+// rce.on_tick(fn) / rce.on_event(fn) (pass nil to clear).
+// A hook that raises an error is logged and cleared, so it can't spam every step.
+//
+// Scripts also get spawn/wait/wait_event (see LuaScheduler) and rce.events.<Name>
+// constants for the EPType values they can wait on (rce.gestures.<Name> and
+// rce.pointers.<Name> for the gesture and pointer kinds).
+class LuaRuntime {
+public:
+    LuaRuntime() = default;
+    ~LuaRuntime();
+
+    // Non-copyable
+    LuaRuntime(const LuaRuntime&) = delete;
+    LuaRuntime& operator=(const LuaRuntime&) = delete;
+
+    // Creates the state, opens libs, installs engine bindings (console_print, rce.*).
+    bool init();
+    void shutdown();
+    bool is_ready() const { return L_ != nullptr; }
+
+    // Runs the entry script once, then picks up global on_tick/on_event if the
+    // script didn't register hooks itself. Returns false on Lua error.
+    bool load_entry(const char* path);
+
+    void tick(float dt_s);
+    void dispatch_event(const rce::EPMsg& msg);
+
+    // console_print lines are buffered per thread and written in one batch;
+    // the engine calls this once per frame.
+    void flush_console();
+
+    lua_State* state() const { return L_; }
+
+    // Allocation counters for this state (also exposed to scripts as rce.mem_stats()).
+    const LuaAllocStats& alloc_stats() const { return alloc_.stats(); }
+
+    // Frame-budgeted GC (automatic collection is off while the runtime is up).
+    // Call once at the end of the frame; stats are also rce.gc_stats().
+    void gc_step(uint64_t frame_start_ns) { gc_.step_frame(frame_start_ns); }
+    LuaGcController& gc() { return gc_; }
+
+private:
+    static constexpr int kNoRef = -2; // LUA_NOREF
+
+    static int l_set_on_tick(lua_State* L);
+    static int l_set_on_event(lua_State* L);
+    static int l_mem_stats(lua_State* L);
+    static int l_gc_stats(lua_State* L);
+
+    void set_hook(int& ref, int idx);
+    bool pcall(int nargs, const char* what);
+
+    LuaPoolAllocator alloc_;
+    LuaGcController gc_;
+    LuaScheduler sched_;
+    lua_State* L_ = nullptr;
+    int ref_on_tick_ = kNoRef;
+    int ref_on_event_ = kNoRef;
+    int ref_traceback_ = kNoRef;
+};
@@ -0,0 +1,56 @@
+#pragma once
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+#include "app/event_dispatcher.h"
+#include "app/timer.h"
+
+struct lua_State;
+
+// Native coroutine scheduler for LuaRuntime. Installs three globals:
+//   spawn(fn, ...)        -- run fn as a script "thread" (starts immediately)
+//   wait(seconds)         -- sleep; parks the coroutine in the timer heap
+//   wait_event(type)      -- park until the next message of that EPType;
+//                            returns type, a, b, c, d
+// A parked coroutine costs nothing per frame: it is only touched when its
+// timer fires or its event is dispatched. A bare coroutine.yield() inside a
+// spawned thread behaves like wait(0) (resume on the next update).
+// An error inside a spawned thread is logged and ends that thread only.
+class LuaScheduler {
+public:
+    void attach(lua_State* L);
+    // Cancels pending timers/subscriptions and forgets every task (call before lua_close).
+    void detach();
+
+    size_t task_count() const { return tasks_.size(); }
+    // Spawned threads that ended in an error since attach().
+    uint64_t error_count() const { return errors_; }
+
+private:
+    static constexpr uint32_t kNotWaiting = 0xFFFFFFFFu;
+
+    struct Task {
+        int ref = -2;                    // registry ref anchoring the thread
+        rce::TimerId timer = 0;          // pending wait()
+        uint32_t waiting = kNotWaiting;  // EPType index for wait_event()
+        bool parked = false;             // set by wait/wait_event right before yielding
+    };
+
+    static int l_spawn(lua_State* L);
+    static int l_wait(lua_State* L);
+    static int l_wait_event(lua_State* L);
+
+    void resume(lua_State* co, int nargs);
+    void release(lua_State* co);
+    void on_timer(lua_State* co);
+    void on_event(uint32_t ti, const rce::EPMsg& msg);
+    void park_timer(lua_State* co, Task& t, float seconds);
+
+    lua_State* L_ = nullptr;
+    std::unordered_map<lua_State*, Task> tasks_;
+    std::vector<lua_State*> event_waiters_[rce::EP_TYPE_COUNT];
+    std::vector<lua_State*> woken_[rce::EP_TYPE_COUNT]; // on_event scratch, swapped with event_waiters_
+    rce::EPSubscription subs_[rce::EP_TYPE_COUNT] = {};
+    uint64_t errors_ = 0;
+};
@@ -0,0 +1,41 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+
+struct lua_State;
+
+// Native Lua value serializer (replaces the old Lua-side spickle dump).
+//
+// Two output formats:
+//   Binary - compact, round-trips through luax_deserialize. Shared and cyclic
+//            tables are written once and referenced by id afterwards.
+//   Text   - the readable spickle layout (tab indented "key = value," lines);
+//            a table seen a second time prints <circular reference>.
+// Keys are emitted in a fixed order (numbers ascending, then strings bytewise,
+// then booleans; other key types last in traversal order), so equal tables
+// serialize to equal bytes. Tables are read raw (no metamethods) and the
+// output goes straight into one growable buffer, with no Lua strings in between.
+// Functions, userdata and threads can't be stored in binary and are skipped;
+// in text they print as <type> unless hide_non_text is set.
+
+enum class LuaSerializeFormat : uint8_t { Binary, Text };
+
+struct LuaSerializeOptions {
+    LuaSerializeFormat format = LuaSerializeFormat::Binary;
+    bool hide_non_text = false;  // text only: drop functions/userdata/threads
+    uint32_t max_depth = 128;    // nesting limit (C stack guard)
+};
+
+// Appends the value at idx to out. Returns false (with a message in err) when
+// the nesting limit is hit in binary mode.
+bool luax_serialize(lua_State* L, int idx, const LuaSerializeOptions& opts,
+                    std::string& out, std::string* err = nullptr);
+
+// Decodes a binary buffer and pushes the value. On failure pushes nothing,
+// fills err and returns false.
+bool luax_deserialize(lua_State* L, const char* data, size_t len, std::string* err = nullptr);
+
+// Adds serialize/deserialize to the table on top of the stack:
+//   rce.serialize(value [, { format = "binary"|"text", hide_non_text = bool }]) -> string
+//   rce.deserialize(string) -> value | nil, err
+void luax_open_serialize(lua_State* L);
@@ -1,20 +1,47 @@
 #pragma once
+#include <stdint.h>
 #include <vector>
 #include <string>
 #include "gfx/presentation_types.h"
+#include "gfx/render_scale.h"
 
 struct android_app;
 
 namespace platform::android_presentation {
 
+    // Platform-defined presentation modes.
+    enum class PresentationMode : uint8_t {
+        FitModern,   // edge-to-edge output, safe rect avoids bars/cutouts
+        FitClassic,  // output (and scissor) inside the insets
+        Immersive,   // full surface, OS UI hidden
+        Count
+    };
+
+    // One precompiled strategy per mode, in a static table indexed by the
+    // enum. Mode names only matter at the edges (config, logs), never per frame.
+    struct PresentationStrategy {
+        PresentationMode mode;
+        const char* id;   // "fit_modern", ...
+        int java_mode;    // MyNativeActivity.setUiMode() value
+        void (*compute)(const SurfaceMetrics& m, PresentationResult& res);
+    };
+
+    const PresentationStrategy& strategy(PresentationMode mode);
+
+    // Name -> mode; false (and *out untouched) for unknown names.
+    bool mode_from_id(const char* id, PresentationMode* out);
+
     // Returns platform-defined mode IDs (strings).
     std::vector<std::string> get_modes();
 
     // Apply OS-level UI behavior for a mode (immersive, decor fits, etc.)(if desired)
-    void apply_mode(android_app* app, const std::string& mode_id);
+    void apply_mode(android_app* app, PresentationMode mode);
 
-    // Compute output/safe rect primitives for a mode from SurfaceMetrics.
-    PresentationResult compute_result(const std::string& mode_id, const SurfaceMetrics& m);
+    // Compute output/safe rect primitives for a mode from SurfaceMetrics,
+    // plus the offscreen render target: rt's size (or the output rect's)
+    // times render_scale, from gfx/dynamic_resolution.h.
+    PresentationResult compute_result(PresentationMode mode, const SurfaceMetrics& m,
+                                      const RenderTargetConfig& rt = RenderTargetConfig{},
+                                      float render_scale = 1.0f);
 
 }
-
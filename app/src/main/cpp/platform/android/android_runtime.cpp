@@ -13,22 +13,26 @@ void init(android_app* app) {
 }
 
 void pump_engine_commands() {
-    rce::EPMsg msg;
-    while (rce::ep_poll_e2p(&msg)) {
-        switch (msg.type) {
-            case rce::EPType::SetAllowedRotations:
-                rce_android_set_allowed_rotations(msg.a);
-                break;
-
-            case rce::EPType::SetUiMode:
-                // If you later expose rce_android_set_ui_mode(...)
-                // rce_android_set_ui_mode(msg.a);
-                break;
-
-            default:
-                // For now: ignore
-                // LOGI("Unhandled e2p msg type=%d", (int)msg.type);
-                break;
+    rce::EPMsg batch[32];
+    size_t n;
+    while ((n = rce::ep_drain_e2p(batch, 32)) > 0) {
+        for (size_t i = 0; i < n; i++) {
+            const rce::EPMsg& msg = batch[i];
+            switch (msg.type) {
+                case rce::EPType::SetAllowedRotations:
+                    rce_android_set_allowed_rotations(msg.a);
+                    break;
+
+                case rce::EPType::SetUiMode:
+                    // If you later expose rce_android_set_ui_mode(...)
+                    // rce_android_set_ui_mode(msg.a);
+                    break;
+
+                default:
+                    // For now: ignore
+                    // LOGI("Unhandled e2p msg type=%d", (int)msg.type);
+                    break;
+            }
         }
     }
 }
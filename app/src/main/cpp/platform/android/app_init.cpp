@@ -1,7 +1,6 @@
 #include <android_native_app_glue.h>
 
 #include <string>
-#include <android/input.h>
 
 // project headers
 //// generics
@@ -23,17 +22,19 @@
 //// input and device management
 #include "platform/android/input_android.h"
 #include "input/input.h"
+#include "input/input_resample.h"
+#include "input/gesture.h"
 
 //// graphical output
 #include "gfx/egl_renderer.h"
 #include "gfx/presentation_types.h"
+#include "gfx/render_scale.h"
+#include "gfx/dynamic_resolution.h"
+#include "gfx/simd_kernels.h"
 
 //// lua subsystem
 #include "luax/lua_runtime.h"
 
-// temporary
-#include <time.h>
-
 // from platform/android/paths_android.cpp
 namespace app::paths { void init_from_android_app(android_app* app); }
 
@@ -46,21 +47,23 @@ int ui_inset_bottom();
 struct AppState {
     EglRenderer renderer;
     input::InputState input;
+    input::InputResampler resampler;
+    input::GestureRecognizer gestures;
     bool animating = false;
 
-    std::string presentation_mode = "fit_classic"; // default
+    platform::android_presentation::PresentationMode presentation_mode =
+        platform::android_presentation::PresentationMode::FitClassic; // default
+    // Cached result; recomputed on InsetsChanged / SurfaceResized / render scale change.
+    PresentationState presentation;
+    // Internal resolution; 0x0 renders straight into the output rect.
+    // e.g. {640, 360, ScalePolicy::Integer} for pixel art.
+    RenderTargetConfig render_target;
+    // Render scale from frame timing (1.0 until frames run over budget).
+    DynamicResolution dynres;
 	
 	int pending_resize_frames = 0;
 };
 
-// temporary
-uint64_t platform_now_ms() {
-    timespec ts;
-    clock_gettime(CLOCK_MONOTONIC, &ts);
-    return uint64_t(ts.tv_sec) * 1000ull +
-           uint64_t(ts.tv_nsec) / 1000000ull;
-}
-
 static void handle_cmd(android_app* app, int32_t cmd) {
     auto* st = (AppState*)app->userData;
 
@@ -70,6 +73,7 @@ static void handle_cmd(android_app* app, int32_t cmd) {
             LOGI("APP_CMD_INIT_WINDOW");
             if (st->renderer.init((void*)app->window)) {
                 st->animating = true;
+                st->presentation.invalidate(); // new surface
 
                 // Optional OS/UI request; simulation happens regardless.
                 platform::android_presentation::apply_mode(app, st->presentation_mode);
@@ -105,59 +109,6 @@ static void handle_cmd(android_app* app, int32_t cmd) {
     }
 }
 
-static int32_t handle_input(android_app* app, AInputEvent* event) {
-    auto* st = (AppState*)app->userData;
-    if (!st) return 0;
-
-    if (AInputEvent_getType(event) != AINPUT_EVENT_TYPE_MOTION) return 0;
-
-    const int32_t source = AInputEvent_getSource(event);
-    if ((source & AINPUT_SOURCE_TOUCHSCREEN) == 0 &&
-        (source & AINPUT_SOURCE_MOUSE) == 0 &&
-        (source & AINPUT_SOURCE_STYLUS) == 0) {
-        return 0;
-    }
-
-    const int32_t action = AMotionEvent_getAction(event);
-    const int32_t action_mask = action & AMOTION_EVENT_ACTION_MASK;
-
-    const int32_t pointer_index = (action & AMOTION_EVENT_ACTION_POINTER_INDEX_MASK)
-                                >> AMOTION_EVENT_ACTION_POINTER_INDEX_SHIFT;
-
-    const int32_t pointer_id = AMotionEvent_getPointerId(event, pointer_index);
-    const float x = AMotionEvent_getX(event, pointer_index);
-    const float y = AMotionEvent_getY(event, pointer_index);
-
-    switch (action_mask) {
-        case AMOTION_EVENT_ACTION_DOWN:
-        case AMOTION_EVENT_ACTION_POINTER_DOWN:
-            st->input.push_pointer_down(pointer_id, x, y);
-            return 1;
-
-        case AMOTION_EVENT_ACTION_UP:
-        case AMOTION_EVENT_ACTION_POINTER_UP:
-        case AMOTION_EVENT_ACTION_CANCEL:
-            st->input.push_pointer_up(pointer_id, x, y);
-            return 1;
-
-        case AMOTION_EVENT_ACTION_MOVE: {
-            const int32_t count = AMotionEvent_getPointerCount(event);
-            if (count > 0) {
-                const int32_t id0 = AMotionEvent_getPointerId(event, 0);
-                const float x0 = AMotionEvent_getX(event, 0);
-                const float y0 = AMotionEvent_getY(event, 0);
-                st->input.push_pointer_move(id0, x0, y0);
-            } else {
-                st->input.push_pointer_move(pointer_id, x, y);
-            }
-            return 1;
-        }
-
-        default:
-            return 0;
-    }
-}
-
 static SurfaceMetrics build_surface_metrics(const AppState& st) {
     SurfaceMetrics m{};
     m.surface_w = st.renderer.width();
@@ -175,14 +126,13 @@ void android_main(struct android_app* app) {
     AppState state;
     app->userData = &state;
     app->onAppCmd = handle_cmd;
-    app->onInputEvent = handle_input;
 	
 	// start time control system
 	
 	// initialize various app subsystems
 	platform::android_runtime::init(app);
 	rce::engine_init();
-	rce::time_init(platform_now_ms());
+	rce::time_init(rce::time_now_ns());
 	
 	// mark as landscape (this gets overwritten currently)
 	// this is very temporary anyways for testing stuff, this should be called by core app functionality, not platform code.
@@ -200,14 +150,15 @@ void android_main(struct android_app* app) {
 
     // Init platform paths once.
     app::paths::init_from_android_app(app);
+    rce::log_open_file(app::paths::get().logs.c_str());
 
-    // Run Lua script (current behavior)
+    // Load the entry script into the engine's persistent Lua VM
     const auto& p = app::paths::get();
     if (!p.data.empty()) {
         std::string script = app::paths::join(p.data, "scripts/main.lua");
         LOGI("Trying Lua script: %s", script.c_str());
-        luax_run_file(script.c_str());
-        LOGI("Returned from luax_run_file()");
+        rce::engine_load_script(script.c_str());
+        LOGI("Returned from engine_load_script()");
     } else {
         LOGE("No valid data directory (paths.data is empty)");
         return;
@@ -216,10 +167,16 @@ void android_main(struct android_app* app) {
     int events = 0;
     android_poll_source* source = nullptr;
 	
+	// These capture the stack AppState: dropped before android_main returns,
+	// since the glue can call it again in the same process.
 	// RegisterEvent("InsetsChanged", _callback)
-	rce::ep_subscribe(rce::EPType::InsetsChanged, [](const rce::EPMsg& msg) {
+	const rce::EPSubscription insets_sub = rce::ep_subscribe(rce::EPType::InsetsChanged, [&state](const rce::EPMsg& msg) {
 		LOGI("Insets changed via dispatcher: %u %u %u %u",
 			 msg.a, msg.b, msg.c, msg.d);
+		state.presentation.invalidate();
+	});
+	const rce::EPSubscription resized_sub = rce::ep_subscribe(rce::EPType::SurfaceResized, [&state](const rce::EPMsg&) {
+		state.presentation.invalidate();
 	});
 	
 	
@@ -230,7 +187,7 @@ void android_main(struct android_app* app) {
 	float hsv_hue = 0.0f;
 	
 	// timer: every 1 second, add 0.1 to hsv_hue, loop around when needed
-	rce::timers_every(0.1f, [&hsv_hue](rce::TimerId) {
+	const rce::TimerId hue_timer = rce::timers_every(0.1f, [&hsv_hue](rce::TimerId) {
 		hsv_hue += 0.001f;
 		if (hsv_hue >= 1.0f) hsv_hue -= 1.0f;
 	});
@@ -249,7 +206,12 @@ void android_main(struct android_app* app) {
             if (source) source->process(app, source);
 
             if (app->destroyRequested) {
+                rce::ep_unsubscribe(insets_sub);
+                rce::ep_unsubscribe(resized_sub);
+                rce::timers_cancel(hue_timer);
                 state.renderer.shutdown();
+                rce::engine_shutdown();
+                rce::log_flush();
                 return;
             }
 
@@ -257,37 +219,59 @@ void android_main(struct android_app* app) {
             timeout_ms = 0;
         }
 		
+		// Resample touches to when this frame should reach the screen (~one
+		// vsync after we start building it). The newest sample is older than
+		// that, so pointers are predicted along their velocity, up to a frame ahead.
+		const uint64_t input_now_ns = rce::time_now_ns();
+		const uint64_t frame_work_start_ns = input_now_ns;
+		state.resampler.update(state.input, input_now_ns + 16666667ull);
+		input::dispatch_pointers(state.resampler);
+		
+		// Gestures see the raw samples; scripts get them through on_event.
+		state.gestures.update(state.input.events(), input_now_ns);
+		input::dispatch_gestures(state.gestures);
+		
 		platform::android_runtime::pump_engine_commands();
 		
-		// compute deltatime
-		float dt = rce::time_update(platform_now_ms());
-		rce::engine_tick(dt);
+		// compute deltatime (integer ns; engine turns it into fixed steps)
+		uint64_t dt_ns = rce::time_update(rce::time_now_ns());
+		rce::engine_tick(dt_ns);
 		
         if (state.renderer.is_ready() && state.animating) {
 			if (state.pending_resize_frames > 0) {
 				if (state.renderer.recalc_surface_size()) {
 					// size changed again; keep checking a couple more frames
 					state.pending_resize_frames = 3;
+					
+					// We're on the engine thread (p2e belongs to the UI thread): dispatch directly.
+					rce::EPMsg rs{};
+					rs.type = rce::EPType::SurfaceResized;
+					rs.a = (uint32_t)state.renderer.width();
+					rs.b = (uint32_t)state.renderer.height();
+					rce::ep_dispatch(rs);
 				} else {
 					state.pending_resize_frames--;
 				}
 			}
 			
-            // Compute and apply presentation primitives each frame for now.
-            // (Later: only recompute when insets/mode changes.)
-            SurfaceMetrics m = build_surface_metrics(state);
-            PresentationResult pr = platform::android_presentation::compute_result(state.presentation_mode, m);
-
-            // Apply output rect (viewport)
-            state.renderer.set_viewport(pr.output_rect.x, pr.output_rect.y, pr.output_rect.w, pr.output_rect.h);
-			// New: scissor restricts clears/draws to output rect
-			state.renderer.set_output_rect(pr.output_rect);
-			
-			if (state.presentation_mode == "fit_classic") {
-				state.renderer.set_scissor_rect(pr.output_rect); // **this is the key**
-			} else {
-				state.renderer.clear_scissor();
-			}
+            // Presentation primitives are only recomputed when an input changed;
+            // the renderer re-applies them only when the generation moves.
+            if (state.presentation.dirty()) {
+                const SurfaceMetrics m = build_surface_metrics(state);
+                const PresentationResult fresh = platform::android_presentation::compute_result(
+                    state.presentation_mode, m, state.render_target, state.dynres.scale());
+                if (state.presentation.update(fresh)) {
+                    LOGI("presentation: mode=%s surface=%dx%d insets LTRB=%d,%d,%d,%d output=%d,%d %dx%d gen=%u",
+                         platform::android_presentation::strategy(state.presentation_mode).id,
+                         m.surface_w, m.surface_h, m.inset_l, m.inset_t, m.inset_r, m.inset_b,
+                         fresh.output_rect.x, fresh.output_rect.y, fresh.output_rect.w, fresh.output_rect.h,
+                         state.presentation.generation());
+                }
+            }
+            const PresentationResult& pr = state.presentation.result();
+            // Output rect (viewport), scissor for clip_to_output modes, and the
+            // offscreen target (if any) blitted into present_rect.
+            state.renderer.apply_presentation(pr, state.presentation.generation());
 			
 			platform::android_runtime::pump_engine_commands();
 
@@ -307,7 +291,7 @@ void android_main(struct android_app* app) {
                 if (b < 0.0f) b = 0.0f; else if (b > 1.0f) b = 1.0f;
             }
 			LOGI("mode=%s surface=%dx%d insets LTRB=%d,%d,%d,%d output=%d,%d %dx%d",
-				state.presentation_mode.c_str(),
+				platform::android_presentation::strategy(state.presentation_mode).id,
 				m.surface_w, m.surface_h,
 				m.inset_l, m.inset_t, m.inset_r, m.inset_b,
 				pr.output_rect.x, pr.output_rect.y, pr.output_rect.w, pr.output_rect.h);
@@ -323,33 +307,34 @@ void android_main(struct android_app* app) {
 			float hsv_value = 0.0f;
 			
 			if (w > 0.0f && h > 0.0f) {
-                hsv_value = state.input.pointer_x() / w;
-                hsv_saturation = state.input.pointer_y() / h;
+                float px = state.input.pointer_x();
+                float py = state.input.pointer_y();
+                state.resampler.primary(&px, &py);
+                hsv_value = px / w;
+                hsv_saturation = py / h;
 
                 //if (hsv_hue < 0.0f) hsv_hue = 0.0f; else if (hsv_hue > 1.0f) hsv_hue = 1.0f;
                 if (hsv_saturation < 0.0f) hsv_saturation = 0.0f; else if (hsv_saturation > 1.0f) hsv_saturation = 1.0f;
 				if (hsv_value < 0.0f) hsv_value = 0.0f; else if (hsv_value > 1.0f) hsv_value = 1.0f;
             }
 			
-            // Map x -> hsv_hue and y -> hsv_saturation with value fixed at 1.0.
-            const float h6 = hsv_hue * 6.0f;
-            const int i = (int)h6;
-            const float f = h6 - (float)i;
-            const float p = hsv_value * (1.0f - hsv_saturation);
-            const float q = hsv_value * (1.0f - hsv_saturation * f);
-            const float t = hsv_value * (1.0f - hsv_saturation * (1.0f - f));
-
+            // Map x -> hsv_value and y -> hsv_saturation, hue drifts on the timer.
             float r = 0.0f, g = 0.0f, b = 0.0f;
-            switch (i % 6) {
-                case 0: r = hsv_value; g = t;     b = p;     break;
-                case 1: r = q;     g = hsv_value; b = p;     break;
-                case 2: r = p;     g = hsv_value; b = t;     break;
-                case 3: r = p;     g = q;     b = hsv_value; break;
-                case 4: r = t;     g = p;     b = hsv_value; break;
-                case 5: r = hsv_value; g = p;     b = q;     break;
+            simd_hsv_to_rgb(&hsv_hue, &hsv_saturation, &hsv_value, 1, &r, &g, &b);
+
+            // Present pass goes under whatever the engine recorded this frame.
+            RenderCommandBuffer& cmds = rce::engine_render_commands();
+            state.renderer.record_frame(cmds, r, g, b);
+
+            // CPU side is the frame's work up to submit (swap blocks on vsync,
+            // so it's left out); GPU side comes from the timer queries.
+            const uint64_t cpu_ns = rce::time_now_ns() - frame_work_start_ns;
+            state.renderer.submit(cmds);
+            if (state.dynres.update(cpu_ns, state.renderer.gpu_frame_ns())) {
+                state.presentation.invalidate();
+                LOGI("dynres: render scale %.2f (frame %.2fms)",
+                     (double)state.dynres.scale(), (double)state.dynres.filtered_ms());
             }
-
-            state.renderer.render_frame(r, g, b);
         }
     }
 }
@@ -7,6 +7,36 @@ namespace platform::android_input {
 
 static input::InputState* g_input = nullptr;
 
+// Motion event times are CLOCK_MONOTONIC ns, the same clock as rce::time_now_ns().
+static uint64_t event_ns(int64_t t) { return t > 0 ? (uint64_t)t : 0; }
+
+// Every pointer, oldest historical batch first, then the current sample.
+// On 120-240 Hz panels one ACTION_MOVE carries several samples per pointer.
+static void ingest_moves(const AInputEvent* event) {
+    const size_t count = AMotionEvent_getPointerCount(event);
+    const size_t history = AMotionEvent_getHistorySize(event);
+
+    for (size_t h = 0; h < history; h++) {
+        const uint64_t t = event_ns(AMotionEvent_getHistoricalEventTime(event, h));
+        for (size_t p = 0; p < count; p++) {
+            g_input->push_pointer_move(AMotionEvent_getPointerId(event, p),
+                                       AMotionEvent_getHistoricalX(event, p, h),
+                                       AMotionEvent_getHistoricalY(event, p, h),
+                                       t,
+                                       AMotionEvent_getHistoricalPressure(event, p, h));
+        }
+    }
+
+    const uint64_t t = event_ns(AMotionEvent_getEventTime(event));
+    for (size_t p = 0; p < count; p++) {
+        g_input->push_pointer_move(AMotionEvent_getPointerId(event, p),
+                                   AMotionEvent_getX(event, p),
+                                   AMotionEvent_getY(event, p),
+                                   t,
+                                   AMotionEvent_getPressure(event, p));
+    }
+}
+
 static int32_t handle_input(android_app* app, AInputEvent* event) {
     (void)app;
     if (!g_input) return 0;
@@ -23,40 +53,39 @@ static int32_t handle_input(android_app* app, AInputEvent* event) {
     const int32_t action = AMotionEvent_getAction(event);
     const int32_t action_mask = action & AMOTION_EVENT_ACTION_MASK;
 
-    const int32_t pointer_index =
-        (action & AMOTION_EVENT_ACTION_POINTER_INDEX_MASK) >>
-        AMOTION_EVENT_ACTION_POINTER_INDEX_SHIFT;
+    const size_t pointer_index =
+        (size_t)((action & AMOTION_EVENT_ACTION_POINTER_INDEX_MASK) >>
+                 AMOTION_EVENT_ACTION_POINTER_INDEX_SHIFT);
 
     const int32_t pointer_id = AMotionEvent_getPointerId(event, pointer_index);
     const float x = AMotionEvent_getX(event, pointer_index);
     const float y = AMotionEvent_getY(event, pointer_index);
+    const float pressure = AMotionEvent_getPressure(event, pointer_index);
+    const uint64_t t = event_ns(AMotionEvent_getEventTime(event));
 
     switch (action_mask) {
         case AMOTION_EVENT_ACTION_DOWN:
         case AMOTION_EVENT_ACTION_POINTER_DOWN:
-            g_input->push_pointer_down(pointer_id, x, y);
+            g_input->push_pointer_down(pointer_id, x, y, t, pressure);
             return 1;
 
         case AMOTION_EVENT_ACTION_UP:
         case AMOTION_EVENT_ACTION_POINTER_UP:
-        case AMOTION_EVENT_ACTION_CANCEL:
-            g_input->push_pointer_up(pointer_id, x, y);
+            g_input->push_pointer_up(pointer_id, x, y, t, pressure);
             return 1;
 
-        case AMOTION_EVENT_ACTION_MOVE: {
-            // Primary pointer only for now.
-            const int32_t count = AMotionEvent_getPointerCount(event);
-            if (count > 0) {
-                const int32_t id0 = AMotionEvent_getPointerId(event, 0);
-                const float x0 = AMotionEvent_getX(event, 0);
-                const float y0 = AMotionEvent_getY(event, 0);
-                g_input->push_pointer_move(id0, x0, y0);
-            } else {
-                g_input->push_pointer_move(pointer_id, x, y);
+        case AMOTION_EVENT_ACTION_CANCEL: {
+            const size_t count = AMotionEvent_getPointerCount(event);
+            for (size_t p = 0; p < count; p++) {
+                g_input->push_pointer_cancel(AMotionEvent_getPointerId(event, p), t);
             }
             return 1;
         }
 
+        case AMOTION_EVENT_ACTION_MOVE:
+            ingest_moves(event);
+            return 1;
+
         default:
             return 0;
     }
@@ -5,6 +5,8 @@
 
 #include "app/log.h"
 
+#include <string.h>
+
 // from platform/android/ui_insets_jni.cpp
 int ui_inset_left();
 int ui_inset_top();
@@ -13,15 +15,80 @@ int ui_inset_bottom();
 
 namespace platform::android_presentation {
 
-static int mode_id_to_java(const std::string& mode_id) {
-    if (mode_id == "fit_classic") return 0;
-    if (mode_id == "fit_modern")  return 1;
-    if (mode_id == "immersive")   return 2;
-    return 1; // default: modern
+static RectI clamp_rect_to_surface(const RectI& r, int sw, int sh) {
+    RectI out = r;
+    if (out.x < 0) out.x = 0;
+    if (out.y < 0) out.y = 0;
+    if (out.w < 1) out.w = 1;
+    if (out.h < 1) out.h = 1;
+
+    if (out.x + out.w > sw) out.w = sw - out.x;
+    if (out.y + out.h > sh) out.h = sh - out.y;
+
+    if (out.w < 1) out.w = 1;
+    if (out.h < 1) out.h = 1;
+    return out;
+}
+
+// GL viewport is bottom-left origin.
+// Android insets arrive as left/top/right/bottom, where "top" is the top edge.
+// For viewport offset Y, we use inset_b (bottom).
+static RectI inset_rect(const SurfaceMetrics& m) {
+    const RectI classic = {
+        m.inset_l,
+        m.inset_b,
+        m.surface_w - (m.inset_l + m.inset_r),
+        m.surface_h - (m.inset_t + m.inset_b)
+    };
+    return clamp_rect_to_surface(classic, m.surface_w, m.surface_h);
+}
+
+static void compute_fit_modern(const SurfaceMetrics& m, PresentationResult& res) {
+    res.output_rect = { 0, 0, m.surface_w, m.surface_h };
+    // Safe rect avoids bars/cutouts, but output is still edge-to-edge.
+    res.safe_rect = inset_rect(m);
+}
+
+static void compute_fit_classic(const SurfaceMetrics& m, PresentationResult& res) {
+    res.output_rect = inset_rect(m);
+    res.safe_rect = res.output_rect;
+    res.clip_to_output = true;
+}
+
+static void compute_immersive(const SurfaceMetrics& m, PresentationResult& res) {
+    res.output_rect = { 0, 0, m.surface_w, m.surface_h };
+    res.safe_rect = res.output_rect;
+    res.request_immersive = true;
+}
+
+static const PresentationStrategy kStrategies[] = {
+    { PresentationMode::FitModern,  "fit_modern",  1, compute_fit_modern },
+    { PresentationMode::FitClassic, "fit_classic", 0, compute_fit_classic },
+    { PresentationMode::Immersive,  "immersive",   2, compute_immersive },
+};
+static_assert(sizeof(kStrategies) / sizeof(kStrategies[0]) == (size_t)PresentationMode::Count,
+              "one strategy per PresentationMode, in enum order");
+
+const PresentationStrategy& strategy(PresentationMode mode) {
+    const size_t i = (size_t)mode;
+    return i < (size_t)PresentationMode::Count ? kStrategies[i] : kStrategies[0]; // default: modern
+}
+
+bool mode_from_id(const char* id, PresentationMode* out) {
+    if (!id) return false;
+    for (const PresentationStrategy& s : kStrategies) {
+        if (strcmp(s.id, id) == 0) {
+            *out = s.mode;
+            return true;
+        }
+    }
+    return false;
 }
 
 std::vector<std::string> get_modes() {
-    return { "fit_modern", "fit_classic", "immersive" };
+    std::vector<std::string> out;
+    for (const PresentationStrategy& s : kStrategies) out.emplace_back(s.id);
+    return out;
 }
 
 // Android-only: call activity.setUiMode(int)
@@ -57,59 +124,16 @@ static void set_ui_mode(android_app* app, int mode) {
     // Optional detach; native_app_glue thread is long-lived, so leaving attached is OK.
 }
 
-void apply_mode(android_app* app, const std::string& mode_id) {
+void apply_mode(android_app* app, PresentationMode mode) {
     // Even if Android ignores this, our engine simulation still works via output_rect.
-    const int java_mode = mode_id_to_java(mode_id);
-    set_ui_mode(app, java_mode);
-}
-
-static RectI clamp_rect_to_surface(const RectI& r, int sw, int sh) {
-    RectI out = r;
-    if (out.x < 0) out.x = 0;
-    if (out.y < 0) out.y = 0;
-    if (out.w < 1) out.w = 1;
-    if (out.h < 1) out.h = 1;
-
-    if (out.x + out.w > sw) out.w = sw - out.x;
-    if (out.y + out.h > sh) out.h = sh - out.y;
-
-    if (out.w < 1) out.w = 1;
-    if (out.h < 1) out.h = 1;
-    return out;
+    set_ui_mode(app, strategy(mode).java_mode);
 }
 
-PresentationResult compute_result(const std::string& mode_id, const SurfaceMetrics& m) {
+PresentationResult compute_result(PresentationMode mode, const SurfaceMetrics& m,
+                                  const RenderTargetConfig& rt, float render_scale) {
     PresentationResult res{};
-
-    const RectI full = { 0, 0, m.surface_w, m.surface_h };
-
-    // GL viewport is bottom-left origin.
-    // Android insets arrive as left/top/right/bottom, where "top" is the top edge.
-    // For viewport offset Y, we use inset_b (bottom).
-    const RectI classic = {
-        m.inset_l,
-        m.inset_b,
-        m.surface_w - (m.inset_l + m.inset_r),
-        m.surface_h - (m.inset_t + m.inset_b)
-    };
-
-    if (mode_id == "fit_classic") {
-        res.output_rect = clamp_rect_to_surface(classic, m.surface_w, m.surface_h);
-        res.safe_rect   = res.output_rect;
-        res.request_immersive = false;
-    } else if (mode_id == "immersive") {
-        res.output_rect = full;
-        res.safe_rect   = full;
-        res.request_immersive = true;
-    } else { // fit_modern default
-        res.output_rect = full;
-
-        // Safe rect avoids bars/cutouts, but output is still edge-to-edge.
-        RectI safe = classic;
-        res.safe_rect = clamp_rect_to_surface(safe, m.surface_w, m.surface_h);
-        res.request_immersive = false;
-    }
-
+    strategy(mode).compute(m, res);
+    apply_render_target(res, rt, render_scale);
     return res;
 }
 
@@ -0,0 +1,546 @@
+// Headless host entry point (Linux).
+// Drives the same engine loop as android_main, but with a null renderer,
+// scripted input and a deterministic clock, so engine hot paths can be run
+// under perf / sanitizers / long soaks on a desktop box.
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// project headers
+//// generics
+#include "app/log.h"
+#include "app/paths.h"
+#include "app/time.h"
+#include "app/event_pipe.h"
+#include "app/event_dispatcher.h"
+#include "app/timer.h"
+
+#include "app/engine.h"
+
+//// input and device management
+#include "input/input.h"
+#include "input/input_resample.h"
+#include "input/gesture.h"
+
+//// graphical output
+#include "gfx/gl_state_cache.h"
+#include "gfx/presentation_types.h"
+#include "gfx/dynamic_resolution.h"
+#include "gfx/render_commands.h"
+#include "gfx/render_scale.h"
+#include "gfx/simd_kernels.h"
+#include "gfx/sprite_batch.h"
+
+//// lua subsystem
+#include "luax/lua_runtime.h"
+
+// from platform/linux/paths_linux.cpp
+namespace app::paths { void init_from_host(const char* data_dir, const char* home_dir); }
+
+#ifndef RCE_HOST_DEFAULT_DATA
+#define RCE_HOST_DEFAULT_DATA "."
+#endif
+
+// Stand-in for EglRenderer: same rect-facing surface and present pass, no GPU.
+// Replays the command buffer like a real backend, through a GlStateCache
+// over no-op GL functions, batches sprites into a plain vertex array the way
+// GlSpriteRenderer does into its mapped ring, and counts what it saw.
+class NullRenderer : public RenderBackend {
+public:
+    void init(int w, int h) {
+        width_ = w;
+        height_ = h;
+
+        GlFunctions f;
+        f.Enable = f.Disable = [](unsigned int) {};
+        f.Viewport = f.Scissor = [](int, int, int, int) {};
+        f.ClearColor = [](float, float, float, float) {};
+        f.Clear = [](unsigned int) {};
+        gl_.set_functions(f);
+
+        sprite_verts_.resize((size_t)kSpriteQuadsPerFrame * SPRITE_VERTICES_PER_QUAD);
+    }
+    void set_output_rect(const RectI& r) { output_rect_ = r; }
+    void set_render_target(int w, int h, const RectI& present_rect, bool linear) {
+        rt_w_ = w > 0 && h > 0 ? w : 0;
+        rt_h_ = w > 0 && h > 0 ? h : 0;
+        present_rect_ = present_rect;
+        present_linear_ = linear;
+    }
+    bool apply_presentation(const PresentationResult& pr, uint32_t generation) {
+        if (generation != 0 && generation == applied_generation_) return false;
+        applied_generation_ = generation;
+        presentation_applies_++;
+        set_output_rect(pr.output_rect);
+        set_render_target(pr.render_w, pr.render_h, pr.present_rect, pr.present_linear);
+        return true;
+    }
+
+    void record_frame(RenderCommandBuffer& cmds, float r, float g, float b, float a = 1.0f) const {
+        if (rt_w_ > 0) {
+            const uint64_t content = render_key::state(render_key::LAYER_PRESENT, 1);
+            cmds.scissor_off(content);
+            cmds.viewport(content, RectI{0, 0, rt_w_, rt_h_});
+            cmds.clear(content, r, g, b, a);
+            return;
+        }
+        const uint64_t border = render_key::state(render_key::LAYER_PRESENT, 0);
+        cmds.scissor_off(border);
+        cmds.viewport(border, RectI{0, 0, width_, height_});
+        cmds.clear(border, 0.f, 0.f, 0.f, 1.f);
+
+        const uint64_t content = render_key::state(render_key::LAYER_PRESENT, 1);
+        cmds.viewport(content, output_rect_);
+        cmds.clear(content, r, g, b, a);
+    }
+    void submit(RenderCommandBuffer& cmds) { cmds.submit(*this); }
+
+    // RenderBackend (same GL call pattern as EglRenderer)
+    void begin_frame() override {
+        gl_.begin_frame();
+        batcher_.begin_frame();
+        sprite_quads_used_ = 0;
+    }
+    void clear(const CmdClear& c) override {
+        flush_sprites();
+        commands_++;
+        gl_.clear_color(c.r, c.g, c.b, c.a);
+        gl_.clear(0x4000); // GL_COLOR_BUFFER_BIT
+    }
+    void viewport(const RectI& r) override { flush_sprites(); commands_++; gl_.viewport(r.x, r.y, r.w, r.h); }
+    void scissor(const CmdScissor& s) override {
+        flush_sprites();
+        commands_++;
+        if (s.enabled) {
+            gl_.enable(GlStateCache::SCISSOR_TEST);
+            gl_.scissor(s.rect.x, s.rect.y, s.rect.w, s.rect.h);
+        } else {
+            gl_.disable(GlStateCache::SCISSOR_TEST);
+        }
+    }
+    void draw(const CmdDraw&) override { flush_sprites(); commands_++; draws_++; }
+    void sprites(const CmdSprites& s) override {
+        commands_++;
+        const Sprite* p = s.sprites;
+        uint32_t n = s.count;
+        while (n > 0) {
+            if (!sprites_open_) {
+                const uint32_t left = kSpriteQuadsPerFrame - sprite_quads_used_;
+                if (left == 0) { batcher_.stats().dropped += n; return; }
+                const uint32_t block = left < SPRITE_MAX_QUADS_PER_DRAW ? left : SPRITE_MAX_QUADS_PER_DRAW;
+                batcher_.begin(sprite_verts_.data() + (size_t)sprite_quads_used_ * SPRITE_VERTICES_PER_QUAD, block);
+                sprites_open_ = true;
+            }
+            const uint32_t k = batcher_.add(p, n);
+            p += k;
+            n -= k;
+            if (n > 0) flush_sprites();
+        }
+    }
+    void end_frame() override {
+        flush_sprites();
+        if (rt_w_ > 0) {
+            // Border clear + blit into present_rect, as EglRenderer does.
+            gl_.disable(GlStateCache::SCISSOR_TEST);
+            gl_.viewport(0, 0, width_, height_);
+            gl_.clear_color(0.f, 0.f, 0.f, 1.f);
+            gl_.clear(0x4000);
+            blits_++;
+        }
+        const SpriteStats& ss = batcher_.stats();
+        sprites_ += ss.sprites;
+        sprite_batches_ += ss.batches;
+        sprite_draws_ += ss.draw_calls;
+        sprites_dropped_ += ss.dropped;
+        frames_++;
+        gl_issued_ += gl_.frame_stats().issued;
+        gl_skipped_ += gl_.frame_stats().skipped;
+    }
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+    uint64_t frames() const { return frames_; }
+    uint64_t commands() const { return commands_; }
+    uint64_t draws() const { return draws_; }
+    uint64_t gl_issued() const { return gl_issued_; }
+    uint64_t gl_skipped() const { return gl_skipped_; }
+    uint64_t sprites() const { return sprites_; }
+    uint64_t sprite_batches() const { return sprite_batches_; }
+    uint64_t sprite_draws() const { return sprite_draws_; }
+    uint64_t sprites_dropped() const { return sprites_dropped_; }
+    uint64_t blits() const { return blits_; }
+    uint64_t presentation_applies() const { return presentation_applies_; }
+
+private:
+    static constexpr uint32_t kSpriteQuadsPerFrame = 131072;
+
+    void flush_sprites() {
+        if (!sprites_open_) return;
+        sprites_open_ = false;
+        sprite_quads_used_ += batcher_.quad_count();
+        batcher_.stats().draw_calls += batcher_.batch_count();
+    }
+
+    GlStateCache gl_;
+    SpriteBatcher batcher_;
+    std::vector<SpriteVertex> sprite_verts_;
+    uint32_t sprite_quads_used_ = 0;
+    bool sprites_open_ = false;
+    int width_ = 0;
+    int height_ = 0;
+    RectI output_rect_;
+    int rt_w_ = 0;
+    int rt_h_ = 0;
+    RectI present_rect_;
+    bool present_linear_ = false;
+    uint64_t blits_ = 0;
+    uint32_t applied_generation_ = 0;
+    uint64_t presentation_applies_ = 0;
+    uint64_t frames_ = 0;
+    uint64_t commands_ = 0;
+    uint64_t draws_ = 0;
+    uint64_t gl_issued_ = 0;
+    uint64_t gl_skipped_ = 0;
+    uint64_t sprites_ = 0;
+    uint64_t sprite_batches_ = 0;
+    uint64_t sprite_draws_ = 0;
+    uint64_t sprites_dropped_ = 0;
+};
+
+struct HostOptions {
+    std::string data = RCE_HOST_DEFAULT_DATA;
+    std::string home = "rce_host";
+    std::string script = "scripts/main.lua";
+    uint64_t frames = 600;
+    uint32_t sprites = 0;  // synthetic sprite load per frame
+    uint32_t fps = 60;
+    int width = 1080;
+    int height = 2400;
+    RenderTargetConfig target;  // --target WxH, --scale integer|fractional
+    float dynres_ms = 0.0f;     // --dynres: synthetic GPU cost at full scale (0 = off)
+};
+
+static void print_usage() {
+    LOGI("usage: mylua_host [--data DIR] [--home DIR] [--script REL] [--frames N] [--fps N] [--size WxH] [--sprites N]");
+    LOGI("                  [--target WxH] [--scale integer|fractional] [--dynres MS]");
+    LOGI("  --frames 0 runs until killed (soak)");
+}
+
+static bool parse_args(int argc, char** argv, HostOptions& o) {
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        const char* v = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+        if (!std::strcmp(a, "--help") || !std::strcmp(a, "-h")) { print_usage(); return false; }
+        if (!v) { LOGE("missing value for %s", a); return false; }
+
+        if      (!std::strcmp(a, "--data"))   o.data = v;
+        else if (!std::strcmp(a, "--home"))   o.home = v;
+        else if (!std::strcmp(a, "--script")) o.script = v;
+        else if (!std::strcmp(a, "--frames")) o.frames = std::strtoull(v, nullptr, 10);
+        else if (!std::strcmp(a, "--fps"))    o.fps = (uint32_t)std::strtoul(v, nullptr, 10);
+        else if (!std::strcmp(a, "--sprites")) o.sprites = (uint32_t)std::strtoul(v, nullptr, 10);
+        else if (!std::strcmp(a, "--dynres")) o.dynres_ms = std::strtof(v, nullptr);
+        else if (!std::strcmp(a, "--size")) {
+            if (std::sscanf(v, "%dx%d", &o.width, &o.height) != 2) { LOGE("bad --size: %s", v); return false; }
+        } else if (!std::strcmp(a, "--target")) {
+            if (std::sscanf(v, "%dx%d", &o.target.width, &o.target.height) != 2) { LOGE("bad --target: %s", v); return false; }
+        } else if (!std::strcmp(a, "--scale")) {
+            if      (!std::strcmp(v, "integer"))    o.target.policy = ScalePolicy::Integer;
+            else if (!std::strcmp(v, "fractional")) o.target.policy = ScalePolicy::Fractional;
+            else { LOGE("bad --scale: %s", v); return false; }
+        } else {
+            LOGE("unknown option: %s", a);
+            print_usage();
+            return false;
+        }
+        i++;
+    }
+    if (o.fps == 0) o.fps = 60;
+    if (o.width < 1) o.width = 1;
+    if (o.height < 1) o.height = 1;
+    return true;
+}
+
+// Synthetic sprite load: n spinning quads on 4 textures, recorded in 16
+// interleaved chunks so the key sort has to regroup them into 4 batches.
+// Colors cycle through the hue wheel, SoA through the SIMD color kernels.
+static void scripted_sprites(RenderCommandBuffer& cmds, uint64_t frame, uint32_t n, int w, int h) {
+    static std::vector<Sprite> sprites;
+    static std::vector<float> hsv, rgba;
+    static std::vector<uint32_t> colors;
+    if (n == 0) return;
+    sprites.resize(n);
+    hsv.resize((size_t)n * 3);
+    rgba.resize((size_t)n * 4);
+    colors.resize(n);
+
+    const float t = (float)frame * (1.0f / 60.0f);
+    float* hue = hsv.data();
+    float* sat = hue + n;
+    float* val = sat + n;
+    float* r = rgba.data();
+    float* g = r + n;
+    float* b = g + n;
+    float* a = b + n;
+    for (uint32_t i = 0; i < n; i++) {
+        const float k = (float)i * 0.618034f;
+        hue[i] = k + t * 0.1f; // wraps in the kernel
+        sat[i] = 0.8f;
+        val[i] = 1.0f;
+        a[i] = 1.0f;
+    }
+    simd_hsv_to_rgb(hue, sat, val, n, r, g, b);
+    simd_pack_rgba8(r, g, b, a, n, colors.data());
+
+    for (uint32_t i = 0; i < n; i++) {
+        Sprite& s = sprites[i];
+        const float k = (float)i * 0.618034f;
+        s.x = (0.5f + 0.45f * std::sin(k * 1.3f + t)) * (float)w;
+        s.y = (0.5f + 0.45f * std::cos(k * 0.7f + t * 0.5f)) * (float)h;
+        s.w = s.h = 16.0f;
+        s.ox = s.oy = 0.5f;
+        s.rotation = k + t;
+        s.u0 = s.v0 = 0.0f;
+        s.u1 = s.v1 = 1.0f;
+        s.color = colors[i];
+        s.shader = 0;
+    }
+
+    const uint32_t chunks = 16;
+    const uint32_t per = (n + chunks - 1) / chunks;
+    for (uint32_t c = 0; c < chunks; c++) {
+        const uint32_t first = c * per;
+        if (first >= n) break;
+        const uint32_t count = std::min(per, n - first);
+        const uint32_t tex = 1 + c % 4;
+        for (uint32_t i = first; i < first + count; i++) sprites[i].texture = tex;
+        cmds.sprites(render_key::draw(render_key::LAYER_WORLD, 0, tex, 0), &sprites[first], count);
+    }
+}
+
+// Synthetic GPU frame time for the dynamic resolution controller: cost goes
+// with the pixel count (scale^2), and a thermal throttle ramps it to 2.5x
+// over 20%..35% of the run, then cools back down over 65%..80%. Small
+// deterministic jitter on top.
+static uint64_t scripted_gpu_ns(uint64_t frame, uint64_t frames, float full_ms, float scale) {
+    const float t = frames ? (float)frame / (float)frames : 0.0f;
+    float heat = 0.0f;
+    if (t >= 0.20f && t < 0.35f) heat = (t - 0.20f) / 0.15f;
+    else if (t >= 0.35f && t < 0.65f) heat = 1.0f;
+    else if (t >= 0.65f && t < 0.80f) heat = 1.0f - (t - 0.65f) / 0.15f;
+    const float throttle = 1.0f + 1.5f * heat;
+
+    const uint32_t h = (uint32_t)frame * 2654435761u;
+    const float jitter = 1.0f + ((float)(h >> 24) / 255.0f - 0.5f) * 0.1f;
+    return (uint64_t)((double)(full_ms * scale * scale * throttle * jitter) * 1e6);
+}
+
+// Deterministic touch script, sampled like a 240 Hz panel (several samples
+// per frame, each with its own timestamp). Every 2 seconds: a 0.5s diagonal
+// one-finger drag, then a second later a 0.5s two-finger pinch.
+static constexpr uint32_t kTouchSamplesPerFrame = 4;
+
+static bool script_pointer_down(const input::InputState& in, int32_t id) {
+    const int i = in.pointers().find(id);
+    return i >= 0 && (in.pointers().state[i] & input::POINTER_DOWN);
+}
+
+// Drives one scripted finger: down on the first sample inside [t0, t1], moves, up after.
+static void script_finger(input::InputState& in, int32_t id, double tp, double t0, double t1,
+                          float x, float y, uint64_t t_ns) {
+    const bool down = script_pointer_down(in, id);
+    if (tp >= t0 && tp <= t1) {
+        if (!down) in.push_pointer_down(id, x, y, t_ns);
+        else       in.push_pointer_move(id, x, y, t_ns);
+    } else if (down) {
+        in.push_pointer_up(id, x, y, t_ns);
+    }
+}
+
+static void scripted_input(input::InputState& in, uint64_t frame_start_ns, uint64_t frame_ns, int w, int h) {
+    for (uint32_t k = 1; k <= kTouchSamplesPerFrame; k++) {
+        const uint64_t t_ns = frame_start_ns + frame_ns * k / kTouchSamplesPerFrame;
+        const double tp = std::fmod((double)t_ns * 1e-9, 2.0);
+
+        // drag: corner to corner
+        const float kd = (float)std::min(tp / 0.5, 1.0);
+        script_finger(in, 0, tp, 0.0, 0.5, kd * (float)w, kd * (float)h, t_ns);
+
+        // pinch: two fingers spreading out from the center
+        const float kp = (float)std::min(std::max((tp - 1.0) / 0.5, 0.0), 1.0);
+        const float r = (50.0f + kp * 0.3f * (float)w);
+        const float cx = 0.5f * (float)w, cy = 0.5f * (float)h;
+        script_finger(in, 1, tp, 1.0, 1.5, cx - r, cy, t_ns);
+        script_finger(in, 2, tp, 1.0, 1.5, cx + r, cy, t_ns);
+    }
+}
+
+// Deterministic platform traffic: a rotation-like storm once every 10 seconds.
+static void scripted_platform_events(uint64_t frame, uint32_t fps, NullRenderer& r) {
+    if (frame % (10ull * fps) != 0) return;
+
+    for (int i = 0; i < 40; i++) {
+        rce::EPMsg m{};
+        m.type = rce::EPType::InsetsChanged;
+        m.a = 0; m.b = (uint32_t)(i % 2 ? 96 : 0); m.c = 0; m.d = 48;
+        rce::ep_post_p2e(m);
+    }
+
+    rce::EPMsg s{};
+    s.type = rce::EPType::SurfaceResized;
+    s.a = (uint32_t)r.width();
+    s.b = (uint32_t)r.height();
+    rce::ep_post_p2e(s);
+}
+
+// Host has no OS UI to drive; drain e2p so the ring never fills.
+static void pump_engine_commands() {
+    rce::EPMsg batch[32];
+    while (rce::ep_drain_e2p(batch, 32) > 0) {}
+}
+
+int main(int argc, char** argv) {
+    HostOptions opt;
+    if (!parse_args(argc, argv, opt)) {
+        rce::log_shutdown(); // flush the usage / error text
+        return 2;
+    }
+
+    LOGI("mylua_host start: frames=%llu fps=%u size=%dx%d",
+         (unsigned long long)opt.frames, opt.fps, opt.width, opt.height);
+
+    NullRenderer renderer;
+    renderer.init(opt.width, opt.height);
+    input::InputState input;
+    input::InputResampler resampler;
+    input::GestureRecognizer gestures;
+
+    app::paths::init_from_host(opt.data.c_str(), opt.home.c_str());
+    rce::log_open_file(app::paths::get().logs.c_str());
+
+    rce::engine_init();
+
+    // Deterministic clock: every frame is 1/fps rounded to the nearest ns, the
+    // same rounding as FixedStepConfig::step_ns. Truncating would leave each
+    // 60 fps frame 1 ns short of a step, so the sim would run a step behind.
+    const uint64_t frame_ns = (1000000000ull + opt.fps / 2) / opt.fps;
+    uint64_t clock_ns = 0;
+    rce::time_init(clock_ns);
+
+    bool lua_ok = true;
+    {
+        std::string script = app::paths::join(app::paths::get().data, opt.script);
+        LOGI("Trying Lua script: %s", script.c_str());
+        lua_ok = rce::engine_load_script(script.c_str());
+    }
+
+    // Presentation is recomputed only when the platform events (or the
+    // render scale) say it may have changed, like app_init does.
+    PresentationState presentation;
+    uint64_t presentation_recomputes = 0;
+    rce::ep_subscribe(rce::EPType::InsetsChanged, [&presentation](const rce::EPMsg&) { presentation.invalidate(); });
+    rce::ep_subscribe(rce::EPType::SurfaceResized, [&presentation](const rce::EPMsg&) { presentation.invalidate(); });
+
+    DynamicResolution dynres;
+    uint64_t dynres_over = 0;  // frames over budget
+    const uint64_t wall_start = rce::time_now_ns();
+    uint64_t frame = 0;
+
+    for (; opt.frames == 0 || frame < opt.frames; frame++) {
+        input.begin_frame();
+        scripted_input(input, clock_ns, frame_ns, renderer.width(), renderer.height());
+        resampler.update(input, clock_ns + frame_ns);
+        input::dispatch_pointers(resampler);
+        gestures.update(input.events(), clock_ns + frame_ns);
+        input::dispatch_gestures(gestures);
+        scripted_platform_events(frame, opt.fps, renderer);
+
+        pump_engine_commands();
+
+        clock_ns += frame_ns;
+        uint64_t dt_ns = rce::time_update(clock_ns);
+        rce::engine_tick(dt_ns);
+
+        if (presentation.dirty()) {
+            PresentationResult fresh;
+            fresh.output_rect = fresh.safe_rect = RectI{0, 0, renderer.width(), renderer.height()};
+            apply_render_target(fresh, opt.target, dynres.scale());
+            presentation.update(fresh);
+            presentation_recomputes++;
+        }
+        const PresentationResult& pr = presentation.result();
+        renderer.apply_presentation(pr, presentation.generation());
+        const float w = (float)renderer.width();
+        const float h = (float)renderer.height();
+        float px = input.pointer_x();
+        float py = input.pointer_y();
+        resampler.primary(&px, &py);
+        RenderCommandBuffer& cmds = rce::engine_render_commands();
+        scripted_sprites(cmds, frame, opt.sprites,
+                         pr.render_w ? pr.render_w : renderer.width(),
+                         pr.render_h ? pr.render_h : renderer.height());
+        renderer.record_frame(cmds, px / w, 1.0f, py / h);
+        renderer.submit(cmds);
+
+        if (opt.dynres_ms > 0.0f) {
+            const uint64_t gpu_ns = scripted_gpu_ns(frame, opt.frames, opt.dynres_ms, dynres.scale());
+            if (gpu_ns > dynres.config().budget_ns) dynres_over++;
+            if (dynres.update(2000000, gpu_ns)) {
+                presentation.invalidate();
+                LOGI("dynres: frame %llu scale %.2f (filtered %.2fms)",
+                     (unsigned long long)frame, (double)dynres.scale(), (double)dynres.filtered_ms());
+            }
+        }
+    }
+
+    const uint64_t wall_ns = rce::time_now_ns() - wall_start;
+    const rce::EPCounters c = rce::ep_get_counters();
+
+    LOGI("mylua_host done: frames=%llu sim=%.3fs wall=%.3fms (%.3f us/frame)",
+         (unsigned long long)renderer.frames(),
+         (double)rce::engine_sim_time_ns() * 1e-9,
+         (double)wall_ns * 1e-6,
+         frame ? (double)wall_ns * 1e-3 / (double)frame : 0.0);
+    LOGI("p2e: pushed=%llu popped=%llu dropped=%llu coalesced=%llu highwater=%llu",
+         (unsigned long long)c.p2e_pushed, (unsigned long long)c.p2e_popped,
+         (unsigned long long)c.p2e_dropped, (unsigned long long)c.p2e_coalesced,
+         (unsigned long long)c.p2e_highwater);
+    LOGI("render: commands=%llu draws=%llu gl issued=%llu skipped=%llu",
+         (unsigned long long)renderer.commands(), (unsigned long long)renderer.draws(),
+         (unsigned long long)renderer.gl_issued(), (unsigned long long)renderer.gl_skipped());
+    LOGI("sprites: %llu (dropped %llu) batches=%llu draw_calls=%llu simd=%s",
+         (unsigned long long)renderer.sprites(), (unsigned long long)renderer.sprites_dropped(),
+         (unsigned long long)renderer.sprite_batches(), (unsigned long long)renderer.sprite_draws(),
+         simd_backend_name());
+    if (opt.dynres_ms > 0.0f) {
+        LOGI("dynres: downs=%u ups=%u final scale %.2f, frames over budget %llu/%llu",
+             dynres.stats().downs, dynres.stats().ups, (double)dynres.scale(),
+             (unsigned long long)dynres_over, (unsigned long long)dynres.stats().frames);
+    }
+    LOGI("presentation: recomputed %llu, generation %u, applied %llu",
+         (unsigned long long)presentation_recomputes, presentation.generation(),
+         (unsigned long long)renderer.presentation_applies());
+    const PresentationResult& pr = presentation.result();
+    if (pr.render_w > 0) {
+        LOGI("present: target %dx%d -> %d,%d %dx%d scale=%.3f %s blits=%llu",
+             pr.render_w, pr.render_h,
+             pr.present_rect.x, pr.present_rect.y, pr.present_rect.w, pr.present_rect.h,
+             (double)pr.present_scale, pr.present_linear ? "linear" : "nearest",
+             (unsigned long long)renderer.blits());
+    }
+
+    rce::engine_shutdown();
+
+    const rce::LogStats ls = rce::log_stats();
+    LOGI("log: written=%llu dropped=%llu rate_limited=%llu",
+         (unsigned long long)ls.written, (unsigned long long)ls.dropped,
+         (unsigned long long)ls.rate_limited);
+    rce::log_shutdown();
+    return lua_ok ? 0 : 1;
+}
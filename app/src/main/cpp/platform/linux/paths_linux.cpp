@@ -0,0 +1,28 @@
+#include <string>
+
+#include "app/paths.h"
+#include "app/log.h"
+
+namespace app::paths {
+
+// Detect + set platform paths for the headless host.
+// All stored paths are POSIX style, no trailing slash.
+void init_from_host(const char* data_dir, const char* home_dir) {
+    AppPaths p;
+
+    p.data = (data_dir && *data_dir) ? data_dir : ".";
+
+    // Keep writable dirs out of the data dir (it's usually the source assets folder).
+    std::string home = (home_dir && *home_dir) ? home_dir : "rce_host";
+    p.cache = join(home, "cache");
+    p.logs  = join(home, "logs");
+
+    set(std::move(p));
+
+    const auto& gp = get();
+    LOGI("Paths: data=%s",  gp.data.c_str());
+    LOGI("Paths: cache=%s", gp.cache.c_str());
+    LOGI("Paths: logs=%s",  gp.logs.c_str());
+}
+
+} // namespace app::paths
@@ -0,0 +1,246 @@
+#include "gfx/dynamic_resolution.h"
+#include "test_util.h"
+
+#include <math.h>
+#include <vector>
+
+// DynamicResolution driven by synthetic frame-time traces. The workload model
+// is a GPU-bound frame: a fixed CPU part plus GPU time proportional to the
+// pixel count, gpu = cost * scale^2, where cost is the full-resolution GPU
+// time of the current trace segment.
+
+namespace {
+
+struct Change {
+    int frame;
+    float from, to;
+};
+
+struct Sim {
+    DynamicResolution dr;
+    int frame = 0;
+    std::vector<Change> changes;
+    bool invariants_ok = true;
+
+    explicit Sim(const DynamicResolutionConfig& cfg = DynamicResolutionConfig{}) { dr.configure(cfg); }
+
+    float frame_ms(float cost_ms) const { return cost_ms * dr.scale() * dr.scale(); }
+
+    // One frame at the given full-resolution GPU cost (4 ms of CPU).
+    void step(float cost_ms) {
+        const float before = dr.scale();
+        const bool changed = dr.update(4000000, (uint64_t)(frame_ms(cost_ms) * 1e6f));
+        const float after = dr.scale();
+        if (changed) changes.push_back(Change{frame, before, after});
+        check_invariants(changed, before, after);
+        frame++;
+    }
+
+    void run(float cost_ms, int frames) {
+        for (int i = 0; i < frames; i++) step(cost_ms);
+    }
+
+    // Number of changes at or after the given frame.
+    int changes_since(int since) const {
+        int n = 0;
+        for (const Change& c : changes) n += c.frame >= since;
+        return n;
+    }
+
+    void check_invariants(bool changed, float before, float after) {
+        const DynamicResolutionConfig& cfg = dr.config();
+        const float steps = after / cfg.step;
+        bool ok = changed == (after != before);
+        ok = ok && after >= cfg.min_scale && after <= cfg.max_scale;
+        // Always a whole number of steps, unless clamped to a bound that isn't one.
+        ok = ok && (fabsf(steps - roundf(steps)) < 1e-3f || after == cfg.min_scale || after == cfg.max_scale);
+        if (!ok && invariants_ok) {
+            fprintf(stderr, "  frame %d: scale %g -> %g (changed=%d)\n", frame, before, after, (int)changed);
+        }
+        invariants_ok = invariants_ok && ok;
+    }
+};
+
+const float kBudgetMs = 16.666667f;
+
+} // namespace
+
+// Light load at full resolution: nothing to do, ever.
+static void test_steady_under_budget() {
+    Sim sim;
+    sim.run(8.0f, 2000);   // far under
+    sim.run(14.0f, 2000);  // inside the band
+    CHECK(sim.invariants_ok);
+    CHECK(sim.changes.empty());
+    CHECK_NEAR(sim.dr.scale(), 1.0, 0.0);
+    CHECK_EQ(sim.dr.stats().frames, 4000);
+    CHECK_NEAR(sim.dr.filtered_ms(), 14.0, 1e-3);
+}
+
+// Thermal throttling: the GPU cost jumps from 12 ms to 30 ms. The controller
+// drops within a few frames, aimed straight at the band rather than stepping
+// down through it, then holds there; when the cost comes back it climbs one
+// step at a time to full resolution.
+static void test_throttle_and_recovery() {
+    Sim sim;
+    sim.run(12.0f, 300);
+    CHECK(sim.changes.empty());
+
+    const int throttle = sim.frame;
+    sim.run(30.0f, 1500);
+    CHECK(sim.invariants_ok);
+    CHECK(!sim.changes.empty());
+    if (sim.changes.empty()) return;
+    // down_frames over budget after the EMA crosses it.
+    CHECK(sim.changes[0].frame - throttle <= (int)sim.dr.config().down_frames + 3);
+    CHECK(sim.changes[0].to <= 0.75f);  // one drop, not 0.95, 0.9, ...
+    CHECK_EQ(sim.dr.stats().downs, 1);
+    // 30 * 0.7^2 = 14.7 ms: inside the band, and stable there.
+    CHECK_NEAR(sim.dr.scale(), 0.7, 1e-6);
+    CHECK_EQ(sim.changes_since(throttle + 300), 0);
+    CHECK(sim.frame_ms(30.0f) <= kBudgetMs);
+
+    const int recover = sim.frame;
+    const size_t before = sim.changes.size();
+    sim.run(12.0f, 1500);
+    CHECK(sim.invariants_ok);
+    CHECK_NEAR(sim.dr.scale(), 1.0, 0.0);
+    CHECK_EQ(sim.dr.stats().ups, 6);  // 0.7 -> 1.0 in 0.05 steps
+    for (size_t i = before; i < sim.changes.size(); i++) {
+        CHECK_NEAR(sim.changes[i].to - sim.changes[i].from, 0.05, 1e-5);
+    }
+    // Recovery is deliberately slow: up_frames per step, plus the hold.
+    const DynamicResolutionConfig& cfg = sim.dr.config();
+    const Change& last = sim.changes.back();
+    CHECK(last.frame - recover >= 6 * (int)cfg.up_frames);
+    CHECK(last.frame - recover <= 6 * (int)(cfg.up_frames + cfg.hold_frames) + 10);
+}
+
+// Load right at the edge of the band must not ping-pong between two sizes.
+static void test_hysteresis() {
+    // Alternating 12 / 20 ms frames average 16 ms: the EMA stays in the band.
+    {
+        Sim sim;
+        for (int i = 0; i < 3000; i++) sim.step(i & 1 ? 20.0f : 12.0f);
+        CHECK(sim.invariants_ok);
+        CHECK(sim.changes.empty());
+    }
+    // Isolated spikes (a GC pause, a shader compile) are filtered out.
+    {
+        Sim sim;
+        for (int i = 0; i < 3000; i++) sim.step(i % 30 == 29 ? 40.0f : 12.0f);
+        CHECK(sim.changes.empty());
+    }
+    // A cost where one step up is just over budget and one step down is just
+    // under the band: 18 * 0.95^2 = 16.2, 18 * 0.9^2 = 14.6, 18 * 0.85^2 = 13.0.
+    // Settles once and stays put.
+    {
+        Sim sim;
+        sim.run(18.0f, 6000);
+        CHECK(sim.invariants_ok);
+        CHECK(sim.changes.size() <= 2);
+        CHECK_EQ(sim.changes_since(1000), 0);
+        const float ms = sim.frame_ms(18.0f);
+        CHECK(ms <= kBudgetMs);
+        CHECK(ms >= kBudgetMs * 0.8f || sim.dr.scale() == 1.0f);
+    }
+    // Slow noisy drift across the upper threshold and back.
+    {
+        Sim sim;
+        uint32_t rng = 11;
+        for (int i = 0; i < 6000; i++) {
+            rng = rng * 1664525u + 1013904223u;
+            const float noise = ((float)(rng >> 8) / 16777216.0f - 0.5f) * 3.0f;  // +-1.5 ms
+            const float base = 15.5f + 2.0f * sinf((float)i * 0.002f);
+            sim.step(base + noise);
+        }
+        CHECK(sim.invariants_ok);
+        CHECK(sim.changes.size() <= 8);
+    }
+}
+
+// Whatever the load, the scale stays inside [min_scale, max_scale].
+static void test_clamping() {
+    Sim sim;
+    sim.run(200.0f, 2000);  // hopeless: even min_scale is over budget
+    CHECK(sim.invariants_ok);
+    CHECK_NEAR(sim.dr.scale(), 0.5, 0.0);
+    const uint32_t downs = sim.dr.stats().downs;
+    CHECK(downs >= 1 && downs <= 3);
+    sim.run(200.0f, 2000);
+    CHECK_EQ(sim.dr.stats().downs, downs);  // no further drops at the floor
+
+    sim.run(1.0f, 5000);
+    CHECK_NEAR(sim.dr.scale(), 1.0, 0.0);
+    const uint32_t ups = sim.dr.stats().ups;
+    sim.run(1.0f, 2000);
+    CHECK_EQ(sim.dr.stats().ups, ups);  // no further raises at the ceiling
+
+    // Bounds that aren't step multiples.
+    DynamicResolutionConfig cfg;
+    cfg.min_scale = 0.33f;
+    cfg.max_scale = 0.87f;
+    cfg.step = 0.1f;
+    Sim odd(cfg);
+    CHECK_NEAR(odd.dr.scale(), 0.8, 1e-6);  // max rounded down to a step
+    odd.run(500.0f, 2000);
+    CHECK(odd.invariants_ok);
+    CHECK_NEAR(odd.dr.scale(), 0.33, 1e-6);
+    odd.run(1.0f, 3000);
+    CHECK(odd.invariants_ok);
+    CHECK_NEAR(odd.dr.scale(), 0.87, 1e-6);  // the last step up clamps to the bound
+}
+
+static void test_frame_time_inputs() {
+    // The frame counts as the slower of CPU and GPU.
+    DynamicResolution dr;
+    dr.configure(DynamicResolutionConfig{});
+    dr.update(30000000, 5000000);
+    CHECK_NEAR(dr.filtered_ms(), 30.0, 1e-3);
+    dr.reset();
+    dr.update(5000000, 30000000);
+    CHECK_NEAR(dr.filtered_ms(), 30.0, 1e-3);
+    dr.reset();
+    dr.update(20000000);  // no GPU timing
+    CHECK_NEAR(dr.filtered_ms(), 20.0, 1e-3);
+    // Exponential smoothing with the configured weight.
+    dr.update(10000000);
+    CHECK_NEAR(dr.filtered_ms(), 18.0, 1e-3);
+
+    // reset() goes back to max_scale and forgets the filter.
+    Sim sim;
+    sim.run(40.0f, 100);
+    CHECK(sim.dr.scale() < 1.0f);
+    sim.dr.reset();
+    CHECK_NEAR(sim.dr.scale(), 1.0, 0.0);
+    sim.step(10.0f);
+    CHECK_NEAR(sim.dr.filtered_ms(), 10.0, 1e-3);
+}
+
+static void test_configure_sanitizes() {
+    DynamicResolutionConfig cfg;
+    cfg.step = 0.0f;
+    cfg.min_scale = 2.0f;  // above max: pinned to max
+    cfg.smoothing = 5.0f;  // out of range: no smoothing
+    cfg.down_frames = 0;
+    cfg.up_frames = 0;
+    Sim sim(cfg);
+    CHECK_NEAR(sim.dr.config().step, 0.05, 1e-6);
+    CHECK_NEAR(sim.dr.config().min_scale, 1.0, 0.0);
+    CHECK_NEAR(sim.dr.config().smoothing, 1.0, 0.0);
+    CHECK_EQ(sim.dr.config().down_frames, 1);
+    CHECK_EQ(sim.dr.config().up_frames, 1);
+    sim.run(100.0f, 500);
+    CHECK(sim.changes.empty());  // nowhere to go
+    CHECK_NEAR(sim.dr.filtered_ms(), 100.0, 1e-3);
+}
+
+int main() {
+    test_steady_under_budget();
+    test_throttle_and_recovery();
+    test_hysteresis();
+    test_clamping();
+    test_frame_time_inputs();
+    test_configure_sanitizes();
+    return rce_test::finish("dynamic_resolution_test");
+}
@@ -0,0 +1,52 @@
+#include "app/engine.h"
+#include "app/event_dispatcher.h"
+#include "app/log.h"
+#include "luax/lua_runtime.h"
+#include "test_util.h"
+
+extern "C" {
+#include "lua.h"
+#include "lauxlib.h"
+}
+
+using namespace rce;
+
+static lua_Number lua_global_number(const char* name) {
+    lua_State* L = engine_lua().state();
+    lua_getglobal(L, name);
+    const lua_Number v = lua_tonumber(L, -1);
+    lua_pop(L, 1);
+    return v;
+}
+
+// engine_init / engine_shutdown cycles must not stack the platform -> Lua
+// forwarders: on_event runs exactly once per message on every cycle.
+static void test_reinit_forwards_once() {
+    for (int cycle = 0; cycle < 3; cycle++) {
+        engine_init();
+        lua_State* L = engine_lua().state();
+        CHECK(L != nullptr);
+        if (!L) return;
+        CHECK(luaL_dostring(L, "n = 0; rce.on_event(function() n = n + 1 end)") == 0);
+
+        EPMsg msg{};
+        msg.type = EPType::InsetsChanged;
+        ep_dispatch(msg);
+        msg.type = EPType::SurfaceResized;
+        ep_dispatch(msg);
+        CHECK_EQ(lua_global_number("n"), 2);
+
+        engine_shutdown();
+    }
+
+    // Nothing is left subscribed once the engine is down.
+    EPMsg msg{};
+    msg.type = EPType::InsetsChanged;
+    ep_dispatch(msg);
+}
+
+int main() {
+    test_reinit_forwards_once();
+    log_shutdown();
+    return rce_test::finish("engine_test");
+}
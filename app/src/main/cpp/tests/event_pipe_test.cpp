@@ -0,0 +1,157 @@
+#include "app/event_pipe.h"
+#include "test_util.h"
+
+#include <atomic>
+#include <thread>
+
+using namespace rce;
+
+// The rings are process globals, so every case leaves both directions drained.
+
+static EPMsg msg(EPType t, uint32_t a, uint32_t b = 0, uint32_t c = 0, uint32_t d = 0) {
+    EPMsg m{};
+    m.type = t;
+    m.a = a; m.b = b; m.c = c; m.d = d;
+    return m;
+}
+
+static void test_fifo_and_full() {
+    const EPCounters c0 = ep_get_counters();
+
+    uint32_t posted = 0;
+    while (ep_post_p2e(msg(EPType::SetUiMode, posted))) posted++;
+    CHECK(posted > 0);
+
+    EPMsg m;
+    uint32_t next = 0;
+    while (ep_poll_p2e(&m)) {
+        CHECK(m.type == EPType::SetUiMode);
+        CHECK_EQ(m.a, next);
+        next++;
+    }
+    CHECK_EQ(next, posted);
+
+    // Room again after the drain.
+    CHECK(ep_post_p2e(msg(EPType::SetUiMode, 7)));
+    CHECK(ep_poll_p2e(&m) && m.a == 7);
+
+    const EPCounters c1 = ep_get_counters();
+    CHECK_EQ(c1.p2e_pushed - c0.p2e_pushed, posted + 1);
+    CHECK_EQ(c1.p2e_popped - c0.p2e_popped, posted + 1);
+    CHECK_EQ(c1.p2e_dropped - c0.p2e_dropped, 1);
+    CHECK_EQ(c1.p2e_highwater, posted);
+}
+
+static void test_coalesce() {
+    CHECK(ep_get_coalesce(EPType::InsetsChanged));
+    CHECK(!ep_get_coalesce(EPType::SetUiMode));
+
+    const EPCounters c0 = ep_get_counters();
+    for (uint32_t i = 0; i < 10; i++) ep_post_p2e(msg(EPType::InsetsChanged, i, i, i, i));
+    ep_post_p2e(msg(EPType::SetUiMode, 42));
+
+    // Ring contents first, then the newest coalesced message.
+    EPMsg out[8];
+    const size_t n = ep_drain_p2e(out, 8);
+    CHECK_EQ(n, 2);
+    CHECK(out[0].type == EPType::SetUiMode && out[0].a == 42);
+    CHECK(out[1].type == EPType::InsetsChanged && out[1].a == 9 && out[1].d == 9);
+    CHECK_EQ(ep_drain_p2e(out, 8), 0);
+    CHECK_EQ(ep_get_counters().p2e_coalesced - c0.p2e_coalesced, 9);
+
+    // A post after delivery arrives once; nothing counts as replaced.
+    ep_post_p2e(msg(EPType::InsetsChanged, 10));
+    CHECK_EQ(ep_drain_p2e(out, 8), 1);
+    CHECK(out[0].a == 10);
+    CHECK_EQ(ep_drain_p2e(out, 8), 0);
+    CHECK_EQ(ep_get_counters().p2e_coalesced - c0.p2e_coalesced, 9);
+}
+
+// One producer and one consumer per direction, both directions at once.
+// Ring messages must arrive complete, in order, exactly once; coalesced
+// messages must never be torn, arrive at most once in increasing order, and the
+// last one must arrive.
+struct Stress {
+    bool p2e;
+    uint32_t count;
+    std::atomic<bool> producer_done{false};
+    uint32_t ring_received = 0;
+    uint32_t last_coalesced = 0;
+    bool saw_final_coalesced = false;
+    int errors = 0;
+
+    bool post(const EPMsg& m) { return p2e ? ep_post_p2e(m) : ep_post_e2p(m); }
+    size_t drain(EPMsg* out, size_t max) { return p2e ? ep_drain_p2e(out, max) : ep_drain_e2p(out, max); }
+
+    void produce() {
+        for (uint32_t i = 1; i <= count; i++) {
+            while (!post(msg(EPType::SetAllowedRotations, i, ~i, i * 3u, i ^ 0x5a5a5a5au))) {
+                std::this_thread::yield();
+            }
+            if ((i & 15u) == 0 || i == count) post(msg(EPType::SurfaceResized, i, i, i, i));
+        }
+        producer_done.store(true, std::memory_order_release);
+    }
+
+    void consume() {
+        EPMsg buf[64];
+        uint32_t next = 1;
+        for (;;) {
+            const bool done = producer_done.load(std::memory_order_acquire);
+            const size_t n = drain(buf, 64);
+            for (size_t k = 0; k < n; k++) {
+                const EPMsg& m = buf[k];
+                if (m.type == EPType::SetAllowedRotations) {
+                    if (m.a != next || m.b != ~next || m.c != next * 3u || m.d != (next ^ 0x5a5a5a5au)) errors++;
+                    next = m.a + 1;
+                    ring_received++;
+                } else if (m.type == EPType::SurfaceResized) {
+                    if (m.b != m.a || m.c != m.a || m.d != m.a || m.a <= last_coalesced) errors++;
+                    last_coalesced = m.a;
+                    if (m.a == count) saw_final_coalesced = true;
+                } else {
+                    errors++;
+                }
+            }
+            if (done && n == 0) break;
+            if (n == 0) std::this_thread::yield();
+        }
+    }
+};
+
+static void test_stress() {
+    const uint32_t N = 500000;
+    Stress up{true, N};
+    Stress down{false, N};
+
+    const EPCounters c0 = ep_get_counters();
+
+    std::thread pu([&] { up.produce(); });
+    std::thread cu([&] { up.consume(); });
+    std::thread pd([&] { down.produce(); });
+    std::thread cd([&] { down.consume(); });
+    pu.join(); cu.join(); pd.join(); cd.join();
+
+    CHECK_EQ(up.errors, 0);
+    CHECK_EQ(down.errors, 0);
+    CHECK_EQ(up.ring_received, N);
+    CHECK_EQ(down.ring_received, N);
+    CHECK(up.saw_final_coalesced);
+    CHECK(down.saw_final_coalesced);
+
+    // Everything pushed was either delivered or replaced by a newer coalesced
+    // message, never both.
+    const EPCounters c1 = ep_get_counters();
+    CHECK_EQ(c1.p2e_pushed - c0.p2e_pushed,
+             (c1.p2e_popped - c0.p2e_popped) + (c1.p2e_coalesced - c0.p2e_coalesced));
+    CHECK_EQ(c1.e2p_pushed - c0.e2p_pushed,
+             (c1.e2p_popped - c0.e2p_popped) + (c1.e2p_coalesced - c0.e2p_coalesced));
+}
+
+int main() {
+    ep_init();
+    test_fifo_and_full();
+    test_coalesce();
+    test_stress();
+    return rce_test::finish("event_pipe_test");
+}
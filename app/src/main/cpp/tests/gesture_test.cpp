@@ -0,0 +1,180 @@
+#include "input/gesture.h"
+#include "gesture_traces.h"
+#include "test_util.h"
+
+#include <string>
+#include <vector>
+
+using namespace input;
+
+static const char* kind_name(GestureKind k) {
+    switch (k) {
+        case GestureKind::Tap:       return "Tap";
+        case GestureKind::LongPress: return "LongPress";
+        case GestureKind::Drag:      return "Drag";
+        case GestureKind::Pinch:     return "Pinch";
+        case GestureKind::Fling:     return "Fling";
+    }
+    return "?";
+}
+
+static const char* phase_name(GesturePhase p) {
+    switch (p) {
+        case GesturePhase::Begin:  return "Begin";
+        case GesturePhase::Update: return "Update";
+        case GesturePhase::End:    return "End";
+        case GesturePhase::Cancel: return "Cancel";
+    }
+    return "?";
+}
+
+// Replays events frame by frame and returns every gesture.
+static std::vector<Gesture> run_events(const std::vector<PointerEvent>& events,
+                                       const GestureConfig& cfg = GestureConfig{}) {
+    GestureRecognizer rec;
+    rec.configure(cfg);
+    std::vector<Gesture> out;
+    gesture_traces::replay(rec, gesture_traces::split_frames(events), [&out](GestureSpan gs) {
+        for (const Gesture& g : gs) out.push_back(g);
+    });
+    CHECK_EQ(rec.dropped(), 0);
+    return out;
+}
+
+// Replays a recorded trace, plus optional extra lines overlaid on its timeline.
+static std::vector<Gesture> run(const char* name, const GestureConfig& cfg = GestureConfig{},
+                                const char* extra = nullptr) {
+    std::vector<PointerEvent> events;
+    const char* text = gesture_traces::find(name);
+    CHECK(text != nullptr);
+    if (text) CHECK(gesture_traces::parse(text, events));
+    if (extra) CHECK(gesture_traces::parse(extra, events));
+    return run_events(events, cfg);
+}
+
+// "Kind.Phase" list; a run of Updates of one kind reads "Kind.Update+".
+static std::string describe(const std::vector<Gesture>& gs) {
+    std::string s;
+    for (size_t i = 0; i < gs.size(); i++) {
+        const bool update = gs[i].phase == GesturePhase::Update;
+        if (update && i > 0 && gs[i - 1].phase == GesturePhase::Update && gs[i - 1].kind == gs[i].kind) continue;
+        if (!s.empty()) s += ' ';
+        s += kind_name(gs[i].kind);
+        s += '.';
+        s += phase_name(gs[i].phase);
+        if (update) s += '+';
+    }
+    return s;
+}
+
+static void expect(const char* trace, const std::vector<Gesture>& gs, const char* want) {
+    const std::string got = describe(gs);
+    if (got != want) {
+        ::rce_test::fail(__FILE__, __LINE__, trace);
+        fprintf(stderr, "  got:  %s\n  want: %s\n", got.c_str(), want);
+    }
+}
+
+static void test_recorded_traces() {
+    std::vector<Gesture> gs = run("tap");
+    expect("tap", gs, "Tap.End");
+    if (gs.size() == 1) {
+        CHECK_EQ(gs[0].x, 104);
+        CHECK_EQ(gs[0].pointer_id, 0);
+    }
+
+    expect("slow_release", run("slow_release"), "");
+    expect("slow_drag", run("slow_drag"), "Drag.Begin Drag.Update+ Drag.End");
+
+    gs = run("fling");
+    expect("fling", gs, "Drag.Begin Drag.Update+ Drag.End Fling.End");
+    if (!gs.empty() && gs.back().kind == GestureKind::Fling) {
+        CHECK_NEAR(gs.back().x, 4800.0, 200.0);
+        CHECK_NEAR(gs.back().y, -120.0, 20.0);
+    }
+
+    gs = run("pinch_out");
+    expect("pinch_out", gs, "Pinch.Begin Pinch.Update+ Pinch.End");
+    if (!gs.empty()) {
+        CHECK_NEAR(gs.back().value, 2.5, 1e-4);
+        CHECK_NEAR(gs.back().x, 400.0, 1e-3);  // centroid
+        CHECK_EQ(gs.back().pointer_id, 0);
+        for (size_t i = 1; i < gs.size(); i++) CHECK(gs[i].value >= gs[i - 1].value);
+    }
+
+    gs = run("drag_then_pinch");
+    expect("drag_then_pinch", gs,
+           "Drag.Begin Drag.Update+ Drag.Cancel Pinch.Begin Pinch.Update+ Pinch.End");
+    if (!gs.empty()) CHECK_NEAR(gs.back().value, 0.5, 1e-4);
+
+    expect("cancel", run("cancel"), "Drag.Begin Drag.Update+ Drag.Cancel");
+
+    gs = run("long_press_drag");
+    expect("long_press_drag", gs, "LongPress.End Drag.Begin Drag.Update+ Drag.End");
+    if (!gs.empty()) CHECK(gs[0].value >= 0.5f && gs[0].value < 0.52f);
+}
+
+static void test_thresholds() {
+    GestureConfig cfg;
+    cfg.touch_slop = 100.0f;  // the 60 px drag never leaves the slop: a 233 ms tap
+    expect("slow_drag, big slop", run("slow_drag", cfg), "Tap.End");
+
+    cfg = GestureConfig{};
+    cfg.fling_min_velocity = 6000.0f;
+    expect("fling, high min velocity", run("fling", cfg), "Drag.Begin Drag.Update+ Drag.End");
+
+    cfg = GestureConfig{};
+    cfg.long_press_ns = 1000000000;
+    expect("long_press_drag, 1 s long press", run("long_press_drag", cfg), "Drag.Begin Drag.Update+ Drag.End");
+}
+
+static void test_overlaid_traces() {
+    // A third finger during a pinch is ignored, including its up.
+    expect("pinch + third finger", run("pinch_out", GestureConfig{}, "40 d 2 900 900\n60 m 2 990 900\n80 u 2 990 900\n"),
+           "Pinch.Begin Pinch.Update+ Pinch.End");
+
+    // A tap by another finger once the fling has lifted.
+    std::vector<Gesture> gs = run("fling", GestureConfig{}, "100 d 5 10 10\n150 u 5 10 10\n");
+    expect("fling then tap", gs, "Drag.Begin Drag.Update+ Drag.End Fling.End Tap.End");
+    if (!gs.empty()) CHECK_EQ(gs.back().pointer_id, 5);
+}
+
+static void test_overflow_and_reset() {
+    // 100 taps delivered in one frame: the per-frame buffer keeps 64.
+    std::vector<PointerEvent> events;
+    for (int i = 0; i < 100; i++) {
+        events.push_back(PointerEvent{EventType::PointerDown, i % 3, 1, 1, 1, (uint64_t)i * 100000});
+        events.push_back(PointerEvent{EventType::PointerUp, i % 3, 1, 1, 1, (uint64_t)i * 100000 + 50000});
+    }
+    GestureRecognizer rec;
+    rec.update(EventSpan(events.data(), (uint32_t)events.size()), 16000000);
+    CHECK_EQ(rec.gestures().size(), MAX_FRAME_GESTURES);
+    CHECK_EQ(rec.dropped(), 100 - MAX_FRAME_GESTURES);
+
+    // reset() drops a held finger without emitting, and its later up is unknown.
+    PointerEvent down{EventType::PointerDown, 1, 5, 5, 1, 20000000};
+    rec.update(EventSpan(&down, 1), 20000000);
+    rec.reset();
+    PointerEvent up{EventType::PointerUp, 1, 5, 5, 1, 30000000};
+    rec.update(EventSpan(&up, 1), 30000000);
+    CHECK(rec.gestures().empty());
+}
+
+static void test_msg_roundtrip() {
+    const Gesture g{GestureKind::Pinch, GesturePhase::Update, -2, -3.5f, 1e6f, 0.75f};
+    const rce::EPMsg m = gesture_to_msg(g);
+    CHECK(m.type == rce::EPType::Gesture);
+    const Gesture r = gesture_from_msg(m);
+    CHECK(r.kind == g.kind && r.phase == g.phase);
+    CHECK_EQ(r.pointer_id, -2);
+    CHECK(r.x == g.x && r.y == g.y && r.value == g.value);
+}
+
+int main() {
+    test_recorded_traces();
+    test_thresholds();
+    test_overlaid_traces();
+    test_overflow_and_reset();
+    test_msg_roundtrip();
+    return rce_test::finish("gesture_test");
+}
@@ -0,0 +1,331 @@
+#pragma once
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "input/gesture.h"
+
+// Recorded touch traces and a frame-by-frame replayer for GestureRecognizer,
+// shared by gesture_test and gesture_bench.
+//
+// One event per line: "<t_ms> <d|m|u|c> <pointer_id> <x> <y>" (down, move,
+// up, cancel). Moves are sampled at 240 Hz, several per 60 Hz frame; '#'
+// starts a comment.
+
+namespace gesture_traces {
+
+struct Trace {
+    const char* name;
+    const char* text;
+};
+
+static const Trace kTraces[] = {
+    {"tap",
+     // One short press, a few px of wobble.
+     R"TRACE(
+0 d 0 100 100
+40 m 0 103 101
+90 u 0 104 101
+)TRACE"},
+    {"slow_release",
+     // Held past tap_max_ns but released before long_press_ns: nothing.
+     R"TRACE(
+0 d 0 100 100
+150 m 0 101 100
+400 u 0 101 100
+)TRACE"},
+    {"slow_drag",
+     // 720 px/s to the right, then rests 150 ms before lifting: no fling.
+     R"TRACE(
+3 d 0 200 300
+7.167 m 0 203 301
+11.333 m 0 206 300
+15.5 m 0 209 301
+19.667 m 0 212 300
+23.833 m 0 215 301
+28 m 0 218 300
+32.167 m 0 221 301
+36.333 m 0 224 300
+40.5 m 0 227 301
+44.667 m 0 230 300
+48.833 m 0 233 301
+53 m 0 236 300
+57.167 m 0 239 301
+61.333 m 0 242 300
+65.5 m 0 245 301
+69.667 m 0 248 300
+73.833 m 0 251 301
+78 m 0 254 300
+82.167 m 0 257 301
+86.333 m 0 260 300
+236.333 u 0 260 300
+)TRACE"},
+    {"fling",
+     // 4800 px/s swipe, lifted while moving.
+     R"TRACE(
+5 d 0 100 600
+9.167 m 0 120 599.5
+13.333 m 0 140 599
+17.5 m 0 160 598.5
+21.667 m 0 180 598
+25.833 m 0 200 597.5
+30 m 0 220 597
+34.167 m 0 240 596.5
+38.333 m 0 260 596
+42.5 m 0 280 595.5
+46.667 m 0 300 595
+50.833 m 0 320 594.5
+55 m 0 340 594
+59.167 m 0 360 593.5
+63.333 m 0 380 593
+67.5 m 0 400 592.5
+71.5 u 0 400 592.5
+)TRACE"},
+    {"pinch_out",
+     // Two fingers spreading from 200 to 500 px apart.
+     R"TRACE(
+0 d 0 300 500
+10 d 1 500 500
+14.167 m 0 295 500
+14.167 m 1 505 500
+18.333 m 0 290 500
+18.333 m 1 510 500
+22.5 m 0 285 500
+22.5 m 1 515 500
+26.667 m 0 280 500
+26.667 m 1 520 500
+30.833 m 0 275 500
+30.833 m 1 525 500
+35 m 0 270 500
+35 m 1 530 500
+39.167 m 0 265 500
+39.167 m 1 535 500
+43.333 m 0 260 500
+43.333 m 1 540 500
+47.5 m 0 255 500
+47.5 m 1 545 500
+51.667 m 0 250 500
+51.667 m 1 550 500
+55.833 m 0 245 500
+55.833 m 1 555 500
+60 m 0 240 500
+60 m 1 560 500
+64.167 m 0 235 500
+64.167 m 1 565 500
+68.333 m 0 230 500
+68.333 m 1 570 500
+72.5 m 0 225 500
+72.5 m 1 575 500
+76.667 m 0 220 500
+76.667 m 1 580 500
+80.833 m 0 215 500
+80.833 m 1 585 500
+85 m 0 210 500
+85 m 1 590 500
+89.167 m 0 205 500
+89.167 m 1 595 500
+93.333 m 0 200 500
+93.333 m 1 600 500
+97.5 m 0 195 500
+97.5 m 1 605 500
+101.667 m 0 190 500
+101.667 m 1 610 500
+105.833 m 0 185 500
+105.833 m 1 615 500
+110 m 0 180 500
+110 m 1 620 500
+114.167 m 0 175 500
+114.167 m 1 625 500
+118.333 m 0 170 500
+118.333 m 1 630 500
+122.5 m 0 165 500
+122.5 m 1 635 500
+126.667 m 0 160 500
+126.667 m 1 640 500
+130.833 m 0 155 500
+130.833 m 1 645 500
+135 m 0 150 500
+135 m 1 650 500
+155 u 1 650 500
+170 u 0 150 500
+)TRACE"},
+    {"drag_then_pinch",
+     // A drag joined by a second finger, pinching in from 400 to 200 px.
+     R"TRACE(
+0 d 0 400 400
+4.167 m 0 410 400
+8.333 m 0 420 400
+12.5 m 0 430 400
+16.667 m 0 440 400
+20.833 m 0 450 400
+25 m 0 460 400
+29.167 m 0 470 400
+33.333 m 0 480 400
+37.5 m 0 490 400
+41.667 m 0 500 400
+100 d 1 100 400
+104.167 m 0 495 400
+104.167 m 1 105 400
+108.333 m 0 490 400
+108.333 m 1 110 400
+112.5 m 0 485 400
+112.5 m 1 115 400
+116.667 m 0 480 400
+116.667 m 1 120 400
+120.833 m 0 475 400
+120.833 m 1 125 400
+125 m 0 470 400
+125 m 1 130 400
+129.167 m 0 465 400
+129.167 m 1 135 400
+133.333 m 0 460 400
+133.333 m 1 140 400
+137.5 m 0 455 400
+137.5 m 1 145 400
+141.667 m 0 450 400
+141.667 m 1 150 400
+145.833 m 0 445 400
+145.833 m 1 155 400
+150 m 0 440 400
+150 m 1 160 400
+154.167 m 0 435 400
+154.167 m 1 165 400
+158.333 m 0 430 400
+158.333 m 1 170 400
+162.5 m 0 425 400
+162.5 m 1 175 400
+166.667 m 0 420 400
+166.667 m 1 180 400
+170.833 m 0 415 400
+170.833 m 1 185 400
+175 m 0 410 400
+175 m 1 190 400
+179.167 m 0 405 400
+179.167 m 1 195 400
+183.333 m 0 400 400
+183.333 m 1 200 400
+193.333 u 0 400 400
+197.5 m 1 210 400
+201.667 m 1 220 400
+205.833 m 1 230 400
+210 m 1 240 400
+214.167 m 1 250 400
+234.167 u 1 250 400
+)TRACE"},
+    {"cancel",
+     // Drag aborted by the system.
+     R"TRACE(
+0 d 3 50 50
+4.167 m 3 50 58
+8.333 m 3 50 66
+12.5 m 3 50 74
+16.667 m 3 50 82
+20.833 m 3 50 90
+25 m 3 50 98
+29.167 m 3 50 106
+33.333 m 3 50 114
+35.333 c 3 0 0
+)TRACE"},
+    {"long_press_drag",
+     // Held still past long_press_ns, then dragged.
+     R"TRACE(
+0 d 0 320 240
+200 m 0 321 241
+650 m 0 322 240
+654.167 m 0 328 240
+658.333 m 0 334 240
+662.5 m 0 340 240
+666.667 m 0 346 240
+670.833 m 0 352 240
+675 m 0 358 240
+679.167 m 0 364 240
+683.333 m 0 370 240
+883.333 u 0 370 240
+)TRACE"},
+};
+
+inline const char* find(const char* name) {
+    for (const Trace& t : kTraces) {
+        if (std::string(t.name) == name) return t.text;
+    }
+    return nullptr;
+}
+
+// Appends the events of text, shifted by offset_ns, keeping the whole list in
+// timestamp order (so traces can be overlaid). Returns false on a bad line.
+inline bool parse(const char* text, std::vector<input::PointerEvent>& out, uint64_t offset_ns = 0) {
+    const size_t first = out.size();
+    const char* p = text;
+    while (*p) {
+        const char* eol = p;
+        while (*eol && *eol != '\n') eol++;
+        const std::string line(p, eol);
+        p = *eol ? eol + 1 : eol;
+        const size_t start = line.find_first_not_of(" \t");
+        if (start == std::string::npos || line[start] == '#') continue;
+
+        double t_ms;
+        char kind;
+        int id;
+        float x, y;
+        if (sscanf(line.c_str(), "%lf %c %d %f %f", &t_ms, &kind, &id, &x, &y) != 5) return false;
+        input::PointerEvent e{};
+        switch (kind) {
+            case 'd': e.type = input::EventType::PointerDown; break;
+            case 'm': e.type = input::EventType::PointerMove; break;
+            case 'u': e.type = input::EventType::PointerUp; break;
+            case 'c': e.type = input::EventType::PointerCancel; break;
+            default: return false;
+        }
+        e.pointer_id = id;
+        e.x = x;
+        e.y = y;
+        e.pressure = 1.0f;
+        e.timestamp_ns = offset_ns + (uint64_t)(t_ms * 1e6 + 0.5);
+        out.push_back(e);
+    }
+    auto earlier = [](const input::PointerEvent& a, const input::PointerEvent& b) {
+        return a.timestamp_ns < b.timestamp_ns;
+    };
+    const auto mid = out.begin() + (std::ptrdiff_t)first;
+    std::stable_sort(mid, out.end(), earlier);
+    if (mid != out.begin() && mid != out.end() && earlier(*mid, *(mid - 1))) {
+        std::inplace_merge(out.begin(), mid, out.end(), earlier);
+    }
+    return true;
+}
+
+// A trace cut into display frames: frame i gets the events with
+// timestamp <= end_ns, the way the platform loop hands them over.
+struct Frames {
+    std::vector<input::PointerEvent> events;
+    std::vector<uint32_t> begin;   // per frame, index into events
+    std::vector<uint32_t> count;
+    std::vector<uint64_t> end_ns;
+};
+
+inline Frames split_frames(const std::vector<input::PointerEvent>& events, uint64_t frame_ns = 16666667) {
+    Frames f;
+    f.events = events;
+    uint32_t i = 0;
+    for (uint64_t end = frame_ns; i < events.size(); end += frame_ns) {
+        const uint32_t b = i;
+        while (i < events.size() && events[i].timestamp_ns <= end) i++;
+        f.begin.push_back(b);
+        f.count.push_back(i - b);
+        f.end_ns.push_back(end);
+    }
+    return f;
+}
+
+template <typename Fn>
+inline void replay(input::GestureRecognizer& rec, const Frames& f, Fn&& on_frame) {
+    for (size_t i = 0; i < f.begin.size(); i++) {
+        rec.update(input::EventSpan(f.events.data() + f.begin[i], f.count[i]), f.end_ns[i]);
+        on_frame(rec.gestures());
+    }
+}
+
+} // namespace gesture_traces
@@ -0,0 +1,268 @@
+#include "gfx/gl_state_cache.h"
+#include "test_util.h"
+
+#include <map>
+#include <string.h>
+#include <vector>
+
+// GlStateCache against a fake GL: a tiny driver model that tracks the state
+// each entry point sets and counts the calls that reach it.
+
+namespace {
+
+struct FakeGl {
+    std::map<unsigned int, bool> caps;
+    int viewport[4] = {};
+    int scissor[4] = {};
+    float clear_color[4] = {};
+    unsigned int program = 0;
+    unsigned int array_buffer = 0;
+    std::map<unsigned int, unsigned int> element_buffer;  // per VAO
+    unsigned int active_unit = 0;
+    unsigned int texture[GlStateCache::MAX_TEXTURE_UNITS] = {};
+    unsigned int blend_src = 1, blend_dst = 0;
+    unsigned int vao = 0;
+
+    // What each glClear would have drawn with.
+    struct ClearSnapshot {
+        unsigned int mask;
+        float color[4];
+        bool scissor_on;
+        int scissor[4];
+    };
+    std::vector<ClearSnapshot> clears;
+
+    uint32_t calls = 0;
+    uint32_t active_texture_calls = 0;
+
+    bool same_state(const FakeGl& o) const {
+        std::map<unsigned int, bool> a = caps, b = o.caps;  // never touched == disabled
+        for (auto& c : a) b.emplace(c.first, false);
+        for (auto& c : o.caps) a.emplace(c.first, false);
+        if (a != b) return false;
+        if (memcmp(viewport, o.viewport, sizeof(viewport)) || memcmp(scissor, o.scissor, sizeof(scissor))) return false;
+        if (memcmp(clear_color, o.clear_color, sizeof(clear_color))) return false;
+        if (program != o.program || array_buffer != o.array_buffer || vao != o.vao) return false;
+        if (element_buffer != o.element_buffer) return false;
+        if (memcmp(texture, o.texture, sizeof(texture))) return false;
+        if (blend_src != o.blend_src || blend_dst != o.blend_dst) return false;
+        if (clears.size() != o.clears.size()) return false;
+        for (size_t i = 0; i < clears.size(); i++) {
+            if (memcmp(&clears[i], &o.clears[i], sizeof(ClearSnapshot))) return false;
+        }
+        return true;
+    }
+};
+
+FakeGl* g_gl = nullptr;
+
+void fake_enable(unsigned int cap) { g_gl->calls++; g_gl->caps[cap] = true; }
+void fake_disable(unsigned int cap) { g_gl->calls++; g_gl->caps[cap] = false; }
+void fake_viewport(int x, int y, int w, int h) {
+    g_gl->calls++;
+    const int v[4] = {x, y, w, h};
+    memcpy(g_gl->viewport, v, sizeof(v));
+}
+void fake_scissor(int x, int y, int w, int h) {
+    g_gl->calls++;
+    const int v[4] = {x, y, w, h};
+    memcpy(g_gl->scissor, v, sizeof(v));
+}
+void fake_clear_color(float r, float g, float b, float a) {
+    g_gl->calls++;
+    const float v[4] = {r, g, b, a};
+    memcpy(g_gl->clear_color, v, sizeof(v));
+}
+void fake_clear(unsigned int mask) {
+    g_gl->calls++;
+    FakeGl::ClearSnapshot s;
+    memset(&s, 0, sizeof(s));
+    s.mask = mask;
+    memcpy(s.color, g_gl->clear_color, sizeof(s.color));
+    s.scissor_on = g_gl->caps[GlStateCache::SCISSOR_TEST];
+    memcpy(s.scissor, g_gl->scissor, sizeof(s.scissor));
+    g_gl->clears.push_back(s);
+}
+void fake_use_program(unsigned int p) { g_gl->calls++; g_gl->program = p; }
+void fake_bind_buffer(unsigned int target, unsigned int buffer) {
+    g_gl->calls++;
+    if (target == GlStateCache::ARRAY_BUFFER) g_gl->array_buffer = buffer;
+    else if (target == GlStateCache::ELEMENT_ARRAY_BUFFER) g_gl->element_buffer[g_gl->vao] = buffer;
+}
+void fake_active_texture(unsigned int unit) {
+    g_gl->calls++;
+    g_gl->active_texture_calls++;
+    g_gl->active_unit = unit - GlStateCache::TEXTURE0;
+}
+void fake_bind_texture(unsigned int, unsigned int tex) { g_gl->calls++; g_gl->texture[g_gl->active_unit] = tex; }
+void fake_blend_func(unsigned int s, unsigned int d) { g_gl->calls++; g_gl->blend_src = s; g_gl->blend_dst = d; }
+void fake_bind_vertex_array(unsigned int a) { g_gl->calls++; g_gl->vao = a; }
+
+GlFunctions fake_functions() {
+    GlFunctions f;
+    f.Enable = fake_enable;
+    f.Disable = fake_disable;
+    f.Viewport = fake_viewport;
+    f.Scissor = fake_scissor;
+    f.ClearColor = fake_clear_color;
+    f.Clear = fake_clear;
+    f.UseProgram = fake_use_program;
+    f.BindBuffer = fake_bind_buffer;
+    f.ActiveTexture = fake_active_texture;
+    f.BindTexture = fake_bind_texture;
+    f.BlendFunc = fake_blend_func;
+    f.BindVertexArray = fake_bind_vertex_array;
+    return f;
+}
+
+} // namespace
+
+static void test_filtering() {
+    FakeGl gl;
+    g_gl = &gl;
+    GlStateCache c;
+    c.set_functions(fake_functions());
+    c.begin_frame();
+
+    c.viewport(0, 0, 100, 50);
+    c.viewport(0, 0, 100, 50);
+    c.viewport(0, 0, 100, 51);
+    CHECK_EQ(gl.calls, 2);
+    CHECK_EQ(c.frame_stats().issued, 2);
+    CHECK_EQ(c.frame_stats().skipped, 1);
+
+    c.enable(GlStateCache::SCISSOR_TEST);
+    c.enable(GlStateCache::SCISSOR_TEST);
+    c.disable(GlStateCache::SCISSOR_TEST);
+    c.enable(0x0BD0);  // GL_DITHER: not tracked, always issued
+    c.enable(0x0BD0);
+    CHECK_EQ(gl.calls, 6);
+
+    c.clear_color(0.1f, 0.2f, 0.3f, 1.0f);
+    c.clear_color(0.1f, 0.2f, 0.3f, 1.0f);
+    c.clear_color(0.1f, 0.2f, 0.3f, 0.99999994f);  // any change reaches GL
+    c.clear(0x4000);
+    c.clear(0x4000);  // clears are never filtered
+    CHECK_EQ(gl.calls, 10);
+    CHECK_EQ(gl.clears.size(), 2);
+
+    // Texture units: ActiveTexture only when the unit changes.
+    c.bind_texture(0, 5);
+    c.bind_texture(0, 6);
+    c.bind_texture(0, 6);
+    c.bind_texture(1, 6);
+    c.bind_texture(GlStateCache::MAX_TEXTURE_UNITS, 9);  // out of range: ignored
+    CHECK_EQ(gl.active_texture_calls, 2);
+    CHECK_EQ(gl.texture[0], 6);
+    CHECK_EQ(gl.texture[1], 6);
+
+    // The element buffer binding belongs to the VAO.
+    c.bind_vertex_array(1);
+    c.bind_buffer(GlStateCache::ELEMENT_ARRAY_BUFFER, 7);
+    c.bind_buffer(GlStateCache::ELEMENT_ARRAY_BUFFER, 7);
+    const uint32_t before = gl.calls;
+    c.bind_vertex_array(2);
+    c.bind_buffer(GlStateCache::ELEMENT_ARRAY_BUFFER, 7);
+    CHECK_EQ(gl.calls - before, 2);
+    CHECK_EQ(gl.element_buffer[2], 7);
+
+    // begin_frame rolls the counters over.
+    const GlCallStats frame = c.frame_stats();
+    c.begin_frame();
+    CHECK_EQ(c.last_frame().issued, frame.issued);
+    CHECK_EQ(c.last_frame().skipped, frame.skipped);
+    CHECK_EQ(c.frame_stats().issued + c.frame_stats().skipped, 0);
+    CHECK_EQ(frame.issued, gl.calls);
+
+    // invalidate(): the next call of each kind goes out again.
+    c.invalidate();
+    c.viewport(0, 0, 100, 51);
+    c.use_program(0);
+    c.bind_texture(1, 6);
+    CHECK_EQ(c.frame_stats().skipped, 0);
+    CHECK_EQ(gl.active_texture_calls, 3);
+}
+
+// A steady frame like EglRenderer's (border clear, then content clear): only
+// what actually differs between the two halves reaches GL.
+static void test_steady_frame() {
+    FakeGl gl;
+    g_gl = &gl;
+    GlStateCache c;
+    c.set_functions(fake_functions());
+    for (int frame = 0; frame < 3; frame++) {
+        c.begin_frame();
+        c.disable(GlStateCache::SCISSOR_TEST);
+        c.viewport(0, 0, 1080, 2400);
+        c.clear_color(0, 0, 0, 1);
+        c.clear(0x4000);
+        c.enable(GlStateCache::SCISSOR_TEST);
+        c.scissor(0, 100, 1080, 2200);
+        c.viewport(0, 100, 1080, 2200);
+        c.clear_color(0.2f, 0.2f, 0.2f, 1);
+        c.clear(0x4000);
+    }
+    // 2 clears, plus scissor test, viewport and clear color set twice each
+    // (they alternate); the scissor rect never changes.
+    CHECK_EQ(c.frame_stats().issued, 8);
+    CHECK_EQ(c.frame_stats().skipped, 1);
+}
+
+// Random call sequences: GL state through the cache must always match the
+// state with every call sent straight to GL.
+static void test_random_equivalence() {
+    FakeGl direct, cached;
+    const GlFunctions fns = fake_functions();
+    GlStateCache c;
+    g_gl = &cached;
+    c.set_functions(fns);
+
+    uint32_t rng = 2024;
+    auto next = [&rng] { rng = rng * 1664525u + 1013904223u; return rng >> 8; };
+    const unsigned int caps[] = {GlStateCache::SCISSOR_TEST, GlStateCache::BLEND, GlStateCache::DEPTH_TEST,
+                                 GlStateCache::CULL_FACE, 0x0BD0};
+    bool equal = true;
+    for (int i = 0; i < 20000 && equal; i++) {
+        const uint32_t op = next() % 13;
+        const uint32_t a = next() % 3, b = next() % 3;
+        // Same call, once through fns directly and once through the cache.
+        for (int pass = 0; pass < 2; pass++) {
+            const bool via_cache = pass == 1;
+            g_gl = via_cache ? &cached : &direct;
+            switch (op) {
+                case 0: via_cache ? c.enable(caps[a + b]) : fns.Enable(caps[a + b]); break;
+                case 1: via_cache ? c.disable(caps[a + b]) : fns.Disable(caps[a + b]); break;
+                case 2: via_cache ? c.viewport(0, 0, (int)a, (int)b) : fns.Viewport(0, 0, (int)a, (int)b); break;
+                case 3: via_cache ? c.scissor((int)a, 0, (int)b, 1) : fns.Scissor((int)a, 0, (int)b, 1); break;
+                case 4: via_cache ? c.clear_color((float)a, (float)b, 0, 1) : fns.ClearColor((float)a, (float)b, 0, 1); break;
+                case 5: via_cache ? c.clear(0x4000) : fns.Clear(0x4000); break;
+                case 6: via_cache ? c.use_program(a) : fns.UseProgram(a); break;
+                case 7: via_cache ? c.bind_buffer(GlStateCache::ARRAY_BUFFER, a)
+                                  : fns.BindBuffer(GlStateCache::ARRAY_BUFFER, a); break;
+                case 8: via_cache ? c.bind_buffer(GlStateCache::ELEMENT_ARRAY_BUFFER, a)
+                                  : fns.BindBuffer(GlStateCache::ELEMENT_ARRAY_BUFFER, a); break;
+                case 9:
+                    if (via_cache) {
+                        c.bind_texture(a, b);
+                    } else {
+                        fns.ActiveTexture(GlStateCache::TEXTURE0 + a);
+                        fns.BindTexture(GlStateCache::TEXTURE_2D, b);
+                    }
+                    break;
+                case 10: via_cache ? c.blend_func(a, b) : fns.BlendFunc(a, b); break;
+                case 11: via_cache ? c.bind_vertex_array(a) : fns.BindVertexArray(a); break;
+                case 12: if (via_cache && b == 0) c.begin_frame(); break;
+            }
+        }
+        equal = direct.same_state(cached);
+    }
+    CHECK(equal);
+    CHECK(cached.calls < direct.calls);
+}
+
+int main() {
+    test_filtering();
+    test_steady_frame();
+    test_random_equivalence();
+    return rce_test::finish("gl_state_cache_test");
+}
@@ -0,0 +1,218 @@
+#include "input/input_resample.h"
+#include "test_util.h"
+
+using namespace input;
+
+static const uint64_t MS = 1000000ull;
+
+// Pointer 1 goes down at the origin and moves along x at 10 px/ms:
+// samples (0 ms, 0), (8 ms, 80), (16 ms, 160).
+static void straight_drag(InputState& in) {
+    in.begin_frame();
+    in.push_pointer_down(1, 0, 0, 0);
+    in.push_pointer_move(1, 80, 0, 8 * MS);
+    in.push_pointer_move(1, 160, 0, 16 * MS);
+}
+
+static ResampledPointer resample_drag(const ResampleConfig& cfg, uint64_t present_ns) {
+    InputState in;
+    InputResampler rs;
+    rs.configure(cfg);
+    straight_drag(in);
+    rs.update(in, present_ns);
+    CHECK_EQ(rs.count(), 1);
+    return rs.pointer(0);
+}
+
+static void test_interpolation() {
+    ResampleConfig cfg;
+    cfg.latency_ns = 8 * MS;
+
+    // Target 12 ms: halfway between the last two samples.
+    ResampledPointer p = resample_drag(cfg, 20 * MS);
+    CHECK_NEAR(p.x, 120, 1e-3);
+    CHECK_NEAR(p.y, 0, 1e-6);
+    CHECK(!p.predicted);
+    CHECK_NEAR(p.vx, 10000, 1e-2);  // px/s
+
+    // Target 4 ms: between the first two.
+    p = resample_drag(cfg, 12 * MS);
+    CHECK_NEAR(p.x, 40, 1e-3);
+    CHECK(!p.predicted);
+
+    // Target on the newest sample: no prediction.
+    p = resample_drag(cfg, 24 * MS);
+    CHECK_NEAR(p.x, 160, 1e-3);
+    CHECK(!p.predicted);
+}
+
+static void test_prediction_horizon() {
+    const ResampleConfig cfg;  // aims at present
+
+    // 4 ms past the newest sample: the full way.
+    ResampledPointer p = resample_drag(cfg, 20 * MS);
+    CHECK(p.predicted);
+    CHECK_NEAR(p.x, 200, 1e-2);
+
+    // 12 ms out is more than half the 8 ms sample gap; still the full way.
+    p = resample_drag(cfg, 28 * MS);
+    CHECK(p.predicted);
+    CHECK_NEAR(p.x, 280, 1e-2);
+
+    // 24 ms out: capped at max_predict_ns (one 60 Hz frame).
+    p = resample_drag(cfg, 40 * MS);
+    CHECK(p.predicted);
+    CHECK_NEAR(p.x, 160 + 10000 * (double)cfg.max_predict_ns * 1e-9, 1e-2);
+
+    // Newest sample older than max_sample_age_ns: the pointer is holding still.
+    p = resample_drag(cfg, 16 * MS + cfg.max_sample_age_ns + 1);
+    CHECK(!p.predicted);
+    CHECK_NEAR(p.x, 160, 1e-3);
+
+    // Prediction off.
+    ResampleConfig off;
+    off.predict = false;
+    p = resample_drag(off, 20 * MS);
+    CHECK(!p.predicted);
+    CHECK_NEAR(p.x, 160, 1e-3);
+}
+
+static void test_prediction_confidence() {
+    const ResampleConfig cfg;
+    InputState in;
+    InputResampler rs;
+
+    // Samples closer than min_sample_gap_ns: velocity too noisy to trust.
+    in.begin_frame();
+    in.push_pointer_down(1, 0, 0, 0);
+    in.push_pointer_move(1, 10, 0, 1 * MS);
+    rs.update(in, 10 * MS);
+    CHECK(!rs.pointer(0).predicted);
+    CHECK_NEAR(rs.pointer(0).x, 10, 1e-3);
+
+    // A direction reversal over the last three samples.
+    in.begin_frame();
+    in.push_pointer_down(2, 0, 0, 20 * MS);
+    in.push_pointer_move(2, 80, 0, 28 * MS);
+    in.push_pointer_move(2, 40, 0, 36 * MS);
+    rs.update(in, 40 * MS);
+    const ResampledPointer* p = rs.find(2);
+    CHECK(p != nullptr);
+    if (p) {
+        CHECK(!p->predicted);
+        CHECK_NEAR(p->x, 40, 1e-3);
+    }
+
+    // Two steps the same way bring prediction back.
+    in.begin_frame();
+    in.push_pointer_move(2, 0, 0, 44 * MS);
+    rs.update(in, 48 * MS);
+    p = rs.find(2);
+    CHECK(p && p->predicted);
+    if (p) CHECK_NEAR(p->x, -20, 1e-2);
+}
+
+static void test_lift() {
+    InputState in;
+    InputResampler rs;
+    in.begin_frame();
+    in.push_pointer_down(5, 0, 0, 0);
+    in.push_pointer_move(5, 40, 10, 8 * MS);
+    in.push_pointer_up(5, 100, 30, 16 * MS);
+    rs.update(in, 40 * MS);
+
+    // Reported where it went up, with the release velocity, never predicted.
+    CHECK_EQ(rs.count(), 1);
+    const ResampledPointer& p = rs.pointer(0);
+    CHECK_EQ(p.id, 5);
+    CHECK(!(p.state & POINTER_DOWN));
+    CHECK(p.state & POINTER_RELEASED);
+    CHECK(!p.predicted);
+    CHECK_NEAR(p.x, 100, 1e-3);
+    CHECK_NEAR(p.y, 30, 1e-3);
+    CHECK_NEAR(p.vx, 7500, 1e-2);
+    CHECK_NEAR(p.vy, 2500, 1e-2);
+    float x, y;
+    CHECK(!rs.primary(&x, &y));
+
+    // Gone the next frame.
+    in.begin_frame();
+    rs.update(in, 56 * MS);
+    CHECK_EQ(rs.count(), 0);
+}
+
+static bool same_event(const PointerEvent& e, EventType type, int32_t id, uint64_t t) {
+    return e.type == type && e.pointer_id == id && e.timestamp_ns == t;
+}
+
+static void test_coalesce_interleaved() {
+    InputState in;
+    InputResampler rs;
+    in.begin_frame();
+    in.push_pointer_down(1, 0, 0, 1 * MS);
+    in.push_pointer_down(2, 0, 0, 2 * MS);
+    rs.update(in, 10 * MS);
+
+    // A(t1) B(t2) A(t3): A's merged move sits at t3, after B.
+    in.begin_frame();
+    in.push_pointer_move(1, 1, 0, 11 * MS);
+    in.push_pointer_move(2, 2, 0, 12 * MS);
+    in.push_pointer_move(1, 3, 0, 13 * MS);
+    rs.update(in, 20 * MS);
+    EventSpan c = rs.coalesced();
+    CHECK_EQ(c.size(), 2);
+    if (c.size() == 2) {
+        CHECK(same_event(c[0], EventType::PointerMove, 2, 12 * MS));
+        CHECK(same_event(c[1], EventType::PointerMove, 1, 13 * MS));
+        CHECK_NEAR(c[1].x, 3, 1e-6);
+    }
+
+    // Runs end at a down/up/cancel of the same pointer, not at another
+    // pointer's events; everything stays in time order.
+    in.begin_frame();
+    in.push_pointer_move(1, 4, 0, 21 * MS);
+    in.push_pointer_move(2, 5, 0, 22 * MS);
+    in.push_pointer_move(1, 6, 0, 23 * MS);
+    in.push_pointer_up(1, 6, 0, 24 * MS);
+    in.push_pointer_move(2, 7, 0, 25 * MS);
+    in.push_pointer_down(1, 8, 0, 26 * MS);
+    in.push_pointer_move(1, 9, 0, 27 * MS);
+    in.push_pointer_move(2, 10, 0, 28 * MS);
+    in.push_pointer_move(1, 11, 0, 29 * MS);
+    rs.update(in, 30 * MS);
+    c = rs.coalesced();
+    CHECK_EQ(c.size(), 5);
+    if (c.size() == 5) {
+        CHECK(same_event(c[0], EventType::PointerMove, 1, 23 * MS));
+        CHECK(same_event(c[1], EventType::PointerUp, 1, 24 * MS));
+        CHECK(same_event(c[2], EventType::PointerDown, 1, 26 * MS));
+        CHECK(same_event(c[3], EventType::PointerMove, 2, 28 * MS));
+        CHECK(same_event(c[4], EventType::PointerMove, 1, 29 * MS));
+    }
+    for (uint32_t i = 1; i < c.size(); i++) CHECK(c[i - 1].timestamp_ns < c[i].timestamp_ns);
+
+    // The raw stream is untouched.
+    CHECK_EQ(in.events().size(), 9);
+}
+
+static void test_pointer_msg() {
+    const PointerEvent e{ EventType::PointerMove, 7, 12.5f, -3.25f, 0.75f, 99 };
+    const rce::EPMsg m = pointer_to_msg(e);
+    CHECK(m.type == rce::EPType::Pointer);
+    const PointerEvent r = pointer_from_msg(m);
+    CHECK(r.type == EventType::PointerMove);
+    CHECK_EQ(r.pointer_id, 7);
+    CHECK_NEAR(r.x, 12.5, 0.0);
+    CHECK_NEAR(r.y, -3.25, 0.0);
+    CHECK_NEAR(r.pressure, 0.75, 0.0);
+}
+
+int main() {
+    test_interpolation();
+    test_prediction_horizon();
+    test_prediction_confidence();
+    test_lift();
+    test_coalesce_interleaved();
+    test_pointer_msg();
+    return rce_test::finish("input_resample_test");
+}
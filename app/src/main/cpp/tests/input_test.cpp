@@ -0,0 +1,142 @@
+#include "input/input.h"
+#include "test_util.h"
+
+#include <map>
+
+using namespace input;
+
+static const uint64_t MS = 1000000ull;
+
+static void test_two_fingers_with_history() {
+    InputState in;
+    in.begin_frame();
+    in.push_pointer_down(7, 10, 20, 1 * MS, 0.5f);
+    in.push_pointer_down(3, 100, 200, 2 * MS);
+    // Historical samples of one ACTION_MOVE batch, oldest first.
+    for (int k = 1; k <= 4; k++) {
+        in.push_pointer_move(7, 10.0f + k, 20.0f, (2 + k) * MS);
+        in.push_pointer_move(3, 100.0f, 200.0f - k, (2 + k) * MS);
+    }
+
+    const PointerTable& t = in.pointers();
+    CHECK_EQ(t.count, 2);
+    CHECK_EQ(t.id[0], 7);
+    CHECK_EQ(t.id[1], 3);
+    CHECK_EQ(t.x[0], 14);
+    CHECK_EQ(t.y[1], 196);
+    CHECK_EQ(t.start_x[0], 10);
+    CHECK_EQ(t.start_y[1], 200);
+    CHECK_EQ(t.down_ns[1], 2 * MS);
+    CHECK_EQ(t.last_ns[0], 6 * MS);
+    CHECK(t.state[0] == (POINTER_DOWN | POINTER_PRESSED | POINTER_MOVED));
+    CHECK_EQ(in.events().size(), 10);
+    CHECK(in.events()[0].type == EventType::PointerDown);
+    CHECK_NEAR(in.events()[0].pressure, 0.5, 1e-6);
+    CHECK_EQ(in.events()[9].timestamp_ns, 6 * MS);
+
+    // Primary = oldest pointer still down.
+    CHECK(in.pointer_is_down());
+    CHECK_EQ(in.pointer_x(), 14);
+
+    // Up keeps the slot (RELEASED) until the next frame.
+    in.push_pointer_up(7, 15, 21, 7 * MS);
+    CHECK_EQ(t.count, 2);
+    CHECK(t.state[0] & POINTER_RELEASED);
+    CHECK(!(t.state[0] & POINTER_DOWN));
+    CHECK_EQ(in.pointer_x(), 100); // primary moved to the other finger
+
+    in.begin_frame();
+    CHECK_EQ(t.count, 1);
+    CHECK_EQ(t.id[0], 3);
+    CHECK(t.state[0] == POINTER_DOWN);
+    CHECK(in.events().empty());
+
+    in.push_pointer_cancel(3, 8 * MS);
+    CHECK(t.state[0] & POINTER_CANCELED);
+    CHECK(!in.pointer_is_down());
+    CHECK_EQ(in.pointer_x(), 100); // last known position
+    CHECK(in.events()[0].type == EventType::PointerCancel);
+}
+
+static void test_reused_id_in_one_frame() {
+    InputState in;
+    in.begin_frame();
+    in.push_pointer_down(1, 0, 0, 1 * MS);
+    in.push_pointer_up(1, 0, 0, 2 * MS);
+    in.push_pointer_down(1, 50, 50, 3 * MS);
+    const PointerTable& t = in.pointers();
+    CHECK_EQ(t.count, 1);
+    CHECK(t.state[0] == (POINTER_DOWN | POINTER_PRESSED | POINTER_RELEASED));
+    CHECK_EQ(t.start_x[0], 50);
+    CHECK_EQ(t.down_ns[0], 3 * MS);
+}
+
+static void test_capacity_limits() {
+    InputState in;
+    in.begin_frame();
+    for (int32_t id = 0; id < (int32_t)MAX_POINTERS + 2; id++) in.push_pointer_down(id, (float)id, 0);
+    CHECK_EQ(in.pointers().count, MAX_POINTERS);
+    CHECK_EQ(in.events().size(), MAX_POINTERS + 2); // untracked fingers still produce events
+    CHECK_EQ(in.pointers().find((int32_t)MAX_POINTERS), -1);
+
+    // Event buffer full: events are dropped and counted, the table keeps tracking.
+    for (uint32_t i = 0; i < MAX_FRAME_EVENTS; i++) in.push_pointer_move(0, (float)i, 1, i);
+    CHECK_EQ(in.events().size(), MAX_FRAME_EVENTS);
+    CHECK_EQ(in.dropped_events(), MAX_POINTERS + 2);
+    CHECK_EQ(in.pointers().x[0], MAX_FRAME_EVENTS - 1);
+}
+
+// Random multi-touch streams against a trivial reference model.
+static void test_random_streams() {
+    InputState in;
+    std::map<int32_t, float> model; // id -> x of fingers down
+    uint32_t rng = 99;
+    auto next = [&rng] { rng = rng * 1664525u + 1013904223u; return rng >> 8; };
+
+    uint64_t t = 0;
+    for (int frame = 0; frame < 2000; frame++) {
+        in.begin_frame();
+        const uint32_t n = next() % 24;
+        for (uint32_t k = 0; k < n; k++) {
+            const int32_t id = (int32_t)(next() % 8);
+            const float x = (float)(next() % 1000);
+            t += 100000;
+            const bool down = model.count(id) != 0;
+            switch (next() % 4) {
+                case 0:
+                    if (!down) { in.push_pointer_down(id, x, 0, t); model[id] = x; }
+                    break;
+                case 1:
+                    if (down) { in.push_pointer_up(id, x, 0, t); model.erase(id); }
+                    break;
+                case 2:
+                    if (down) { in.push_pointer_cancel(id, t); model.erase(id); }
+                    break;
+                default:
+                    in.push_pointer_move(id, x, 0, t);
+                    if (down) model[id] = x;
+                    break;
+            }
+        }
+
+        const PointerTable& tb = in.pointers();
+        uint32_t down_count = 0;
+        for (uint32_t i = 0; i < tb.count; i++) {
+            for (uint32_t j = i + 1; j < tb.count; j++) CHECK(tb.id[i] != tb.id[j] || !(tb.state[j] & POINTER_DOWN));
+            if (!(tb.state[i] & POINTER_DOWN)) continue;
+            down_count++;
+            CHECK(model.count(tb.id[i]) == 1);
+            CHECK_EQ(tb.x[i], model[tb.id[i]]);
+        }
+        CHECK_EQ(down_count, model.size());
+        CHECK_EQ(in.pointer_is_down(), !model.empty());
+    }
+}
+
+int main() {
+    test_two_fingers_with_history();
+    test_reused_id_in_one_frame();
+    test_capacity_limits();
+    test_random_streams();
+    return rce_test::finish("input_test");
+}
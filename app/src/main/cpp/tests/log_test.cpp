@@ -0,0 +1,95 @@
+#include "app/log.h"
+#include "test_util.h"
+
+#include <stdlib.h>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace rce;
+
+static std::string read_all(int fd) {
+    std::string out;
+    char buf[512];
+    ssize_t n;
+    while ((n = read(fd, buf, sizeof(buf))) > 0) out.append(buf, (size_t)n);
+    return out;
+}
+
+// Runs fn in a child with stdout on a pipe; returns its output and wait status.
+template <typename Fn>
+static std::string run_child(Fn fn, int* status) {
+    int fds[2];
+    if (pipe(fds) != 0) return {};
+    const pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        dup2(fds[1], 1);
+        fn();
+        _exit(99); // fn must exit by itself
+    }
+    close(fds[1]);
+    std::string out = read_all(fds[0]);
+    close(fds[0]);
+    waitpid(pid, status, 0);
+    return out;
+}
+
+// Exiting without log_shutdown (early return, exit() after a Lua panic...)
+// must neither abort on the joinable writer thread nor lose queued lines.
+// Runs first: fork() before this process has started its own writer.
+static void test_exit_without_shutdown() {
+    int status = 0;
+    const std::string out = run_child([] {
+        for (int i = 0; i < 100; i++) LOGI("child line %d", i);
+        exit(3);
+    }, &status);
+    CHECK(WIFEXITED(status));
+    CHECK_EQ(WIFEXITED(status) ? WEXITSTATUS(status) : -1, 3);
+    CHECK(out.find("child line 0\n") != std::string::npos);
+    CHECK(out.find("child line 99\n") != std::string::npos);
+}
+
+static void test_format_to_file() {
+    char tmpl[] = "/tmp/rce_log_test_XXXXXX";
+    if (!mkdtemp(tmpl)) {
+        CHECK(false);
+        return;
+    }
+    const std::string dir = tmpl;
+    log_open_file(dir.c_str());
+
+    const char* str = "text";
+    const uint64_t big = 18446744073709551615ull;
+    LOGI("ints %d %u %lld %llu %x", -5, 7u, (long long)-9000000000ll, (unsigned long long)big, 255);
+    LOGI("floats %.2f %5.1f|%-6.3g|", 3.14159, 2.0f, 0.5);
+    LOGI("strings [%s] [%8s] [%-6s] [%.2s] %%", str, str, str, str);
+    LOGI("stars [%*d] [%.*f]", 5, 42, 1, 2.25);
+    LOGE("error %s", "here");
+    log_flush();
+
+    FILE* f = fopen((dir + "/rce.log").c_str(), "rb");
+    CHECK(f != nullptr);
+    std::string text;
+    if (f) {
+        char buf[1024];
+        size_t n;
+        while ((n = fread(buf, 1, sizeof(buf), f)) > 0) text.append(buf, n);
+        fclose(f);
+    }
+    CHECK(text.find("ints -5 7 -9000000000 18446744073709551615 ff") != std::string::npos);
+    CHECK(text.find("floats 3.14   2.0|0.5   |") != std::string::npos);
+    CHECK(text.find("strings [text] [    text] [text  ] [te] %") != std::string::npos);
+    CHECK(text.find("stars [   42] [2.2]") != std::string::npos);
+    CHECK(text.find(" E error here") != std::string::npos);
+
+    const std::string cmd = "rm -rf '" + dir + "'";
+    if (system(cmd.c_str()) != 0) fprintf(stderr, "could not remove %s\n", dir.c_str());
+}
+
+int main() {
+    test_exit_without_shutdown();
+    test_format_to_file();
+    log_shutdown();
+    return rce_test::finish("log_test");
+}
@@ -0,0 +1,118 @@
+#include "app/paths.h"
+#include "luax/lua_bytecode_cache.h"
+#include "test_util.h"
+
+#include <stdlib.h>
+#include <string>
+#include <sys/stat.h>
+#include <utime.h>
+
+extern "C" {
+#include "lua.h"
+#include "lauxlib.h"
+#include "lualib.h"
+}
+
+static std::string g_dir;
+
+static std::string write_file(const char* name, const std::string& text) {
+    const std::string path = app::paths::join(g_dir, name);
+    FILE* f = fopen(path.c_str(), "wb");
+    if (f) {
+        fwrite(text.data(), 1, text.size(), f);
+        fclose(f);
+    }
+    return path;
+}
+
+// Loads and runs path; returns the chunk's number result (or -1 on error).
+static double run_cached(lua_State* L, const std::string& path) {
+    if (luax_loadfile_cached(L, path.c_str()) != 0 || lua_pcall(L, 0, 1, 0) != 0) {
+        fprintf(stderr, "  %s\n", lua_tostring(L, -1));
+        lua_pop(L, 1);
+        return -1;
+    }
+    const double v = lua_tonumber(L, -1);
+    lua_pop(L, 1);
+    return v;
+}
+
+static void test_hit_and_invalidate(lua_State* L) {
+    const std::string a = write_file("a.lua", "return 1 + 1\n");
+    LuaBytecodeCacheStats s0 = luax_bytecode_cache_stats();
+
+    CHECK_EQ(run_cached(L, a), 2);
+    CHECK_EQ(run_cached(L, a), 2);
+    LuaBytecodeCacheStats s1 = luax_bytecode_cache_stats();
+    CHECK_EQ(s1.misses - s0.misses, 1);
+    CHECK_EQ(s1.hits - s0.hits, 1);
+    CHECK_EQ(s1.writes - s0.writes, 1);
+
+    // Same size and mtime, different bytes: only the content hash can tell.
+    struct stat st;
+    CHECK(stat(a.c_str(), &st) == 0);
+    write_file("a.lua", "return 1 + 7\n");
+    struct utimbuf times;
+    times.actime = st.st_atime;
+    times.modtime = st.st_mtime;
+    utime(a.c_str(), &times);
+
+    CHECK_EQ(run_cached(L, a), 8);
+    CHECK_EQ(run_cached(L, a), 8);
+    LuaBytecodeCacheStats s2 = luax_bytecode_cache_stats();
+    CHECK_EQ(s2.misses - s1.misses, 1);
+    CHECK_EQ(s2.hits - s1.hits, 1);
+
+    // A corrupt entry is a miss, and gets rewritten.
+    write_file("a.lua", "return 40 + 2\n");
+    CHECK_EQ(run_cached(L, a), 42);
+    const std::string cache = app::paths::join(app::paths::get().cache, "luac");
+    const std::string cmd = "for f in '" + cache + "'/*.luac; do printf garbage > \"$f\"; done";
+    CHECK(system(cmd.c_str()) == 0);
+    CHECK_EQ(run_cached(L, a), 42);
+    CHECK_EQ(run_cached(L, a), 42);
+    LuaBytecodeCacheStats s3 = luax_bytecode_cache_stats();
+    CHECK_EQ(s3.misses - s2.misses, 2);
+    CHECK_EQ(s3.hits - s2.hits, 1);
+    CHECK_EQ(s3.write_errors, 0);
+}
+
+static void test_require(lua_State* L) {
+    write_file("mod_ok.lua", "return { v = 5 }\n");
+    write_file("mod_bad.lua", "return {{ \n");
+
+    luax_install_cached_loader(L);
+    const std::string setup = "package.path = '" + g_dir + "/?.lua'";
+    CHECK(luaL_dostring(L, setup.c_str()) == 0);
+
+    CHECK(luaL_dostring(L, "assert(require('mod_ok').v == 5)") == 0);
+    CHECK(luaL_dostring(L,
+        "local ok, err = pcall(require, 'mod_bad')\n"
+        "assert(not ok and err:find('error loading module', 1, true), err)\n"
+        "ok, err = pcall(require, 'mod_missing')\n"
+        "assert(not ok and err:find('no file', 1, true), err)\n") == 0);
+}
+
+int main() {
+    char tmpl[] = "/tmp/rce_luac_test_XXXXXX";
+    if (!mkdtemp(tmpl)) {
+        perror("mkdtemp");
+        return 1;
+    }
+    g_dir = tmpl;
+
+    app::paths::AppPaths p;
+    p.data = g_dir;
+    p.cache = app::paths::join(g_dir, "cache");
+    app::paths::set(p);
+
+    lua_State* L = luaL_newstate();
+    luaL_openlibs(L);
+    test_hit_and_invalidate(L);
+    test_require(L);
+    lua_close(L);
+
+    const std::string cmd = "rm -rf '" + g_dir + "'";
+    if (system(cmd.c_str()) != 0) fprintf(stderr, "could not remove %s\n", g_dir.c_str());
+    return rce_test::finish("lua_bytecode_cache_test");
+}
@@ -0,0 +1,181 @@
+#include "luax/lua_scheduler.h"
+#include "app/event_dispatcher.h"
+#include "app/log.h"
+#include "app/timer.h"
+#include "test_util.h"
+
+extern "C" {
+#include "lua.h"
+#include "lualib.h"
+#include "lauxlib.h"
+}
+
+using namespace rce;
+
+// Headless: a bare lua_State with the scheduler attached, driven the way the
+// engine drives it -- timers_update() once per fixed step, ep_dispatch() per message.
+
+static const uint64_t STEP_NS = 16666667; // one 60 Hz step
+
+struct Vm {
+    lua_State* L = nullptr;
+    LuaScheduler sched;
+
+    Vm() {
+        timers_init();
+        L = luaL_newstate();
+        luaL_openlibs(L);
+        sched.attach(L);
+    }
+    ~Vm() {
+        sched.detach();
+        lua_close(L);
+    }
+
+    bool run(const char* src) {
+        if (luaL_dostring(L, src) == 0) return true;
+        fprintf(stderr, "lua: %s\n", lua_tostring(L, -1));
+        lua_pop(L, 1);
+        return false;
+    }
+
+    lua_Number num(const char* name) {
+        lua_getglobal(L, name);
+        const lua_Number v = lua_tonumber(L, -1);
+        lua_pop(L, 1);
+        return v;
+    }
+
+    bool is_nil(const char* name) {
+        lua_getglobal(L, name);
+        const bool nil = lua_isnil(L, -1);
+        lua_pop(L, 1);
+        return nil;
+    }
+};
+
+static void steps(int n) {
+    for (int i = 0; i < n; i++) timers_update(STEP_NS);
+}
+
+static void dispatch(EPType type, uint32_t a, uint32_t b = 0, uint32_t c = 0, uint32_t d = 0) {
+    EPMsg m{};
+    m.type = type;
+    m.a = a; m.b = b; m.c = c; m.d = d;
+    ep_dispatch(m);
+}
+
+static void test_wait_across_steps() {
+    Vm vm;
+    CHECK(vm.run("n = 0; spawn(function() for i = 1, 3 do wait(0.04); n = n + 1 end end)"));
+    CHECK_EQ(vm.sched.task_count(), 1);
+
+    // 40 ms is due on the third step (50 ms); the next wait counts from there.
+    steps(2);
+    CHECK_EQ(vm.num("n"), 0);
+    steps(1);
+    CHECK_EQ(vm.num("n"), 1);
+    steps(2);
+    CHECK_EQ(vm.num("n"), 1);
+    steps(1);
+    CHECK_EQ(vm.num("n"), 2);
+    steps(3);
+    CHECK_EQ(vm.num("n"), 3);
+    CHECK_EQ(vm.sched.task_count(), 0);
+}
+
+static void test_wait_event() {
+    Vm vm;
+    CHECK(vm.run("spawn(function() local t, a, b, c, d = wait_event(1); got_t = t; got = a + b * 10 + c * 100 + d * 1000 end)"));
+    CHECK_EQ(vm.sched.task_count(), 1);
+
+    // Other types don't wake it.
+    dispatch(EPType::SurfaceResized, 9);
+    CHECK(vm.is_nil("got"));
+
+    dispatch(EPType::InsetsChanged, 1, 2, 3, 4);
+    CHECK_EQ(vm.num("got_t"), (lua_Number)EPType::InsetsChanged);
+    CHECK_EQ(vm.num("got"), 4321);
+    CHECK_EQ(vm.sched.task_count(), 0);
+}
+
+static void test_rewait_in_wakeup() {
+    Vm vm;
+    CHECK(vm.run(
+        "hits = 0; seen = 0\n"
+        "spawn(function() while true do local _, a = wait_event(2); hits = hits + a end end)\n"
+        "spawn(function() while true do wait_event(2); seen = seen + 1 end end)"));
+    CHECK_EQ(vm.sched.task_count(), 2);
+
+    // Each message wakes every waiter once; waiting again inside the wakeup
+    // parks for the next message, not this one.
+    dispatch(EPType::SurfaceResized, 5);
+    CHECK_EQ(vm.num("hits"), 5);
+    CHECK_EQ(vm.num("seen"), 1);
+    for (uint32_t i = 0; i < 100; i++) dispatch(EPType::SurfaceResized, 1);
+    CHECK_EQ(vm.num("hits"), 105);
+    CHECK_EQ(vm.num("seen"), 101);
+    CHECK_EQ(vm.sched.task_count(), 2);
+}
+
+static void test_bare_yield() {
+    Vm vm;
+    CHECK(vm.run("y = 0; spawn(function() coroutine.yield(); y = 1; coroutine.yield(); y = 2 end)"));
+    CHECK_EQ(vm.num("y"), 0);
+    steps(1);
+    CHECK_EQ(vm.num("y"), 1);
+    steps(1);
+    CHECK_EQ(vm.num("y"), 2);
+    CHECK_EQ(vm.sched.task_count(), 0);
+}
+
+static void test_errors_are_dropped() {
+    Vm vm;
+    // Neither error reaches the spawning chunk; each ends only its own thread.
+    CHECK(vm.run(
+        "spawn(function() error('boom') end)\n"
+        "spawn(function() wait(0); error('later') end)\n"
+        "spawn(function() wait(0); ok = true end)\n"
+        "after = 1"));
+    CHECK_EQ(vm.num("after"), 1);
+    CHECK_EQ(vm.sched.error_count(), 1);
+    CHECK_EQ(vm.sched.task_count(), 2);
+
+    steps(1);
+    CHECK_EQ(vm.sched.error_count(), 2);
+    CHECK(!vm.is_nil("ok"));
+    CHECK_EQ(vm.sched.task_count(), 0);
+}
+
+static void test_detach_cancels() {
+    Vm* vm = new Vm;
+    CHECK(vm->run(
+        "spawn(function() wait(0.01); fired = true end)\n"
+        "spawn(function() wait(1); fired = true end)\n"
+        "spawn(function() wait_event(1); woke = true end)"));
+    CHECK_EQ(vm->sched.task_count(), 3);
+
+    vm->sched.detach();
+    CHECK_EQ(vm->sched.task_count(), 0);
+    steps(5);
+    dispatch(EPType::InsetsChanged, 1);
+    CHECK(vm->is_nil("fired"));
+    CHECK(vm->is_nil("woke"));
+
+    // The timers and listeners are gone, not just ignored: nothing may call
+    // back into the scheduler once it is destroyed (ASan builds catch it).
+    delete vm;
+    steps(70);
+    dispatch(EPType::InsetsChanged, 1);
+}
+
+int main() {
+    test_wait_across_steps();
+    test_wait_event();
+    test_rewait_in_wakeup();
+    test_bare_yield();
+    test_errors_are_dropped();
+    test_detach_cancels();
+    log_shutdown();
+    return rce_test::finish("lua_scheduler_test");
+}
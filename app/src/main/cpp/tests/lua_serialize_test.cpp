@@ -0,0 +1,192 @@
+#include "luax/lua_serialize.h"
+#include "test_util.h"
+
+#include <math.h>
+#include <string.h>
+#include <string>
+
+extern "C" {
+#include "lua.h"
+#include "lauxlib.h"
+#include "lualib.h"
+}
+
+// Most cases are Lua chunks against rce.serialize / rce.deserialize; a failed
+// assert() reports the chunk name and message.
+
+static const char* kHelpers = R"LUA(
+function deep_eq(a, b, seen)
+    if a ~= a and b ~= b then return true end -- NaN
+    if type(a) ~= type(b) then return false end
+    if type(a) ~= "table" then
+        if a == 0 and b == 0 then return 1 / a == 1 / b end -- keep -0.0
+        return a == b
+    end
+    seen = seen or {}
+    if seen[a] then return seen[a] == b end
+    seen[a] = b
+    for k, v in pairs(a) do if not deep_eq(v, rawget(b, k), seen) then return false end end
+    for k in pairs(b) do if rawget(a, k) == nil then return false end end
+    return true
+end
+function roundtrip(v)
+    local r, err = rce.deserialize(rce.serialize(v))
+    assert(err == nil, err)
+    return r
+end
+)LUA";
+
+struct Case {
+    const char* name;
+    const char* code;
+};
+
+static const Case kCases[] = {
+    {"scalars", R"LUA(
+        local big = 2^53
+        for _, v in ipairs({ 0, 1, -1, 127, 128, -129, 2^31, -2^31, 2^40 + 7, big - 1, -(big - 1),
+                             big, -big, 0.5, -1.25, 1e300, -1e-300, 3.141592653589793 }) do
+            local r = roundtrip(v)
+            assert(r == v, "number " .. tostring(v))
+        end
+        assert(roundtrip(true) == true and roundtrip(false) == false)
+        assert(roundtrip("a\0b\255") == "a\0b\255")
+        assert(roundtrip("") == "")
+    )LUA"},
+
+    // Not integers: must take the double path without converting to int64 first.
+    {"non-finite and huge numbers", R"LUA(
+        local nan = 0 / 0
+        local r = roundtrip(nan)
+        assert(r ~= r, "nan")
+        assert(roundtrip(1 / 0) == 1 / 0, "inf")
+        assert(roundtrip(-1 / 0) == -1 / 0, "-inf")
+        assert(roundtrip(2^63) == 2^63, "2^63")
+        assert(roundtrip(-2^63) == -2^63, "-2^63")
+        assert(roundtrip(2^64 * 3) == 2^64 * 3, "3*2^64")
+        assert(roundtrip(1e308) == 1e308, "1e308")
+        -- runtime negation: the parser folds a -0.0 literal into the 0 constant
+        local z = roundtrip(-tonumber("0"))
+        assert(z == 0 and 1 / z == -1 / 0, "-0.0")
+        local t = roundtrip({ nan, 1 / 0, big = 2^70 })
+        assert(t[1] ~= t[1] and t[2] == 1 / 0 and t.big == 2^70, "in table")
+    )LUA"},
+
+    {"nested tables", R"LUA(
+        local v = { 1, 2, 3, name = "x", sub = { a = { b = { c = true } } }, [10] = "ten", [-3] = -3.5,
+                    [true] = "yes", list = { "a", "b", { 1, { 2 } } } }
+        assert(deep_eq(v, roundtrip(v)))
+        -- functions/userdata are skipped, not errors
+        local r = roundtrip({ f = print, x = 1 })
+        assert(r.f == nil and r.x == 1)
+    )LUA"},
+
+    {"cycles and shared tables", R"LUA(
+        local shared = { 42 }
+        local t = { a = shared, b = shared }
+        t.self = t
+        t.a.back = t
+        local r = roundtrip(t)
+        assert(r.self == r, "self cycle")
+        assert(r.a == r.b, "shared table written once")
+        assert(r.a.back == r and r.a[1] == 42)
+    )LUA"},
+
+    {"deterministic key order", R"LUA(
+        local a, b = {}, {}
+        for i = 1, 50 do a["k" .. i] = i; a[i * 1.5] = i end
+        for i = 50, 1, -1 do b[i * 1.5] = i; b["k" .. i] = i end
+        a[true] = 1; b[true] = 1
+        assert(rce.serialize(a) == rce.serialize(b), "binary")
+        local ta = rce.serialize(a, { format = "text" })
+        assert(ta == rce.serialize(b, { format = "text" }), "text")
+        -- numbers ascending before strings
+        assert(ta:find("%[1.5%]") < ta:find("k1 ="), "order")
+    )LUA"},
+
+    {"text format", R"LUA(
+        local t = { x = 1, name = "a\"b", sub = {} }
+        t.sub.up = t
+        local s = rce.serialize(t, { format = "text" })
+        assert(s:find("<circular reference>"), "cycle marker")
+        assert(s:find('name = "a\\"b",', 1, true), "escaped string")
+        assert(s:find("\tx = 1,", 1, true), "number")
+        local h = rce.serialize({ f = print }, { format = "text", hide_non_text = true })
+        assert(not h:find("function"), "hide_non_text")
+        assert(rce.serialize({ f = print }, { format = "text" }):find("<function>"), "non-text shown")
+    )LUA"},
+
+    {"bad input", R"LUA(
+        local v, err = rce.deserialize("nope")
+        assert(v == nil and type(err) == "string")
+        local deep = {}
+        local cur = deep
+        for i = 1, 300 do cur.next = {}; cur = cur.next end
+        assert(not pcall(rce.serialize, deep), "depth limit")
+    )LUA"},
+};
+
+// Every prefix of a valid buffer must fail cleanly (no crash, nothing pushed).
+static void test_truncated(lua_State* L) {
+    lua_newtable(L);
+    for (int i = 1; i <= 20; i++) {
+        lua_pushnumber(L, i * 1.5);
+        lua_pushfstring(L, "value %d", i);
+        lua_settable(L, -3);
+    }
+    lua_pushvalue(L, -1);
+    lua_setfield(L, -2, "self");
+
+    std::string buf;
+    CHECK(luax_serialize(L, -1, LuaSerializeOptions{}, buf));
+    lua_pop(L, 1);
+
+    const int top = lua_gettop(L);
+    for (size_t n = 0; n < buf.size(); n++) {
+        std::string err;
+        const bool ok = luax_deserialize(L, buf.data(), n, &err);
+        CHECK(!ok);
+        CHECK(!err.empty());
+        CHECK_EQ(lua_gettop(L), top);
+    }
+    CHECK(luax_deserialize(L, buf.data(), buf.size()));
+    lua_pop(L, 1);
+
+    // A NaN key can't be encoded, but can be crafted: patch the 1.5 key's bytes.
+    const double key = 1.5, nan = NAN;
+    const size_t at = buf.find(std::string((const char*)&key, sizeof(key)));
+    CHECK(at != std::string::npos);
+    if (at != std::string::npos) {
+        memcpy(&buf[at], &nan, sizeof(nan));
+        std::string err;
+        CHECK(!luax_deserialize(L, buf.data(), buf.size(), &err));
+        CHECK(err.find("NaN table key") != std::string::npos);
+        CHECK_EQ(lua_gettop(L), top);
+    }
+}
+
+int main() {
+    lua_State* L = luaL_newstate();
+    luaL_openlibs(L);
+    lua_newtable(L);
+    luax_open_serialize(L);
+    lua_setglobal(L, "rce");
+
+    if (luaL_dostring(L, kHelpers) != 0) {
+        fprintf(stderr, "helpers: %s\n", lua_tostring(L, -1));
+        return 1;
+    }
+
+    for (const Case& c : kCases) {
+        if (luaL_dostring(L, c.code) != 0) {
+            ::rce_test::fail(__FILE__, __LINE__, c.name);
+            fprintf(stderr, "  %s\n", lua_tostring(L, -1));
+            lua_pop(L, 1);
+        }
+    }
+
+    test_truncated(L);
+
+    lua_close(L);
+    return rce_test::finish("lua_serialize_test");
+}
@@ -0,0 +1,191 @@
+#include "gfx/render_commands.h"
+#include "gfx/sprite_batch.h"
+#include "test_util.h"
+
+#include <algorithm>
+#include <vector>
+
+// Headless: commands are recorded, sorted and replayed into RecordingBackend.
+
+using namespace render_key;
+
+static bool same_rect(const RectI& a, const RectI& b) {
+    return a.x == b.x && a.y == b.y && a.w == b.w && a.h == b.h;
+}
+
+static void test_keys() {
+    const uint64_t k = draw(LAYER_UI, 3, 12345, 678);
+    CHECK_EQ(layer_of(k), LAYER_UI);
+    CHECK_EQ(pass_of(k), 3);
+    CHECK(is_draw(k));
+    CHECK_EQ(material_of(k), 12345);
+    CHECK_EQ(depth_of(k), 678);
+    CHECK(!is_draw(state(LAYER_UI, 3)));
+
+    // Out-of-range fields are masked, never bleed into their neighbours.
+    const uint64_t m = draw(LAYER_WORLD, 1, MATERIAL_MAX + 5, DEPTH_MAX + 9);
+    CHECK_EQ(material_of(m), 4);
+    CHECK_EQ(depth_of(m), 8);
+    CHECK_EQ(pass_of(m), 1);
+
+    // Field precedence: layer, pass, state before draw, material, depth.
+    CHECK(draw(LAYER_PRESENT, 255, MATERIAL_MAX, DEPTH_MAX) < state(LAYER_WORLD, 0));
+    CHECK(draw(LAYER_WORLD, 0, MATERIAL_MAX, DEPTH_MAX) < state(LAYER_WORLD, 1));
+    CHECK(state(LAYER_WORLD, 1) < draw(LAYER_WORLD, 1, 0, 0));
+    CHECK(draw(LAYER_WORLD, 1, 1, DEPTH_MAX) < draw(LAYER_WORLD, 1, 2, 0));
+}
+
+static void test_payloads() {
+    RenderCommandBuffer buf;
+    RecordingBackend rec;
+    // Recorded back to front on purpose.
+    buf.draw(draw(LAYER_WORLD, 0, 7, 1), CmdDraw{7, 2, 10, 20});
+    buf.scissor_off(state(LAYER_WORLD, 0));
+    buf.scissor(state(LAYER_PRESENT, 0), RectI{1, 2, 3, 4});
+    buf.viewport(state(LAYER_PRESENT, 0), RectI{0, 0, 640, 480});
+    buf.clear(state(LAYER_PRESENT, 0), 0.25f, 0.5f, 0.75f);
+    buf.submit(rec);
+
+    CHECK_EQ(rec.frames, 1);
+    CHECK_EQ(rec.ops.size(), 5);
+    if (rec.ops.size() == 5) {
+        // Equal keys keep recording order.
+        CHECK(rec.ops[0].type == RenderCmdType::Scissor && rec.ops[0].enabled && same_rect(rec.ops[0].rect, RectI{1, 2, 3, 4}));
+        CHECK(rec.ops[1].type == RenderCmdType::Viewport && same_rect(rec.ops[1].rect, RectI{0, 0, 640, 480}));
+        CHECK(rec.ops[2].type == RenderCmdType::Clear);
+        CHECK(rec.ops[2].clear.r == 0.25f && rec.ops[2].clear.b == 0.75f && rec.ops[2].clear.a == 1.0f);
+        CHECK(rec.ops[3].type == RenderCmdType::Scissor && !rec.ops[3].enabled);
+        CHECK(rec.ops[4].type == RenderCmdType::Draw);
+        CHECK(rec.ops[4].draw.material == 7 && rec.ops[4].draw.mesh == 2 && rec.ops[4].draw.count == 20);
+    }
+    CHECK_EQ(buf.stats().commands, 5);
+    CHECK_EQ(buf.stats().draws, 1);
+
+    // The buffer stays intact until reset(): a second submit replays the same.
+    buf.submit(rec);
+    CHECK_EQ(rec.frames, 2);
+    CHECK_EQ(rec.ops.size(), 5);
+    buf.reset();
+    buf.submit(rec);
+    CHECK(rec.ops.empty());
+}
+
+// Random keys against std::stable_sort; CmdDraw::first carries the recording index.
+static void test_sort_matches_stable_sort() {
+    uint32_t rng = 7;
+    auto next = [&rng] { rng = rng * 1664525u + 1013904223u; return rng >> 8; };
+
+    RenderCommandBuffer buf;
+    RecordingBackend rec;
+    const uint32_t sizes[] = {2, 17, 300, 5000};
+    for (uint32_t n : sizes) {
+        for (int variety = 0; variety < 3; variety++) {
+            buf.reset();
+            std::vector<std::pair<uint64_t, uint32_t>> ref;
+            for (uint32_t i = 0; i < n; i++) {
+                uint64_t key;
+                if (variety == 0) key = draw((uint8_t)(next() % 3 * 16), (uint8_t)(next() % 2), next() % 4, next() % 8);
+                else if (variety == 1) key = draw(LAYER_WORLD, 0, 0, next() % 5000);  // depth only
+                else key = (uint64_t)next() << 40 ^ (uint64_t)next() << 16 ^ next();
+                buf.draw(key, CmdDraw{0, 0, i, 0});
+                ref.emplace_back(key, i);
+            }
+            std::stable_sort(ref.begin(), ref.end(),
+                             [](const std::pair<uint64_t, uint32_t>& a, const std::pair<uint64_t, uint32_t>& b) {
+                                 return a.first < b.first;
+                             });
+            buf.submit(rec);
+            CHECK_EQ(rec.ops.size(), n);
+            bool same = rec.ops.size() == n;
+            for (uint32_t i = 0; same && i < n; i++) {
+                same = rec.ops[i].draw.first == ref[i].second && buf.entries()[i].key == ref[i].first;
+            }
+            CHECK(same);
+            if (variety == 1) CHECK(buf.stats().sort_passes <= 2);  // depth < 2^16
+        }
+    }
+}
+
+static void test_sort_skips_work() {
+    RenderCommandBuffer buf;
+    for (uint32_t i = 0; i < 100; i++) buf.draw(draw(LAYER_WORLD, 0, 1, i), CmdDraw{});
+    buf.sort();
+    CHECK_EQ(buf.stats().sort_passes, 0);  // recorded in order: no sort at all
+
+    buf.reset();
+    for (uint32_t i = 0; i < 100; i++) buf.draw(draw(LAYER_WORLD, 0, 1, 99 - i), CmdDraw{});
+    buf.sort();
+    CHECK_EQ(buf.stats().sort_passes, 1);  // only the low byte varies
+    CHECK_EQ(depth_of(buf.entries()[0].key), 0);
+    CHECK_EQ(depth_of(buf.entries()[99].key), 99);
+}
+
+static void test_sprites_and_arena() {
+    std::vector<Sprite> in(10000);
+    for (uint32_t i = 0; i < in.size(); i++) {
+        in[i] = Sprite{};
+        in[i].x = (float)i;
+        in[i].texture = 3;
+    }
+
+    RenderCommandBuffer buf;
+    RecordingBackend rec;
+    buf.sprites(draw(LAYER_UI, 0, 3, 0), in.data(), (uint32_t)in.size());
+    buf.draw(draw(LAYER_WORLD, 0, 1, 0), CmdDraw{});  // sorts in front of the sprites
+    buf.submit(rec);
+
+    // Split into arena-chunk sized commands, adjacent and in order.
+    CHECK(rec.ops.size() > 2);
+    CHECK(rec.ops[0].type == RenderCmdType::Draw);
+    uint32_t seen = 0;
+    bool in_order = true;
+    for (size_t i = 1; i < rec.ops.size(); i++) {
+        CHECK(rec.ops[i].type == RenderCmdType::Sprites);
+        for (uint32_t k = 0; k < rec.ops[i].sprites.count; k++) {
+            in_order = in_order && rec.ops[i].sprites.sprites[k].x == (float)seen;
+            seen++;
+        }
+    }
+    CHECK(in_order);
+    CHECK_EQ(seen, in.size());
+    CHECK_EQ(buf.stats().sprites, in.size());
+
+    // Re-recording the same frame after reset() lands in the same arena space.
+    const size_t bytes = buf.stats().arena_bytes;
+    const Sprite* first = rec.ops[1].sprites.sprites;
+    for (int frame = 0; frame < 3; frame++) {
+        buf.reset();
+        CHECK_EQ(buf.stats().arena_bytes, 0);
+        buf.sprites(draw(LAYER_UI, 0, 3, 0), in.data(), (uint32_t)in.size());
+        buf.draw(draw(LAYER_WORLD, 0, 1, 0), CmdDraw{});
+        buf.submit(rec);
+        CHECK_EQ(buf.stats().arena_bytes, bytes);
+        CHECK(rec.ops.size() > 1 && rec.ops[1].sprites.sprites == first);
+    }
+}
+
+static void test_frame_arena() {
+    FrameArena a(256);
+    void* p1 = a.alloc(3, 1);
+    void* p2 = a.alloc(8, 8);
+    CHECK(p1 && p2);
+    CHECK_EQ((uintptr_t)p2 % 8, 0);
+    CHECK(a.alloc(257, 1) == nullptr);  // larger than a chunk
+    for (int i = 0; i < 10; i++) CHECK(a.alloc(200, 8) != nullptr);
+    const size_t cap = a.capacity_bytes();
+    CHECK_EQ(cap, 10 * 256);  // the first 200 bytes still fit behind the small ones
+    a.reset();
+    CHECK_EQ(a.used_bytes(), 0);
+    for (int i = 0; i < 10; i++) a.alloc(200, 8);
+    CHECK_EQ(a.capacity_bytes(), cap);
+}
+
+int main() {
+    test_keys();
+    test_payloads();
+    test_sort_matches_stable_sort();
+    test_sort_skips_work();
+    test_sprites_and_arena();
+    test_frame_arena();
+    return rce_test::finish("render_commands_test");
+}
@@ -0,0 +1,172 @@
+#include "gfx/render_scale.h"
+#include "test_util.h"
+
+#include <math.h>
+
+static bool rect_eq(const RectI& r, int x, int y, int w, int h) {
+    if (r.x == x && r.y == y && r.w == w && r.h == h) return true;
+    fprintf(stderr, "  rect {%d, %d, %d, %d}, want {%d, %d, %d, %d}\n", r.x, r.y, r.w, r.h, x, y, w, h);
+    return false;
+}
+
+static void test_integer_factor() {
+    CHECK_EQ(scale_integer_factor(320, 180, 1920, 1080), 6);
+    CHECK_EQ(scale_integer_factor(320, 180, 2400, 1080), 6);  // limited by height
+    CHECK_EQ(scale_integer_factor(320, 180, 1919, 1080), 5);
+    CHECK_EQ(scale_integer_factor(320, 180, 320, 180), 1);
+    CHECK_EQ(scale_integer_factor(320, 180, 319, 1080), 0);   // doesn't fit at 1x
+    CHECK_EQ(scale_integer_factor(0, 180, 1920, 1080), 0);
+    CHECK_EQ(scale_integer_factor(320, 180, 1920, -1), 0);
+}
+
+static void test_place() {
+    float s = -1;
+    // Integer: 6x, centered horizontally in a wide output with an offset.
+    CHECK(rect_eq(scale_place(320, 180, RectI{10, 20, 2400, 1080}, ScalePolicy::Integer, &s), 250, 20, 1920, 1080));
+    CHECK_NEAR(s, 6, 0.0);
+    // Integer leaves a border rather than filter: 5x in 1919 wide.
+    CHECK(rect_eq(scale_place(320, 180, RectI{0, 0, 1919, 1080}, ScalePolicy::Integer, &s), 159, 90, 1600, 900));
+    CHECK_NEAR(s, 5, 0.0);
+    // Integer falls back to fractional when 1x doesn't fit.
+    CHECK(rect_eq(scale_place(1920, 1080, RectI{0, 0, 1280, 720}, ScalePolicy::Integer, &s), 0, 0, 1280, 720));
+    CHECK_NEAR(s, 2.0 / 3.0, 1e-6);
+
+    // Fractional fills the limiting axis.
+    CHECK(rect_eq(scale_place(320, 180, RectI{0, 0, 1919, 1080}, ScalePolicy::Fractional, &s), 0, 0, 1919, 1079));
+    CHECK_NEAR(s, 1079.0 / 180.0, 1e-5);  // the smaller axis ratio (height rounded down)
+    CHECK(rect_eq(scale_place(320, 200, RectI{0, 0, 1920, 1080}, ScalePolicy::Fractional, &s), 96, 0, 1728, 1080));
+    CHECK_NEAR(s, 5.4, 1e-5);
+    // The other axis rounds to nearest: 3x2 in 100x100 is 100x67 (66.7).
+    CHECK(rect_eq(scale_place(3, 2, RectI{0, 0, 100, 100}, ScalePolicy::Fractional), 0, 16, 100, 67));
+    // Portrait output.
+    CHECK(rect_eq(scale_place(320, 180, RectI{0, 0, 1080, 2400}, ScalePolicy::Integer, &s), 60, 930, 960, 540));
+    CHECK_NEAR(s, 3, 0.0);
+
+    // Empty in, empty out.
+    CHECK(rect_eq(scale_place(0, 180, RectI{5, 6, 100, 100}, ScalePolicy::Integer, &s), 5, 6, 0, 0));
+    CHECK_NEAR(s, 0, 0.0);
+    CHECK(rect_eq(scale_place(320, 180, RectI{5, 6, 0, 100}, ScalePolicy::Fractional, &s), 5, 6, 0, 0));
+}
+
+// Invariants over a sweep of sizes: inside the output, centered, aspect kept,
+// integer scale maximal.
+static void test_place_sweep() {
+    uint32_t rng = 3;
+    auto next = [&rng](int lo, int hi) {
+        rng = rng * 1664525u + 1013904223u;
+        return lo + (int)((rng >> 8) % (uint32_t)(hi - lo + 1));
+    };
+    int bad = 0;
+    for (int i = 0; i < 20000 && bad < 5; i++) {
+        const int sw = next(1, 2000), sh = next(1, 2000);
+        const RectI out{next(0, 200), next(0, 200), next(1, 3000), next(1, 3000)};
+        const ScalePolicy policy = (i & 1) ? ScalePolicy::Integer : ScalePolicy::Fractional;
+        float s = 0;
+        const RectI r = scale_place(sw, sh, out, policy, &s);
+
+        bool ok = r.w >= 1 && r.h >= 1 && r.x >= out.x && r.y >= out.y &&
+                  r.x + r.w <= out.x + out.w && r.y + r.h <= out.y + out.h;
+        // Centered: margins differ by at most one pixel.
+        const int ml = r.x - out.x, mr = out.x + out.w - (r.x + r.w);
+        const int mt = r.y - out.y, mb = out.y + out.h - (r.y + r.h);
+        ok = ok && (mr - ml == 0 || mr - ml == 1) && (mb - mt == 0 || mb - mt == 1);
+
+        const int k = scale_integer_factor(sw, sh, out.w, out.h);
+        if (policy == ScalePolicy::Integer && k > 0) {
+            ok = ok && r.w == sw * k && r.h == sh * k && s == (float)k;
+            ok = ok && (sw * (k + 1) > out.w || sh * (k + 1) > out.h);
+        } else {
+            // The limiting axis fills the output and the other keeps the aspect
+            // to half a pixel (or is clamped to 1 px).
+            const bool fit_w = r.w == out.w && (r.h == 1 || fabs((double)r.h - (double)sh * r.w / sw) <= 0.5 + 1e-9);
+            const bool fit_h = r.h == out.h && (r.w == 1 || fabs((double)r.w - (double)sw * r.h / sh) <= 0.5 + 1e-9);
+            ok = ok && (fit_w || fit_h);
+        }
+        if (!ok) {
+            bad++;
+            fprintf(stderr, "  src %dx%d in {%d,%d,%d,%d} %s -> {%d,%d,%d,%d} scale %g\n", sw, sh, out.x, out.y,
+                    out.w, out.h, policy == ScalePolicy::Integer ? "int" : "frac", r.x, r.y, r.w, r.h, s);
+        }
+    }
+    CHECK_EQ(bad, 0);
+}
+
+static PresentationResult output(int x, int y, int w, int h) {
+    PresentationResult res{};
+    res.output_rect = RectI{x, y, w, h};
+    return res;
+}
+
+static void test_apply_render_target() {
+    RenderTargetConfig cfg;
+    cfg.width = 320;
+    cfg.height = 180;
+
+    // Fixed target, integer scale: nearest-filtered 6x blit.
+    PresentationResult res = output(10, 20, 2400, 1080);
+    apply_render_target(res, cfg);
+    CHECK_EQ(res.render_w, 320);
+    CHECK_EQ(res.render_h, 180);
+    CHECK(rect_eq(res.present_rect, 250, 20, 1920, 1080));
+    CHECK_NEAR(res.present_scale, 6, 0.0);
+    CHECK(!res.present_linear);
+
+    // Dynamic resolution shrinks the render size; the present rect stays put.
+    apply_render_target(res, cfg, 0.5f);
+    CHECK_EQ(res.render_w, 160);
+    CHECK_EQ(res.render_h, 90);
+    CHECK(rect_eq(res.present_rect, 250, 20, 1920, 1080));
+    CHECK_NEAR(res.present_scale, 12, 0.0);
+    CHECK(!res.present_linear);  // still a whole 12x
+    apply_render_target(res, cfg, 0.7f);
+    CHECK_EQ(res.render_w, 224);
+    CHECK_EQ(res.render_h, 126);
+    CHECK(res.present_linear);
+
+    // Fractional policy: filtered.
+    cfg.policy = ScalePolicy::Fractional;
+    res = output(0, 0, 1919, 1080);
+    apply_render_target(res, cfg);
+    CHECK(rect_eq(res.present_rect, 0, 0, 1919, 1079));
+    CHECK(res.present_linear);
+
+    // No target configured, dynamic resolution alone: output size times scale.
+    cfg = RenderTargetConfig{};
+    res = output(0, 100, 1080, 2200);
+    apply_render_target(res, cfg, 0.5f);
+    CHECK_EQ(res.render_w, 540);
+    CHECK_EQ(res.render_h, 1100);
+    CHECK(rect_eq(res.present_rect, 0, 100, 1080, 2200));
+    CHECK_NEAR(res.present_scale, 2, 0.0);
+    CHECK(!res.present_linear);
+
+    // ...and at scale 1 (or a bad scale) the fields are cleared.
+    const float bad_scales[] = {1.0f, 0.0f, -1.0f, 2.0f, NAN};
+    for (float scale : bad_scales) {
+        res = output(0, 100, 1080, 2200);
+        res.render_w = res.render_h = 77;
+        res.present_linear = true;
+        apply_render_target(res, cfg, scale);
+        CHECK_EQ(res.render_w, 0);
+        CHECK_EQ(res.render_h, 0);
+        CHECK(rect_eq(res.present_rect, 0, 100, 1080, 2200));
+        CHECK_NEAR(res.present_scale, 1, 0.0);
+        CHECK(!res.present_linear);
+    }
+
+    // Tiny scales never produce an empty target.
+    cfg.width = 4;
+    cfg.height = 2;
+    res = output(0, 0, 100, 100);
+    apply_render_target(res, cfg, 0.01f);
+    CHECK_EQ(res.render_w, 1);
+    CHECK_EQ(res.render_h, 1);
+}
+
+int main() {
+    test_integer_factor();
+    test_place();
+    test_place_sweep();
+    test_apply_render_target();
+    return rce_test::finish("render_scale_test");
+}
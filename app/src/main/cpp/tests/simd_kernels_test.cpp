@@ -0,0 +1,233 @@
+#include "gfx/simd_kernels.h"
+#include "gfx/sprite_batch.h"
+#include "test_util.h"
+
+#include <math.h>
+#include <string.h>
+#include <vector>
+
+// Vector paths against the *_scalar references (every count 0..67, so every
+// tail length, at unaligned offsets), plus accuracy checks of the kernels
+// themselves. In an RCE_SIMD=OFF build both sides are the scalar code.
+
+namespace {
+
+uint32_t g_rng = 1;
+float rnd(float lo, float hi) {
+    g_rng = g_rng * 1664525u + 1013904223u;
+    return lo + (hi - lo) * (float)(g_rng >> 8) * (1.0f / 16777216.0f);
+}
+
+std::vector<float> random_floats(size_t n, float lo, float hi) {
+    std::vector<float> v(n);
+    for (float& f : v) f = rnd(lo, hi);
+    return v;
+}
+
+// Distance in units in the last place (same-sign floats).
+uint32_t ulps(float a, float b) {
+    if (a == b) return 0;
+    int32_t ia, ib;
+    memcpy(&ia, &a, 4);
+    memcpy(&ib, &b, 4);
+    if ((ia < 0) != (ib < 0)) return fabsf(a - b) < 1e-30f ? 0 : 0xffffffffu;
+    return (uint32_t)(ia > ib ? ia - ib : ib - ia);
+}
+
+// Largest difference seen, reported once per kernel.
+struct MaxUlps {
+    const char* what;
+    uint32_t worst = 0;
+    void add(float a, float b) {
+        const uint32_t u = ulps(a, b);
+        if (u > worst) worst = u;
+    }
+    void check(uint32_t limit) {
+        if (worst > limit) {
+            fprintf(stderr, "%s: vector vs scalar differ by %u ulps (limit %u)\n", what, worst, limit);
+            ::rce_test::failures()++;
+        }
+    }
+};
+
+// The vector paths use the scalar formulas step for step: bit-identical on
+// x86. ARM compilers may fuse the scalar reference's multiply-adds.
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+const uint32_t kUlpLimit = 8;
+#else
+const uint32_t kUlpLimit = 0;
+#endif
+
+const uint32_t kMaxCount = 67;
+const uint32_t kOffset = 1;  // unaligned inputs/outputs
+
+} // namespace
+
+static void test_quad_corners_vs_scalar() {
+    const size_t n = kMaxCount + kOffset;
+    std::vector<float> f[10];
+    for (auto& v : f) v = random_floats(n, -500.0f, 500.0f);
+    const QuadCornersSoA in{f[0].data() + kOffset, f[1].data() + kOffset, f[2].data() + kOffset,
+                            f[3].data() + kOffset, f[4].data() + kOffset, f[5].data() + kOffset,
+                            f[6].data() + kOffset, f[7].data() + kOffset, f[8].data() + kOffset,
+                            f[9].data() + kOffset};
+    MaxUlps m{"simd_quad_corners"};
+    std::vector<SpriteVertex> a(n * 4), b(n * 4);
+    for (uint32_t count = 0; count <= kMaxCount; count++) {
+        memset(a.data(), 0xab, a.size() * sizeof(SpriteVertex));
+        memset(b.data(), 0xab, b.size() * sizeof(SpriteVertex));
+        simd_quad_corners(in, count, a.data() + kOffset);
+        simd_quad_corners_scalar(in, count, b.data() + kOffset);
+        for (size_t i = 0; i < a.size(); i++) {
+            m.add(a[i].x, b[i].x);
+            m.add(a[i].y, b[i].y);
+            // Only the position fields are written.
+            CHECK(a[i].color == 0xabababab && a[i].u == b[i].u);
+        }
+    }
+    m.check(kUlpLimit);
+
+    // Against a double-precision reference.
+    std::vector<SpriteVertex> out(4);
+    const float x0 = -8, y0 = -4, x1 = 8, y1 = 4, c = 0.6f, s = 0.8f, ns = -0.8f, tx = 100, ty = 50;
+    const QuadCornersSoA one{&x0, &y0, &x1, &y1, &c, &ns, &s, &c, &tx, &ty};
+    simd_quad_corners(one, 1, out.data());
+    const float lx[4] = {x0, x1, x1, x0}, ly[4] = {y0, y0, y1, y1};
+    for (int k = 0; k < 4; k++) {
+        CHECK_NEAR(out[k].x, 0.6 * lx[k] - 0.8 * ly[k] + 100, 1e-4);
+        CHECK_NEAR(out[k].y, 0.8 * lx[k] + 0.6 * ly[k] + 50, 1e-4);
+    }
+}
+
+static void test_sincos() {
+    const size_t n = kMaxCount + kOffset;
+    std::vector<float> angle = random_floats(n, -40.0f, 40.0f);
+    angle[kOffset] = 0.0f;
+    angle[kOffset + 1] = -0.0f;
+    angle[kOffset + 2] = (float)M_PI;
+    angle[kOffset + 3] = -(float)M_PI_2;
+    MaxUlps ms{"simd_sincos (sin)"}, mc{"simd_sincos (cos)"};
+    std::vector<float> s1(n), c1(n), s2(n), c2(n);
+    for (uint32_t count = 0; count <= kMaxCount; count++) {
+        simd_sincos(angle.data() + kOffset, count, s1.data() + kOffset, c1.data() + kOffset);
+        simd_sincos_scalar(angle.data() + kOffset, count, s2.data() + kOffset, c2.data() + kOffset);
+        for (uint32_t i = kOffset; i < kOffset + count; i++) {
+            ms.add(s1[i], s2[i]);
+            mc.add(c1[i], c2[i]);
+        }
+    }
+    ms.check(kUlpLimit);
+    mc.check(kUlpLimit);
+
+    // Accuracy against libm over the documented range.
+    std::vector<float> a = random_floats(100000, -8192.0f, 8192.0f);
+    for (size_t i = 0; i < 1000; i++) a[i] = rnd(-4.0f, 4.0f);
+    std::vector<float> s(a.size()), c(a.size());
+    simd_sincos(a.data(), (uint32_t)a.size(), s.data(), c.data());
+    double worst = 0;
+    for (size_t i = 0; i < a.size(); i++) {
+        worst = fmax(worst, fabs(s[i] - sin((double)a[i])));
+        worst = fmax(worst, fabs(c[i] - cos((double)a[i])));
+    }
+    CHECK_NEAR(worst, 0.0, 3e-7);
+}
+
+static void test_pack_rgba8() {
+    const size_t n = kMaxCount + kOffset;
+    std::vector<float> ch[4];
+    for (auto& v : ch) v = random_floats(n, -0.2f, 1.2f);
+    // Rounding boundaries and specials.
+    const float special[] = {0.0f, 1.0f, 0.5f / 255.0f, 127.5f / 255.0f, -0.0f, NAN, INFINITY, -INFINITY};
+    for (uint32_t i = 0; i < 8; i++) ch[i % 4][kOffset + i] = special[i];
+    ch[1][kOffset + 9] = NAN;
+
+    std::vector<uint32_t> a(n), b(n);
+    for (uint32_t count = 0; count <= kMaxCount; count++) {
+        simd_pack_rgba8(ch[0].data() + kOffset, ch[1].data() + kOffset, ch[2].data() + kOffset,
+                        ch[3].data() + kOffset, count, a.data() + kOffset);
+        simd_pack_rgba8_scalar(ch[0].data() + kOffset, ch[1].data() + kOffset, ch[2].data() + kOffset,
+                               ch[3].data() + kOffset, count, b.data() + kOffset);
+        CHECK(memcmp(a.data() + kOffset, b.data() + kOffset, count * sizeof(uint32_t)) == 0);
+    }
+
+    const float r[] = {0.0f, 1.0f, 0.5f, -3.0f, 7.0f, NAN, 0.2f, 1.0f / 255.0f};
+    const float g[] = {1.0f, 0.0f, 0.25f, 0.0f, 0.0f, 0.0f, 0.4f, 2.0f / 255.0f};
+    const float bl[] = {0.0f, 0.0f, 0.75f, 0.0f, 0.0f, 0.0f, 0.6f, 3.0f / 255.0f};
+    const float al[] = {1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 0.8f, 4.0f / 255.0f};
+    uint32_t out[8];
+    simd_pack_rgba8(r, g, bl, al, 8, out);
+    CHECK_EQ(out[0], 0xff00ff00u);
+    CHECK_EQ(out[1], 0xff0000ffu);
+    CHECK_EQ(out[2], 0xffbf4080u);  // 127.5 -> 128, 63.75 -> 64, 191.25 -> 191
+    CHECK_EQ(out[3], 0xff000000u);  // clamped low
+    CHECK_EQ(out[4], 0xff0000ffu);  // clamped high
+    CHECK_EQ(out[5], 0xff000000u);  // NaN -> 0
+    CHECK_EQ(out[6], 0xcc996633u);
+    CHECK_EQ(out[7], 0x04030201u);
+}
+
+static void test_hsv() {
+    const size_t n = kMaxCount + kOffset;
+    std::vector<float> h = random_floats(n, -2.0f, 3.0f);  // hue wraps
+    std::vector<float> s = random_floats(n, 0.0f, 1.0f);
+    std::vector<float> v = random_floats(n, 0.0f, 1.0f);
+    h[kOffset] = 1.0f;
+    s[kOffset + 1] = 0.0f;
+    v[kOffset + 2] = 0.0f;
+
+    MaxUlps m_rgb{"simd_hsv_to_rgb"}, m_hsv{"simd_rgb_to_hsv"};
+    std::vector<float> r1(n), g1(n), b1(n), r2(n), g2(n), b2(n);
+    std::vector<float> h1(n), s1(n), v1(n), h2(n), s2(n), v2(n);
+    for (uint32_t count = 0; count <= kMaxCount; count++) {
+        const uint32_t o = kOffset;
+        simd_hsv_to_rgb(h.data() + o, s.data() + o, v.data() + o, count, r1.data() + o, g1.data() + o, b1.data() + o);
+        simd_hsv_to_rgb_scalar(h.data() + o, s.data() + o, v.data() + o, count, r2.data() + o, g2.data() + o, b2.data() + o);
+        simd_rgb_to_hsv(r2.data() + o, g2.data() + o, b2.data() + o, count, h1.data() + o, s1.data() + o, v1.data() + o);
+        simd_rgb_to_hsv_scalar(r2.data() + o, g2.data() + o, b2.data() + o, count, h2.data() + o, s2.data() + o, v2.data() + o);
+        for (uint32_t i = o; i < o + count; i++) {
+            m_rgb.add(r1[i], r2[i]);
+            m_rgb.add(g1[i], g2[i]);
+            m_rgb.add(b1[i], b2[i]);
+            m_hsv.add(h1[i], h2[i]);
+            m_hsv.add(s1[i], s2[i]);
+            m_hsv.add(v1[i], v2[i]);
+        }
+    }
+    m_rgb.check(kUlpLimit);
+    m_hsv.check(kUlpLimit);
+
+    // Known colors, and hsv -> rgb -> hsv round trips.
+    const float hh[] = {0.0f, 1.0f / 3.0f, 2.0f / 3.0f, 1.0f / 6.0f, 1.0f, 0.5f};
+    const float ss[] = {1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f};
+    const float vv[] = {1.0f, 1.0f, 1.0f, 1.0f, 0.5f, 0.25f};
+    float r[6], g[6], b[6];
+    simd_hsv_to_rgb(hh, ss, vv, 6, r, g, b);
+    CHECK(r[0] == 1 && g[0] == 0 && b[0] == 0);
+    CHECK(r[1] == 0 && g[1] == 1 && b[1] == 0);
+    CHECK(r[2] == 0 && g[2] == 0 && b[2] == 1);
+    CHECK(r[3] == 1 && g[3] == 1 && b[3] == 0);
+    CHECK(r[4] == 0.5f && g[4] == 0 && b[4] == 0);  // hue 1.0 == 0.0
+    CHECK(r[5] == 0.25f && g[5] == 0.25f && b[5] == 0.25f);
+
+    std::vector<float> th = random_floats(1000, 0.0f, 0.999f), ts = random_floats(1000, 0.05f, 1.0f),
+                       tv = random_floats(1000, 0.05f, 1.0f);
+    std::vector<float> tr(1000), tg(1000), tb(1000), rh(1000), rs(1000), rv(1000);
+    simd_hsv_to_rgb(th.data(), ts.data(), tv.data(), 1000, tr.data(), tg.data(), tb.data());
+    simd_rgb_to_hsv(tr.data(), tg.data(), tb.data(), 1000, rh.data(), rs.data(), rv.data());
+    double worst = 0;
+    for (int i = 0; i < 1000; i++) {
+        worst = fmax(worst, fabs(rv[i] - tv[i]));
+        worst = fmax(worst, fabs(rs[i] - ts[i]));
+        worst = fmax(worst, fabs(rh[i] - th[i]) * ts[i] * tv[i]);  // hue is only as precise as the chroma
+    }
+    CHECK_NEAR(worst, 0.0, 1e-5);
+}
+
+int main() {
+    printf("simd backend: %s\n", simd_backend_name());
+    test_quad_corners_vs_scalar();
+    test_sincos();
+    test_pack_rgba8();
+    test_hsv();
+    return rce_test::finish("simd_kernels_test");
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <stdio.h>
+#include <stdint.h>
+
+// Tiny host test helpers. One executable per module, registered with ctest;
+// the exit code is the number of failed checks. Failures go straight to
+// stderr (not LOGE) so they are never rate limited or lost on an abort.
+
+namespace rce_test {
+
+inline int& failures() {
+    static int n = 0;
+    return n;
+}
+
+inline void fail(const char* file, int line, const char* what) {
+    fprintf(stderr, "%s:%d: check failed: %s\n", file, line, what);
+    failures()++;
+}
+
+inline int finish(const char* name) {
+    if (failures()) fprintf(stderr, "%s: %d check(s) failed\n", name, failures());
+    else printf("%s: ok\n", name);
+    return failures() ? 1 : 0;
+}
+
+} // namespace rce_test
+
+#define CHECK(cond) do { if (!(cond)) ::rce_test::fail(__FILE__, __LINE__, #cond); } while (0)
+
+// Like CHECK, but prints both sides (as long long / double).
+#define CHECK_EQ(a, b) do { \
+    const long long rce_a_ = (long long)(a), rce_b_ = (long long)(b); \
+    if (rce_a_ != rce_b_) { \
+        fprintf(stderr, "%s:%d: %s == %s: %lld vs %lld\n", __FILE__, __LINE__, #a, #b, rce_a_, rce_b_); \
+        ::rce_test::failures()++; \
+    } \
+} while (0)
+
+#define CHECK_NEAR(a, b, eps) do { \
+    const double rce_a_ = (double)(a), rce_b_ = (double)(b); \
+    if (!(rce_a_ - rce_b_ <= (eps) && rce_b_ - rce_a_ <= (eps))) { \
+        fprintf(stderr, "%s:%d: %s ~= %s: %.9g vs %.9g\n", __FILE__, __LINE__, #a, #b, rce_a_, rce_b_); \
+        ::rce_test::failures()++; \
+    } \
+} while (0)
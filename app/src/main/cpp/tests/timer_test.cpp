@@ -0,0 +1,122 @@
+#include "app/timer.h"
+#include "app/time.h"
+#include "test_util.h"
+
+#include <vector>
+
+using namespace rce;
+
+static const uint64_t MS = 1000000ull;
+
+static void test_one_shot() {
+    timers_init();
+    int fired = 0;
+    TimerId id = timers_after(0.05f, [&](TimerId) { fired++; });
+    CHECK(id != 0);
+
+    // 0.05f is a hair over 50 ms.
+    timers_update(40 * MS);
+    CHECK_EQ(fired, 0);
+    timers_update(11 * MS);
+    CHECK_EQ(fired, 1);
+    timers_update(1000 * MS);
+    CHECK_EQ(fired, 1);
+
+    // Fired one-shots are gone; canceling the old id is harmless.
+    timers_cancel(id);
+    timers_cancel(id);
+}
+
+static void test_repeat_cadence() {
+    timers_init();
+    std::vector<uint64_t> at;
+    uint64_t now = 0;
+    timers_every(1.0f, [&](TimerId) { at.push_back(now); });
+
+    // 30 ms frames: each fire overshoots, but the overshoot is carried, so
+    // over 10 s the timer fires exactly 10 times.
+    while (now < 10000 * MS) {
+        now += 30 * MS;
+        timers_update(30 * MS);
+    }
+    CHECK_EQ(at.size(), 10);
+    for (size_t i = 0; i < at.size(); i++) {
+        CHECK(at[i] >= (i + 1) * 1000 * MS);
+        CHECK(at[i] < (i + 1) * 1000 * MS + 30 * MS);
+    }
+
+    // One huge step fires once, then resumes from now instead of bursting.
+    const size_t before = at.size();
+    now += 5000 * MS;
+    timers_update(5000 * MS);
+    CHECK_EQ(at.size(), before + 1);
+    now += 30 * MS;
+    timers_update(30 * MS);
+    CHECK_EQ(at.size(), before + 2);
+}
+
+static void test_cancel_and_reentrancy() {
+    timers_init();
+    int a = 0, b = 0, c = 0;
+    TimerId ta = timers_every(0.01f, [&](TimerId self) {
+        a++;
+        timers_cancel(self); // cancel from inside its own callback
+    });
+    TimerId tb = timers_after(0.01f, [&](TimerId) { b++; });
+    timers_cancel(tb);
+    timers_every(0.01f, [&](TimerId) {
+        // Added during update: waits for the next update.
+        c++;
+        timers_after(0.0f, [&](TimerId) { c += 100; });
+    });
+
+    timers_update(10 * MS);
+    CHECK_EQ(a, 1);
+    CHECK_EQ(b, 0);
+    CHECK_EQ(c, 1);
+    timers_update(10 * MS);
+    CHECK_EQ(a, 1);
+    CHECK_EQ(c, 102);
+    (void)ta;
+}
+
+// Regression: a slot reused thousands of times must not let an old id or a
+// stale heap entry alias the timer that lives there now.
+static void test_slot_reuse_no_alias() {
+    timers_init();
+
+    // Enough live timers that the stale entries below are never swept.
+    for (int i = 0; i < 10000; i++) timers_after(1000.0f, [](TimerId) {});
+
+    int early = 0;
+    TimerId old_id = timers_after(1.0f, [&](TimerId) { early++; });
+    timers_cancel(old_id); // its heap entry (deadline 1 s) stays queued
+
+    // 1 + 4094 releases: exactly one trip around the old 12-bit generation.
+    for (int i = 0; i < 4094; i++) {
+        timers_cancel(timers_after(100.0f, [](TimerId) {}));
+    }
+
+    int fired = 0;
+    TimerId id = timers_after(5.0f, [&](TimerId) { fired++; });
+    CHECK(id != old_id);
+    CHECK((id & 0xFFFFF) == (old_id & 0xFFFFF)); // same slot, LIFO reuse
+
+    timers_cancel(old_id); // must not cancel the new timer
+    timers_update(2000 * MS);
+    CHECK_EQ(fired, 0);    // the stale 1 s entry must not fire it early
+    CHECK_EQ(early, 0);
+    timers_update(3000 * MS);
+    CHECK_EQ(fired, 1);
+    timers_update(3000 * MS);
+    CHECK_EQ(fired, 1);
+}
+
+int main() {
+    test_one_shot();
+    test_repeat_cadence();
+    test_cancel_and_reentrancy();
+    test_slot_reuse_no_alias();
+    timers_init();
+    return rce_test::finish("timer_test");
+}